@@ -63,6 +63,16 @@ target_link_libraries(fboss_types
   switch_config_cpp2
 )
 
+add_library(state_journal
+  fboss/agent/StateJournal.cpp
+)
+
+target_link_libraries(state_journal
+  error
+  state
+  Folly::folly
+)
+
 add_library(core
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
@@ -73,6 +83,7 @@ add_library(core
   fboss/agent/IPHeaderV4.cpp
   fboss/agent/IPv4Handler.cpp
   fboss/agent/IPv6Handler.cpp
+  fboss/agent/IcmpErrorRateLimiter.cpp
   fboss/agent/L2Entry.cpp
   fboss/agent/LacpController.cpp
   fboss/agent/LacpMachines.cpp
@@ -96,10 +107,14 @@ add_library(core
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
   fboss/agent/StandaloneRibConversions.cpp
+  fboss/agent/StateChangePublisher.cpp
+  fboss/agent/StateMemoryAccountant.cpp
+  fboss/agent/StateUpdateRecorder.cpp
   fboss/agent/SwSwitch.cpp
   fboss/agent/ThreadHeartbeat.cpp
   fboss/agent/TunIntf.cpp
   fboss/agent/TunManager.cpp
+  fboss/agent/TxPacketBufferPool.cpp
   fboss/agent/ndp/IPv6RouteAdvertiser.cpp
   fboss/agent/oss/RouteUpdateLogger.cpp
   fboss/agent/oss/SwSwitch.cpp
@@ -123,6 +138,7 @@ target_link_libraries(core
   network_to_route_map
   standalone_rib
   state
+  state_journal
   state_utils
   exponential_back_off
   fboss_config_utils
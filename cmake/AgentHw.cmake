@@ -35,6 +35,7 @@ add_library(buffer_stats
 )
 
 target_link_libraries(hw_switch_warmboot_helper
+  state_journal
   utils
   Folly::folly
 )
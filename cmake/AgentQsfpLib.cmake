@@ -13,6 +13,7 @@ target_link_libraries(qsfp_service_client
 
 add_library(qsfp_cache
     fboss/qsfp_service/lib/QsfpCache.cpp
+    fboss/qsfp_service/lib/TransceiverInfoDelta.cpp
 )
 
 target_link_libraries(qsfp_cache
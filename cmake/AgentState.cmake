@@ -50,6 +50,7 @@ add_library(state
   fboss/agent/state/SflowCollector.cpp
   fboss/agent/state/SflowCollectorMap.cpp
   fboss/agent/state/StateDelta.cpp
+  fboss/agent/state/StateDeltaChangeLog.cpp
   fboss/agent/state/StateUtils.cpp
   fboss/agent/state/SwitchSettings.cpp
   fboss/agent/state/SwitchState.cpp
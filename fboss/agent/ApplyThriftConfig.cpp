@@ -9,8 +9,10 @@
  */
 #include "fboss/agent/ApplyThriftConfig.h"
 
+#include <folly/Conv.h>
 #include <folly/FileUtil.h>
 #include <folly/gen/Base.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
@@ -49,6 +51,7 @@
 #include <folly/Range.h>
 #include <algorithm>
 #include <cmath>
+#include <future>
 #include <utility>
 #include <vector>
 
@@ -75,6 +78,53 @@ const uint8_t kV6LinkLocalAddrMask{64};
 // Needed until CoPP is removed from code and put into config
 const int kAclStartPriority = 100000;
 
+// Config sections which are fingerprinted across applies
+constexpr auto kMirrorsSection = "mirrors";
+constexpr auto kAclsSection = "acls";
+constexpr auto kQosPoliciesSection = "qosPolicies";
+
+/*
+ * Accumulates the serialized thrift structs making up a config section, so
+ * that the whole section can be fingerprinted with a single hash.
+ */
+class ConfigSectionHasher {
+ public:
+  template <typename ThriftT>
+  ConfigSectionHasher& add(const ThriftT& obj) {
+    serialized_ +=
+        apache::thrift::CompactSerializer::serialize<std::string>(obj);
+    return *this;
+  }
+
+  template <typename ThriftT>
+  ConfigSectionHasher& add(const std::vector<ThriftT>& objs) {
+    serialized_ += folly::to<std::string>(objs.size(), ':');
+    for (const auto& obj : objs) {
+      add(obj);
+    }
+    return *this;
+  }
+
+  template <typename OptionalFieldRefT>
+  ConfigSectionHasher& addOptional(OptionalFieldRefT field) {
+    if (field) {
+      serialized_ += '1';
+      add(*field);
+    } else {
+      serialized_ += '0';
+    }
+    return *this;
+  }
+
+  uint64_t hash() const {
+    return folly::hash::SpookyHashV2::Hash64(
+        serialized_.data(), serialized_.size(), 0);
+  }
+
+ private:
+  std::string serialized_;
+};
+
 void updateFibFromConfig(
     facebook::fboss::RouterID vrf,
     const facebook::fboss::rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
@@ -106,8 +156,13 @@ class ThriftConfigApplier {
       const std::shared_ptr<SwitchState>& orig,
       const cfg::SwitchConfig* config,
       const Platform* platform,
-      rib::RoutingInformationBase* rib)
-      : orig_(orig), cfg_(config), platform_(platform), rib_(rib) {}
+      rib::RoutingInformationBase* rib,
+      ThriftConfigFingerprints* fingerprints)
+      : orig_(orig),
+        cfg_(config),
+        platform_(platform),
+        rib_(rib),
+        fingerprints_(fingerprints) {}
 
   std::shared_ptr<SwitchState> run();
 
@@ -265,11 +320,28 @@ class ThriftConfigApplier {
   std::shared_ptr<ForwardingInformationBaseMap>
   updateForwardingInformationBaseContainers();
 
+  /*
+   * A config section can be skipped if its config hashes the same as in the
+   * last apply, orig_ still holds the node the last apply produced for it,
+   * and the nodes it was computed against are the same too. Pass the
+   * fingerprint of the section with its node from orig_.
+   */
+  bool isSectionUnchanged(
+      const std::string& section,
+      const ThriftConfigSectionFingerprint& fingerprint) const;
+  // Record the fingerprint of a section with its node from new_
+  void recordSection(
+      const std::string& section,
+      ThriftConfigSectionFingerprint fingerprint);
+
   std::shared_ptr<SwitchState> orig_;
   std::shared_ptr<SwitchState> new_;
   const cfg::SwitchConfig* cfg_{nullptr};
   const Platform* platform_{nullptr};
   rib::RoutingInformationBase* rib_{nullptr};
+  ThriftConfigFingerprints* fingerprints_{nullptr};
+  // Only committed to fingerprints_ once the whole config applied cleanly
+  ThriftConfigFingerprints newFingerprints_;
 
   struct VlanIpInfo {
     VlanIpInfo(uint8_t mask, MacAddress mac, InterfaceID intf)
@@ -330,28 +402,66 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
 
   // updateMirrors must be called after updatePorts, mirror needs ports!
   {
-    auto newMirrors = updateMirrors();
-    if (newMirrors) {
-      new_->resetMirrors(std::move(newMirrors));
-      changed = true;
+    ThriftConfigSectionFingerprint fingerprint{
+        ConfigSectionHasher().add(cfg_->mirrors).hash(),
+        orig_->getMirrors(),
+        {new_->getPorts()}};
+    if (!isSectionUnchanged(kMirrorsSection, fingerprint)) {
+      auto newMirrors = updateMirrors();
+      if (newMirrors) {
+        new_->resetMirrors(std::move(newMirrors));
+        changed = true;
+      }
     }
+    fingerprint.node = new_->getMirrors();
+    recordSection(kMirrorsSection, std::move(fingerprint));
   }
 
   // updateAcls must be called after updateMirrors, acls may need mirror!
+  // QoS policies only depend on the config and orig_, so they are computed
+  // on another thread while we compute the ACLs.
   {
-    auto newAcls = updateAcls();
-    if (newAcls) {
-      new_->resetAcls(std::move(newAcls));
-      changed = true;
+    ThriftConfigSectionFingerprint qosPoliciesFingerprint{
+        ConfigSectionHasher()
+            .add(cfg_->qosPolicies)
+            .addOptional(cfg_->dataPlaneTrafficPolicy_ref())
+            .hash(),
+        orig_->getQosPolicies(),
+        {}};
+    std::future<std::shared_ptr<QosPolicyMap>> newQosPoliciesFuture;
+    if (!isSectionUnchanged(kQosPoliciesSection, qosPoliciesFingerprint)) {
+      newQosPoliciesFuture = std::async(
+          std::launch::async, [this]() { return updateQosPolicies(); });
+    }
+
+    ThriftConfigSectionFingerprint aclsFingerprint{
+        ConfigSectionHasher()
+            .add(cfg_->acls)
+            .add(cfg_->trafficCounters)
+            .addOptional(cfg_->cpuTrafficPolicy_ref())
+            .addOptional(cfg_->dataPlaneTrafficPolicy_ref())
+            .hash(),
+        orig_->getAcls(),
+        {new_->getMirrors()}};
+    if (!isSectionUnchanged(kAclsSection, aclsFingerprint)) {
+      auto newAcls = updateAcls();
+      if (newAcls) {
+        new_->resetAcls(std::move(newAcls));
+        changed = true;
+      }
     }
-  }
+    aclsFingerprint.node = new_->getAcls();
+    recordSection(kAclsSection, std::move(aclsFingerprint));
 
-  {
-    auto newQosPolicies = updateQosPolicies();
-    if (newQosPolicies) {
-      new_->resetQosPolicies(std::move(newQosPolicies));
-      changed = true;
+    if (newQosPoliciesFuture.valid()) {
+      auto newQosPolicies = newQosPoliciesFuture.get();
+      if (newQosPolicies) {
+        new_->resetQosPolicies(std::move(newQosPolicies));
+        changed = true;
+      }
     }
+    qosPoliciesFingerprint.node = new_->getQosPolicies();
+    recordSection(kQosPoliciesSection, std::move(qosPoliciesFingerprint));
   }
 
   // reset the default qos policy
@@ -537,12 +647,44 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
     }
   }
 
+  if (fingerprints_) {
+    *fingerprints_ = std::move(newFingerprints_);
+  }
+
   if (!changed) {
     return nullptr;
   }
   return new_;
 }
 
+bool ThriftConfigApplier::isSectionUnchanged(
+    const std::string& section,
+    const ThriftConfigSectionFingerprint& fingerprint) const {
+  if (!fingerprints_) {
+    return false;
+  }
+  auto itr = fingerprints_->find(section);
+  if (itr == fingerprints_->end()) {
+    return false;
+  }
+  const auto& lastFingerprint = itr->second;
+  if (lastFingerprint.configHash != fingerprint.configHash ||
+      lastFingerprint.node != fingerprint.node ||
+      lastFingerprint.dependencies != fingerprint.dependencies) {
+    return false;
+  }
+  XLOG(DBG2) << "Skipping unchanged config section " << section;
+  return true;
+}
+
+void ThriftConfigApplier::recordSection(
+    const std::string& section,
+    ThriftConfigSectionFingerprint fingerprint) {
+  if (fingerprints_) {
+    newFingerprints_[section] = std::move(fingerprint);
+  }
+}
+
 void ThriftConfigApplier::processVlanPorts() {
   // Build the Port --> Vlan mappings
   //
@@ -2402,9 +2544,11 @@ shared_ptr<SwitchState> applyThriftConfig(
     const shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib) {
+    rib::RoutingInformationBase* rib,
+    ThriftConfigFingerprints* fingerprints) {
   cfg::SwitchConfig emptyConfig;
-  return ThriftConfigApplier(state, config, platform, rib).run();
+  return ThriftConfigApplier(state, config, platform, rib, fingerprints)
+      .run();
 }
 
 } // namespace facebook::fboss
@@ -10,7 +10,11 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -22,19 +26,38 @@ namespace cfg {
 class SwitchConfig;
 }
 
+class NodeBase;
 class Platform;
 class SwitchState;
 
+/*
+ * What applyThriftConfig() remembers about a config section (e.g. ACLs) from
+ * one apply to the next: a hash of the config the section was applied from,
+ * the state node it produced, and the state nodes it was computed against.
+ */
+struct ThriftConfigSectionFingerprint {
+  uint64_t configHash{0};
+  std::shared_ptr<NodeBase> node;
+  std::vector<std::shared_ptr<NodeBase>> dependencies;
+};
+using ThriftConfigFingerprints =
+    std::map<std::string, ThriftConfigSectionFingerprint>;
+
 /*
  * Apply a thrift config structure to a SwitchState object.
  *
  * Returns a new SwitchState object with the resulting state, or null if
  * the config file results in no changes.
+ *
+ * If fingerprints is given, it is used to skip config sections whose config,
+ * and the state they were computed against, did not change since the last
+ * apply with the same fingerprints. It is updated on success.
  */
 std::shared_ptr<SwitchState> applyThriftConfig(
     const std::shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib = nullptr);
+    rib::RoutingInformationBase* rib = nullptr,
+    ThriftConfigFingerprints* fingerprints = nullptr);
 
 } // namespace facebook::fboss
@@ -44,6 +44,7 @@ inline constexpr folly::StringPiece kRibV4{"ribV4"};
 inline constexpr folly::StringPiece kRibV6{"ribV6"};
 inline constexpr folly::StringPiece kRouterId{"routerId"};
 inline constexpr folly::StringPiece kStack{"stack"};
+inline constexpr folly::StringPiece kStateJournal{"stateJournal"};
 inline constexpr folly::StringPiece kSwSwitch{"swSwitch"};
 inline constexpr folly::StringPiece kVlan{"vlan"};
 inline constexpr folly::StringPiece kVrf{"vrf"};
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace folly {
 struct dynamic;
@@ -255,6 +256,17 @@ class HwSwitch {
    */
   virtual bool getAndClearNeighborHit(RouterID vrf, folly::IPAddress& ip) = 0;
 
+  /*
+   * Returns the arp/ndp entries in vrf that have been hit since their hit
+   * bits were last cleared, and clears them, in a single pass over the
+   * neighbor table. Returns std::nullopt if the HW only supports checking
+   * one entry at a time through getAndClearNeighborHit.
+   */
+  virtual std::optional<std::vector<folly::IPAddress>> getAndClearNeighborHits(
+      RouterID /*vrf*/) {
+    return std::nullopt;
+  }
+
   /*
    * Clear port stats for specified port
    */
@@ -19,6 +19,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/IPHeaderV4.h"
+#include "fboss/agent/IcmpErrorRateLimiter.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -89,6 +90,12 @@ void IPv4Handler::sendICMPTimeExceeded(
     MacAddress src,
     IPv4Hdr& v4Hdr,
     Cursor cursor) {
+  // Check the rate limit before doing any work for the response
+  if (!sw_->getIcmpErrorRateLimiter()->allow(
+          cfg::IcmpErrorType::TIME_EXCEEDED, srcVlan, v4Hdr.srcAddr)) {
+    sw_->stats()->icmpTimeExceededSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   // payload serialization function
@@ -14,6 +14,7 @@
 #include <folly/logging/xlog.h>
 #include "fboss/agent/DHCPv6Handler.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/IcmpErrorRateLimiter.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/RxPacket.h"
@@ -542,6 +543,12 @@ void IPv6Handler::sendICMPv6TimeExceeded(
     MacAddress src,
     IPv6Hdr& v6Hdr,
     folly::io::Cursor cursor) {
+  // Check the rate limit before doing any work for the response
+  if (!sw_->getIcmpErrorRateLimiter()->allow(
+          cfg::IcmpErrorType::TIME_EXCEEDED, srcVlan, v6Hdr.srcAddr)) {
+    sw_->stats()->icmpTimeExceededSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   /*
@@ -591,6 +598,12 @@ void IPv6Handler::sendICMPv6PacketTooBig(
     IPv6Hdr& v6Hdr,
     int expectedMtu,
     folly::io::Cursor cursor) {
+  // Check the rate limit before doing any work for the response
+  if (!sw_->getIcmpErrorRateLimiter()->allow(
+          cfg::IcmpErrorType::PACKET_TOO_BIG, srcVlan, v6Hdr.srcAddr)) {
+    sw_->stats()->icmpPktTooBigSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   // payload serialization function
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/IcmpErrorRateLimiter.h"
+
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+IcmpErrorRateLimiter::ScopeLimits::ScopeLimits(
+    const cfg::IcmpErrorRateLimit& defaultLimit,
+    const std::map<cfg::IcmpErrorType, cfg::IcmpErrorRateLimit>& overrides)
+    : defaultLimit(toLimit(defaultLimit)) {
+  for (const auto& typeAndLimit : overrides) {
+    this->overrides.emplace(typeAndLimit.first, toLimit(typeAndLimit.second));
+  }
+}
+
+const IcmpErrorRateLimiter::Limit& IcmpErrorRateLimiter::ScopeLimits::getLimit(
+    cfg::IcmpErrorType type) const {
+  auto iter = overrides.find(type);
+  return iter == overrides.end() ? defaultLimit : iter->second;
+}
+
+bool IcmpErrorRateLimiter::ScopeLimits::isLimited() const {
+  return defaultLimit.isLimited() ||
+      std::any_of(overrides.begin(), overrides.end(), [](const auto& entry) {
+           return entry.second.isLimited();
+         });
+}
+
+IcmpErrorRateLimiter::Limit IcmpErrorRateLimiter::toLimit(
+    const cfg::IcmpErrorRateLimit& limit) {
+  Limit result;
+  if (limit.packetsPerSecond <= 0) {
+    return result;
+  }
+  result.rate = limit.packetsPerSecond;
+  // Default to one second worth of tokens, and always allow for at least one
+  result.burst = std::max<double>(
+      1, limit.burstSize > 0 ? limit.burstSize : limit.packetsPerSecond);
+  return result;
+}
+
+void IcmpErrorRateLimiter::updateConfig(
+    const cfg::IcmpErrorRateLimitConfig* config) {
+  std::optional<cfg::IcmpErrorRateLimitConfig> newConfig;
+  if (config) {
+    newConfig = *config;
+  }
+  if (newConfig == config_) {
+    return;
+  }
+  config_ = newConfig;
+
+  Buckets newBuckets;
+  if (config_) {
+    newBuckets.perInterface = ScopeLimits(
+        config_->perInterface, config_->perInterfaceOverrides);
+    newBuckets.perSource =
+        ScopeLimits(config_->perSource, config_->perSourceOverrides);
+  }
+  bool enabled =
+      newBuckets.perInterface.isLimited() || newBuckets.perSource.isLimited();
+  XLOG(DBG2) << "ICMP error rate limiting "
+             << (enabled ? "enabled" : "disabled");
+  *buckets_.wlock() = std::move(newBuckets);
+  enabled_.store(enabled, std::memory_order_release);
+}
+
+bool IcmpErrorRateLimiter::allow(
+    cfg::IcmpErrorType type,
+    VlanID vlan,
+    const folly::IPAddress& src,
+    double nowInSeconds) {
+  if (!enabled_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  auto buckets = buckets_.wlock();
+  const auto& intfLimit = buckets->perInterface.getLimit(type);
+  const auto& srcLimit = buckets->perSource.getLimit(type);
+
+  // Check both buckets before consuming from either, so that errors dropped
+  // for one source do not use up the budget of the whole interface.
+  folly::DynamicTokenBucket* intfBucket = nullptr;
+  if (intfLimit.isLimited()) {
+    intfBucket = &buckets->interfaceBuckets[std::make_pair(type, vlan)];
+    if (intfBucket->available(intfLimit.rate, intfLimit.burst, nowInSeconds) <
+        1) {
+      return false;
+    }
+  }
+  folly::DynamicTokenBucket* srcBucket = nullptr;
+  if (srcLimit.isLimited()) {
+    auto key = std::make_pair(type, src);
+    auto iter = buckets->sourceBuckets.find(key);
+    if (iter == buckets->sourceBuckets.end()) {
+      if (buckets->sourceBuckets.size() >= kMaxSourceBuckets) {
+        pruneSourceBuckets(&(*buckets), nowInSeconds);
+      }
+      iter = buckets->sourceBuckets.emplace(key, folly::DynamicTokenBucket())
+                 .first;
+    }
+    srcBucket = &iter->second;
+    if (srcBucket->available(srcLimit.rate, srcLimit.burst, nowInSeconds) <
+        1) {
+      return false;
+    }
+  }
+
+  if (intfBucket) {
+    intfBucket->consume(1, intfLimit.rate, intfLimit.burst, nowInSeconds);
+  }
+  if (srcBucket) {
+    srcBucket->consume(1, srcLimit.rate, srcLimit.burst, nowInSeconds);
+  }
+  return true;
+}
+
+void IcmpErrorRateLimiter::pruneSourceBuckets(
+    Buckets* buckets,
+    double nowInSeconds) {
+  // A bucket that has filled up again is no different from a new one
+  auto& sourceBuckets = buckets->sourceBuckets;
+  for (auto iter = sourceBuckets.begin(); iter != sourceBuckets.end();) {
+    const auto& limit = buckets->perSource.getLimit(iter->first.first);
+    if (iter->second.available(limit.rate, limit.burst, nowInSeconds) >=
+        limit.burst) {
+      iter = sourceBuckets.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  if (sourceBuckets.size() >= kMaxSourceBuckets) {
+    // Too many active sources to track, most likely spoofed. Start over,
+    // the per interface buckets still bound the rate of errors we send.
+    XLOG(DBG2) << "Resetting " << sourceBuckets.size()
+               << " ICMP error source buckets";
+    sourceBuckets.clear();
+  }
+}
+
+size_t IcmpErrorRateLimiter::numSourceBuckets() const {
+  return buckets_.rlock()->sourceBuckets.size();
+}
+
+} // namespace facebook::fboss
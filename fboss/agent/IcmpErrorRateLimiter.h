@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
+
+#include <atomic>
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace facebook::fboss {
+
+/*
+ * Token buckets for the ICMP errors that the agent generates in software.
+ *
+ * Every trapped packet with an expired TTL (or that is too big for the
+ * egress MTU) would otherwise cost us a packet allocation and a send, so a
+ * traceroute storm or a routing loop can eat the CPU that the control plane
+ * needs. Callers ask allow() before building the ICMP packet, and drop the
+ * error if it returns false.
+ *
+ * Buckets are kept per (error type, ingress VLAN) and per (error type,
+ * source address of the offending packet). An error needs a token from
+ * both. Everything is unlimited until a config with limits is applied.
+ */
+class IcmpErrorRateLimiter {
+ public:
+  IcmpErrorRateLimiter() {}
+
+  /*
+   * Apply the rate limits from the switch config, nullptr removes all
+   * limits. Buckets are only reset if the limits changed.
+   */
+  void updateConfig(const cfg::IcmpErrorRateLimitConfig* config);
+
+  bool allow(
+      cfg::IcmpErrorType type,
+      VlanID vlan,
+      const folly::IPAddress& src,
+      double nowInSeconds = folly::TokenBucket::defaultClockNow());
+
+  size_t numSourceBuckets() const;
+
+  // Upper bound on the number of per source buckets
+  static constexpr size_t kMaxSourceBuckets = 8192;
+
+ private:
+  struct Limit {
+    double rate{0};
+    double burst{0};
+
+    bool isLimited() const {
+      return rate > 0;
+    }
+  };
+
+  struct ScopeLimits {
+    ScopeLimits() {}
+    ScopeLimits(
+        const cfg::IcmpErrorRateLimit& defaultLimit,
+        const std::map<cfg::IcmpErrorType, cfg::IcmpErrorRateLimit>&
+            overrides);
+
+    const Limit& getLimit(cfg::IcmpErrorType type) const;
+    bool isLimited() const;
+
+    Limit defaultLimit;
+    std::map<cfg::IcmpErrorType, Limit> overrides;
+  };
+
+  template <typename KeyT>
+  using BucketMap =
+      std::map<std::pair<cfg::IcmpErrorType, KeyT>, folly::DynamicTokenBucket>;
+
+  struct Buckets {
+    ScopeLimits perInterface;
+    ScopeLimits perSource;
+    BucketMap<VlanID> interfaceBuckets;
+    BucketMap<folly::IPAddress> sourceBuckets;
+  };
+
+  static Limit toLimit(const cfg::IcmpErrorRateLimit& limit);
+  void pruneSourceBuckets(Buckets* buckets, double nowInSeconds);
+
+  // Forbidden copy constructor and assignment operator
+  IcmpErrorRateLimiter(IcmpErrorRateLimiter const&) = delete;
+  IcmpErrorRateLimiter& operator=(IcmpErrorRateLimiter const&) = delete;
+
+  std::optional<cfg::IcmpErrorRateLimitConfig> config_;
+  // Lets allow() skip the lock while nothing is rate limited
+  std::atomic<bool> enabled_{false};
+  folly::Synchronized<Buckets> buckets_;
+};
+
+} // namespace facebook::fboss
@@ -14,6 +14,14 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
   ~LookupClassUpdater() override {}
 
   void stateUpdated(const StateDelta& stateDelta) override;
+  bool canRunConcurrently() const override {
+    return true;
+  }
+  std::vector<std::string> getStateObserverDependencies() const override {
+    // Neighbor caches of new VLANs need to exist before class IDs of their
+    // entries get updated.
+    return {"NeighborUpdater"};
+  }
 
   int getRefCnt(
       PortID portID,
@@ -12,25 +12,33 @@
 #include "fboss/agent/state/SwitchState.h"
 
 using boost::container::flat_set;
-using facebook::fboss::DeltaFunctions::isEmpty;
 using folly::IPAddress;
 using std::optional;
 
 namespace facebook::fboss {
 
 void MirrorManager::stateUpdated(const StateDelta& delta) {
-  if (!hasMirrorChanges(delta)) {
+  DeltaFunctions::forEachRemoved(
+      delta.getMirrorsDelta(), [this](const std::shared_ptr<Mirror>& mirror) {
+        v4Manager_->mirrorRemoved(mirror->getID());
+        v6Manager_->mirrorRemoved(mirror->getID());
+      });
+
+  auto mirrorsToResolve = getMirrorsToResolve(delta);
+  if (mirrorsToResolve.empty()) {
     return;
   }
 
-  auto updateMirrorsFn = [this](const std::shared_ptr<SwitchState>& state) {
-    return resolveMirrors(state);
+  auto updateMirrorsFn = [this, mirrorsToResolve = std::move(mirrorsToResolve)](
+                             const std::shared_ptr<SwitchState>& state) {
+    return resolveMirrors(state, mirrorsToResolve);
   };
   sw_->updateState("Updating mirrors", updateMirrorsFn);
 }
 
 std::shared_ptr<SwitchState> MirrorManager::resolveMirrors(
-    const std::shared_ptr<SwitchState>& state) {
+    const std::shared_ptr<SwitchState>& state,
+    const std::set<std::string>& mirrorsToResolve) {
   auto mirrors = state->getMirrors()->clone();
   bool mirrorsUpdated = false;
 
@@ -39,10 +47,13 @@ std::shared_ptr<SwitchState> MirrorManager::resolveMirrors(
       /* SPAN mirror does not require resolving */
       continue;
     }
+    if (mirrorsToResolve.find(mirror->getID()) == mirrorsToResolve.end()) {
+      continue;
+    }
     const auto destinationIp = mirror->getDestinationIp().value();
     std::shared_ptr<Mirror> updatedMirror = destinationIp.isV4()
-        ? v4Manager_->updateMirror(mirror)
-        : v6Manager_->updateMirror(mirror);
+        ? v4Manager_->updateMirror(state, mirror)
+        : v6Manager_->updateMirror(state, mirror);
     if (updatedMirror) {
       XLOG(INFO) << "Mirror: " << updatedMirror->getID() << " updated.";
       mirrors->updateNode(updatedMirror);
@@ -57,16 +68,21 @@ std::shared_ptr<SwitchState> MirrorManager::resolveMirrors(
   return updatedState;
 }
 
-bool MirrorManager::hasMirrorChanges(const StateDelta& delta) {
-  return (sw_->getState()->getMirrors()->size() > 0) &&
-      (!isEmpty(delta.getRouteTablesDelta()) ||
-       std::any_of(
-           std::begin(delta.getVlansDelta()),
-           std::end(delta.getVlansDelta()),
-           [](const VlanDelta& vlanDelta) {
-             return !isEmpty(vlanDelta.getArpDelta()) ||
-                 !isEmpty(vlanDelta.getNdpDelta());
-           }));
+std::set<std::string> MirrorManager::getMirrorsToResolve(
+    const StateDelta& delta) {
+  std::set<std::string> mirrorsToResolve;
+  for (const auto& mirror : *delta.newState()->getMirrors()) {
+    if (!mirror->getDestinationIp()) {
+      continue;
+    }
+    bool needsResolution = mirror->getDestinationIp()->isV4()
+        ? v4Manager_->needsResolution(mirror, delta)
+        : v6Manager_->needsResolution(mirror, delta);
+    if (needsResolution) {
+      mirrorsToResolve.insert(mirror->getID());
+    }
+  }
+  return mirrorsToResolve;
 }
 
 } // namespace facebook::fboss
@@ -7,6 +7,9 @@
 #include "fboss/agent/state/RouteNextHop.h"
 #include "fboss/agent/state/StateDelta.h"
 
+#include <set>
+#include <string>
+
 namespace facebook::fboss {
 
 class MirrorManager : public AutoRegisterStateObserver {
@@ -19,16 +22,23 @@ class MirrorManager : public AutoRegisterStateObserver {
   ~MirrorManager() override {}
 
   void stateUpdated(const StateDelta& delta) override;
+  bool canRunConcurrently() const override {
+    return true;
+  }
 
  private:
   SwSwitch* sw_;
   std::unique_ptr<MirrorManagerV4> v4Manager_;
   std::unique_ptr<MirrorManagerV6> v6Manager_;
 
-  bool hasMirrorChanges(const StateDelta& delta);
+  /*
+   * Names of the mirrors whose resolution may be stale after delta
+   */
+  std::set<std::string> getMirrorsToResolve(const StateDelta& delta);
 
   std::shared_ptr<SwitchState> resolveMirrors(
-      const std::shared_ptr<SwitchState>& state);
+      const std::shared_ptr<SwitchState>& state,
+      const std::set<std::string>& mirrorsToResolve);
 };
 
 } // namespace facebook::fboss
@@ -11,6 +11,8 @@
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteTable.h"
 #include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 
@@ -22,11 +24,13 @@ namespace facebook::fboss {
 
 template <typename AddrT>
 std::shared_ptr<Mirror> MirrorManagerImpl<AddrT>::updateMirror(
+    const std::shared_ptr<SwitchState>& state,
     const std::shared_ptr<Mirror>& mirror) {
   const AddrT destinationIp =
       getIPAddress<AddrT>(mirror->getDestinationIp().value());
-  const auto state = sw_->getState();
-  const auto nexthops = resolveMirrorNextHops(state, destinationIp);
+  MirrorDependencies dependencies;
+  const auto nexthops =
+      resolveMirrorNextHops(state, destinationIp, &dependencies);
 
   auto newMirror = std::make_shared<Mirror>(
       mirror->getID(),
@@ -38,8 +42,8 @@ std::shared_ptr<Mirror> MirrorManagerImpl<AddrT>::updateMirror(
       mirror->getTruncate());
 
   for (const auto& nexthop : nexthops) {
-    const auto entry =
-        resolveMirrorNextHopNeighbor(state, mirror, destinationIp, nexthop);
+    const auto entry = resolveMirrorNextHopNeighbor(
+        state, mirror, destinationIp, nexthop, &dependencies);
 
     if (!entry) {
       continue;
@@ -61,17 +65,98 @@ std::shared_ptr<Mirror> MirrorManagerImpl<AddrT>::updateMirror(
   }
 
   if (*mirror == *newMirror) {
+    dependencies.mirror = mirror;
+    (*dependencies_.wlock())[mirror->getID()] = std::move(dependencies);
     return std::shared_ptr<Mirror>(nullptr);
   }
+  dependencies.mirror = newMirror;
+  (*dependencies_.wlock())[mirror->getID()] = std::move(dependencies);
   return newMirror;
 }
 
+template <typename AddrT>
+bool MirrorManagerImpl<AddrT>::needsResolution(
+    const std::shared_ptr<Mirror>& mirror,
+    const StateDelta& delta) const {
+  auto dependencies = dependencies_.rlock();
+  auto iter = dependencies->find(mirror->getID());
+  if (iter == dependencies->end() || iter->second.mirror != mirror) {
+    return true;
+  }
+  if (!DeltaFunctions::isEmpty(delta.getIntfsDelta())) {
+    // Tunnel source addresses and MACs come from interfaces
+    return true;
+  }
+  const AddrT destinationIp =
+      getIPAddress<AddrT>(mirror->getDestinationIp().value());
+  return routesChanged(iter->second, destinationIp, delta) ||
+      neighborsChanged(iter->second, delta);
+}
+
+template <typename AddrT>
+bool MirrorManagerImpl<AddrT>::routesChanged(
+    const MirrorDependencies& dependencies,
+    const AddrT& destinationIp,
+    const StateDelta& delta) const {
+  auto affectsMirror = [&](const auto& routeDelta) {
+    const auto& route =
+        routeDelta.getNew() ? routeDelta.getNew() : routeDelta.getOld();
+    const auto& prefix = route->prefix();
+    if (dependencies.coveringPrefix &&
+        prefix.mask < dependencies.coveringPrefix->mask) {
+      // Can not become the longest match while the covering prefix exists
+      return false;
+    }
+    return destinationIp.inSubnet(prefix.network, prefix.mask);
+  };
+  auto anyAffectsMirror = [&](const std::vector<RouteChanges>& allChanges) {
+    for (const auto& changes : allChanges) {
+      if (changes.routerId != RouterID(0)) {
+        continue;
+      }
+      for (const auto& routeDelta : changes.template getRoutes<AddrT>()) {
+        if (affectsMirror(routeDelta)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+  const auto& changeLog = delta.getChangeLog();
+  return anyAffectsMirror(changeLog.getRouteTableChanges()) ||
+      anyAffectsMirror(changeLog.getFibChanges());
+}
+
+template <typename AddrT>
+bool MirrorManagerImpl<AddrT>::neighborsChanged(
+    const MirrorDependencies& dependencies,
+    const StateDelta& delta) const {
+  if (dependencies.neighbors.empty()) {
+    return false;
+  }
+  for (const auto& changes : delta.getChangeLog().getNeighborChanges()) {
+    for (const auto& neighborDelta : changes.template getNeighbors<AddrT>()) {
+      const auto& neighbor = neighborDelta.getNew() ? neighborDelta.getNew()
+                                                    : neighborDelta.getOld();
+      if (dependencies.neighbors.count(
+              std::make_pair(changes.vlanId, neighbor->getIP()))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 template <typename AddrT>
 RouteNextHopEntry::NextHopSet MirrorManagerImpl<AddrT>::resolveMirrorNextHops(
     const std::shared_ptr<SwitchState>& state,
-    const AddrT& destinationIp) {
+    const AddrT& destinationIp,
+    MirrorDependencies* dependencies) {
   const auto route =
       sw_->longestMatch<AddrT>(state, destinationIp, RouterID(0));
+  if (route) {
+    dependencies->coveringPrefix = route->prefix();
+  }
   if (!route || !route->isResolved()) {
     return RouteNextHopEntry::NextHopSet();
   }
@@ -84,7 +169,8 @@ MirrorManagerImpl<AddrT>::resolveMirrorNextHopNeighbor(
     const std::shared_ptr<SwitchState>& state,
     const std::shared_ptr<Mirror>& mirror,
     const AddrT& destinationIp,
-    const NextHop& nexthop) const {
+    const NextHop& nexthop,
+    MirrorDependencies* dependencies) const {
   std::shared_ptr<NeighborEntryT> neighbor;
   if (!nexthop.isResolved()) {
     return std::shared_ptr<NeighborEntryT>(nullptr);
@@ -96,14 +182,12 @@ MirrorManagerImpl<AddrT>::resolveMirrorNextHopNeighbor(
       state->getInterfaces()->getInterfaceIf(mirrorEgressInterface);
   auto vlan = state->getVlans()->getVlanIf(interface->getVlanID());
 
-  if (interface->hasAddress(mirrorNextHopIp)) {
-    /* if mirror destination is directly connected */
-    neighbor = vlan->template getNeighborEntryTable<AddrT>()->getEntryIf(
-        destinationIp);
-  } else {
-    neighbor = vlan->template getNeighborEntryTable<AddrT>()->getEntryIf(
-        mirrorNextHopIp);
-  }
+  /* if mirror destination is directly connected */
+  const auto& neighborIp =
+      interface->hasAddress(mirrorNextHopIp) ? destinationIp : mirrorNextHopIp;
+  neighbor =
+      vlan->template getNeighborEntryTable<AddrT>()->getEntryIf(neighborIp);
+  dependencies->neighbors.emplace(vlan->getID(), neighborIp);
 
   if (!neighbor || neighbor->zeroPort() ||
       !neighbor->getPort().isPhysicalPort() ||
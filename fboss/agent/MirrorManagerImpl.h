@@ -4,16 +4,25 @@
 
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <folly/Synchronized.h>
 
 #include "fboss/agent/state/ArpEntry.h"
 #include "fboss/agent/state/Mirror.h"
 #include "fboss/agent/state/NdpEntry.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/RouteTypes.h"
+
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace facebook::fboss {
 
 class Mirror;
 class MirrorTunnel;
+class StateDelta;
 class SwSwitch;
 
 template <typename AddrT>
@@ -28,18 +37,56 @@ class MirrorManagerImpl {
   explicit MirrorManagerImpl(SwSwitch* sw) : sw_(sw) {}
   ~MirrorManagerImpl() {}
 
-  std::shared_ptr<Mirror> updateMirror(const std::shared_ptr<Mirror>& mirror);
+  std::shared_ptr<Mirror> updateMirror(
+      const std::shared_ptr<SwitchState>& state,
+      const std::shared_ptr<Mirror>& mirror);
+
+  /*
+   * Whether mirror has to be resolved again after delta: it was not
+   * resolved here yet, it changed since, or delta touches a route or
+   * neighbor its last resolution went through.
+   */
+  bool needsResolution(
+      const std::shared_ptr<Mirror>& mirror,
+      const StateDelta& delta) const;
+
+  void mirrorRemoved(const std::string& name) {
+    dependencies_.wlock()->erase(name);
+  }
 
  private:
+  /*
+   * What the last resolution of a mirror depended on
+   */
+  struct MirrorDependencies {
+    // Mirror node as of the last resolution
+    std::shared_ptr<Mirror> mirror;
+    // Longest prefix matching the mirror destination, if any
+    std::optional<RoutePrefix<AddrT>> coveringPrefix;
+    // Neighbor entries looked up, whether they existed or not
+    std::set<std::pair<VlanID, AddrT>> neighbors;
+  };
+
+  bool routesChanged(
+      const MirrorDependencies& dependencies,
+      const AddrT& destinationIp,
+      const StateDelta& delta) const;
+
+  bool neighborsChanged(
+      const MirrorDependencies& dependencies,
+      const StateDelta& delta) const;
+
   NextHopSet resolveMirrorNextHops(
       const std::shared_ptr<SwitchState>& state,
-      const AddrT& destinationIp);
+      const AddrT& destinationIp,
+      MirrorDependencies* dependencies);
 
   std::shared_ptr<NeighborEntryT> resolveMirrorNextHopNeighbor(
       const std::shared_ptr<SwitchState>& state,
       const std::shared_ptr<Mirror>& mirror,
       const AddrT& destinationIp,
-      const NextHop& nexthop) const;
+      const NextHop& nexthop,
+      MirrorDependencies* dependencies) const;
 
   MirrorTunnel resolveMirrorTunnel(
       const std::shared_ptr<SwitchState>& state,
@@ -64,6 +111,10 @@ class MirrorManagerImpl {
   }
 
   SwSwitch* sw_;
+  // Written by updateMirror() on the update thread, read by needsResolution()
+  // which MirrorManager may run on the state observer pool
+  folly::Synchronized<std::unordered_map<std::string, MirrorDependencies>>
+      dependencies_;
 };
 
 using MirrorManagerV4 = MirrorManagerImpl<folly::IPAddressV4>;
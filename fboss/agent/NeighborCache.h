@@ -212,7 +212,10 @@ class NeighborCache {
 
   // Has the entry corresponding to ip has been hit in hw
   bool isHit(AddressType ip) {
-    return sw_->getAndClearNeighborHit(RouterID(0), ip);
+    // Stale entries are each checked once per staleEntryInterval_, so one
+    // scan of the HW hit bits per interval serves all of them
+    return sw_->getAndClearNeighborHitFromScan(
+        RouterID(0), ip, staleEntryInterval_);
   }
 
   // Forbidden copy constructor and assignment operator
@@ -20,6 +20,7 @@
 #include "fboss/agent/state/NdpTable.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
@@ -74,8 +75,10 @@ auto NeighborUpdater::createCaches(const SwitchState* state, const Vlan* vlan)
 
 void NeighborUpdater::stateUpdated(const StateDelta& delta) {
   CHECK(sw_->getUpdateEvb()->inRunningEventBaseThread());
+  for (const auto& changes : delta.getChangeLog().getNeighborChanges()) {
+    sendNeighborUpdates(changes);
+  }
   for (const auto& entry : delta.getVlansDelta()) {
-    sendNeighborUpdates(entry);
     auto oldEntry = entry.getOld();
     auto newEntry = entry.getNew();
 
@@ -143,11 +146,11 @@ void collectPresenceChange(
   }
 }
 
-void NeighborUpdater::sendNeighborUpdates(const VlanDelta& delta) {
+void NeighborUpdater::sendNeighborUpdates(const NeighborChanges& changes) {
   std::vector<std::string> added;
   std::vector<std::string> deleted;
-  collectPresenceChange(delta.getArpDelta(), &added, &deleted);
-  collectPresenceChange(delta.getNdpDelta(), &added, &deleted);
+  collectPresenceChange(changes.arp, &added, &deleted);
+  collectPresenceChange(changes.ndp, &added, &deleted);
   if (!(added.empty() && deleted.empty())) {
     sw_->invokeNeighborListener(added, deleted);
   }
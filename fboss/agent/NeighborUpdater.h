@@ -25,6 +25,7 @@ namespace facebook::fboss {
 
 class SwitchState;
 class StateDelta;
+struct NeighborChanges;
 
 /**
  * This class handles all updates to neighbor entries. Whenever we perform an
@@ -104,7 +105,7 @@ class NeighborUpdater : public AutoRegisterStateObserver {
   void aggregatePortChanged(
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
-  void sendNeighborUpdates(const VlanDelta& delta);
+  void sendNeighborUpdates(const NeighborChanges& changes);
 
   // Forbidden copy constructor and assignment operator
   NeighborUpdater(NeighborUpdater const&) = delete;
@@ -7,6 +7,7 @@
 #include "fboss/agent/state/DeltaFunctions.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 #include "fboss/agent/state/SwitchState.h"
 
 #include <gflags/gflags.h>
@@ -62,30 +63,31 @@ ResolvedNexthopMonitor::ResolvedNexthopMonitor(SwSwitch* sw)
 
 void ResolvedNexthopMonitor::stateUpdated(const StateDelta& delta) {
   scheduleProbes_ = false;
-  for (auto const& rtDelta : delta.getRouteTablesDelta()) {
+  const auto& changeLog = delta.getChangeLog();
+  for (auto const& routeChanges : changeLog.getRouteTableChanges()) {
     forEachChanged(
-        rtDelta.getRoutesV4Delta(),
+        routeChanges.v4,
         &ResolvedNexthopMonitor::processChangedRouteNextHops<RouteV4>,
         &ResolvedNexthopMonitor::processAddedRouteNextHops<RouteV4>,
         &ResolvedNexthopMonitor::processRemovedRouteNextHops<RouteV4>,
         this);
     forEachChanged(
-        rtDelta.getRoutesV6Delta(),
+        routeChanges.v6,
         &ResolvedNexthopMonitor::processChangedRouteNextHops<RouteV6>,
         &ResolvedNexthopMonitor::processAddedRouteNextHops<RouteV6>,
         &ResolvedNexthopMonitor::processRemovedRouteNextHops<RouteV6>,
         this);
   }
 
-  for (const auto& fibDelta : delta.getFibsDelta()) {
+  for (const auto& fibChanges : changeLog.getFibChanges()) {
     forEachChanged(
-        fibDelta.getV4FibDelta(),
+        fibChanges.v4,
         &ResolvedNexthopMonitor::processChangedRouteNextHops<RouteV4>,
         &ResolvedNexthopMonitor::processAddedRouteNextHops<RouteV4>,
         &ResolvedNexthopMonitor::processRemovedRouteNextHops<RouteV4>,
         this);
     forEachChanged(
-        fibDelta.getV6FibDelta(),
+        fibChanges.v6,
         &ResolvedNexthopMonitor::processChangedRouteNextHops<RouteV6>,
         &ResolvedNexthopMonitor::processAddedRouteNextHops<RouteV6>,
         &ResolvedNexthopMonitor::processRemovedRouteNextHops<RouteV6>,
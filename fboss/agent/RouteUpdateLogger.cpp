@@ -10,6 +10,7 @@
 
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/state/DeltaFunctions.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 
 namespace facebook::fboss {
 
@@ -70,16 +71,17 @@ RouteUpdateLogger::RouteUpdateLogger(
       mplsRouteLogger_(std::move(mplsRouteLogger)) {}
 
 void RouteUpdateLogger::stateUpdated(const StateDelta& delta) {
-  for (const auto& rtDelta : delta.getRouteTablesDelta()) {
+  for (const auto& routeChanges :
+       delta.getChangeLog().getRouteTableChanges()) {
     DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV4Delta(),
+        routeChanges.v4,
         &handleChangedRoute<folly::IPAddressV4>,
         &handleAddedRoute<folly::IPAddressV4>,
         &handleRemovedRoute<folly::IPAddressV4>,
         prefixTracker_,
         routeLoggerV4_);
     DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV6Delta(),
+        routeChanges.v6,
         &handleChangedRoute<folly::IPAddressV6>,
         &handleAddedRoute<folly::IPAddressV6>,
         &handleRemovedRoute<folly::IPAddressV6>,
@@ -165,6 +165,9 @@ class RouteUpdateLogger : public AutoRegisterStateObserver {
   ~RouteUpdateLogger() override = default;
 
   void stateUpdated(const StateDelta& delta) override;
+  bool canRunConcurrently() const override {
+    return true;
+  }
   void startLoggingForPrefix(const RouteUpdateLoggingInstance& req);
   void stopLoggingForPrefix(
       const folly::IPAddress& network,
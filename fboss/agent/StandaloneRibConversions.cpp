@@ -45,7 +45,8 @@ static void dynamicFibUpdate(
       vrf, v4NetworkToRoute, v6NetworkToRoute);
 
   auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
-  sw->updateStateBlocking("", std::move(fibUpdater));
+  sw->updateStateBlocking(
+      "", std::move(fibUpdater), StateUpdate::Priority::LOW);
 }
 
 void syncFibWithStandaloneRib(
@@ -0,0 +1,271 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/agent/StateChangePublisher.h"
+
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/DeltaFunctions.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+
+DEFINE_int32(
+    state_change_subscriber_queue_size,
+    100000,
+    "Max number of coalesced changes queued for a state change subscriber "
+    "before they are dropped and the subscriber is asked to resync");
+DEFINE_int32(
+    state_change_coalesce_ms,
+    50,
+    "Time to let changes coalesce before sending a batch to a state change "
+    "subscriber");
+
+using facebook::fboss::DeltaFunctions::forEachChanged;
+
+namespace {
+using namespace facebook::fboss;
+
+constexpr auto kSubscribers = "state_change_publisher.subscribers";
+constexpr auto kBatchesSent = "state_change_publisher.batches_sent";
+constexpr auto kChangesSent = "state_change_publisher.changes_sent";
+constexpr auto kResyncs = "state_change_publisher.resyncs";
+
+StateChange makeChange(StateChangeKind kind, std::string key, bool removed) {
+  StateChange change;
+  change.kind = kind;
+  change.key = std::move(key);
+  change.removed = removed;
+  return change;
+}
+
+template <typename NeighborTableDelta>
+void collectNeighborChanges(
+    const NeighborTableDelta& delta,
+    std::vector<StateChange>* changes) {
+  for (const auto& entry : delta) {
+    auto oldEntry = entry.getOld();
+    auto newEntry = entry.getNew();
+    bool wasResolved = oldEntry && oldEntry->nonZeroPort();
+    bool isResolved = newEntry && newEntry->nonZeroPort();
+    if (wasResolved == isResolved) {
+      continue;
+    }
+    auto ip = isResolved ? newEntry->getIP() : oldEntry->getIP();
+    changes->push_back(makeChange(
+        StateChangeKind::NEIGHBOR, folly::to<std::string>(ip), !isResolved));
+  }
+}
+
+template <typename RoutesDelta>
+void collectRouteChanges(
+    RouterID vrf,
+    const RoutesDelta& delta,
+    std::vector<StateChange>* changes) {
+  auto routeKey = [vrf](const auto& route) {
+    return folly::to<std::string>(
+        static_cast<int>(vrf), ":", route->prefix().str());
+  };
+  forEachChanged(
+      delta,
+      [&](const auto& /*oldRoute*/, const auto& newRoute) {
+        changes->push_back(
+            makeChange(StateChangeKind::ROUTE, routeKey(newRoute), false));
+      },
+      [&](const auto& newRoute) {
+        changes->push_back(
+            makeChange(StateChangeKind::ROUTE, routeKey(newRoute), false));
+      },
+      [&](const auto& oldRoute) {
+        changes->push_back(
+            makeChange(StateChangeKind::ROUTE, routeKey(oldRoute), true));
+      });
+}
+
+StateChange makePortChange(const std::shared_ptr<Port>& port, bool removed) {
+  auto change = makeChange(
+      StateChangeKind::PORT,
+      folly::to<std::string>(static_cast<int>(port->getID())),
+      removed);
+  if (!removed) {
+    change.up_ref() = port->isUp();
+  }
+  return change;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+StateChangePublisher::StateChangePublisher(SwSwitch* sw)
+    : AutoRegisterStateObserver(sw, "StateChangePublisher") {}
+
+StateChangePublisher::~StateChangePublisher() {
+  // Outstanding batches hold on to their subscriber, make sure nothing
+  // more gets sent once they complete.
+  for (auto& subscriber : *subscribers_.wlock()) {
+    subscriber->broken = true;
+  }
+}
+
+std::vector<StateChange> StateChangePublisher::getChanges(
+    const StateDelta& delta) {
+  std::vector<StateChange> changes;
+  const auto& changeLog = delta.getChangeLog();
+  for (const auto& neighborChanges : changeLog.getNeighborChanges()) {
+    collectNeighborChanges(neighborChanges.arp, &changes);
+    collectNeighborChanges(neighborChanges.ndp, &changes);
+  }
+
+  for (const auto& routeChanges : changeLog.getRouteTableChanges()) {
+    collectRouteChanges(routeChanges.routerId, routeChanges.v4, &changes);
+    collectRouteChanges(routeChanges.routerId, routeChanges.v6, &changes);
+  }
+  for (const auto& fibChanges : changeLog.getFibChanges()) {
+    collectRouteChanges(fibChanges.routerId, fibChanges.v4, &changes);
+    collectRouteChanges(fibChanges.routerId, fibChanges.v6, &changes);
+  }
+
+  forEachChanged(
+      delta.getPortsDelta(),
+      [&](const std::shared_ptr<Port>& oldPort,
+          const std::shared_ptr<Port>& newPort) {
+        if (oldPort->isUp() != newPort->isUp()) {
+          changes.push_back(makePortChange(newPort, false));
+        }
+      },
+      [&](const std::shared_ptr<Port>& newPort) {
+        changes.push_back(makePortChange(newPort, false));
+      },
+      [&](const std::shared_ptr<Port>& oldPort) {
+        changes.push_back(makePortChange(oldPort, true));
+      });
+  return changes;
+}
+
+void StateChangePublisher::stateUpdated(const StateDelta& delta) {
+  std::vector<std::shared_ptr<Subscriber>> subscribers;
+  {
+    auto lockedSubscribers = subscribers_.wlock();
+    lockedSubscribers->erase(
+        std::remove_if(
+            lockedSubscribers->begin(),
+            lockedSubscribers->end(),
+            [](const auto& subscriber) { return subscriber->broken.load(); }),
+        lockedSubscribers->end());
+    fb303::fbData->setCounter(kSubscribers, lockedSubscribers->size());
+    subscribers = *lockedSubscribers;
+  }
+  if (subscribers.empty()) {
+    return;
+  }
+
+  auto changes = getChanges(delta);
+  if (changes.empty()) {
+    return;
+  }
+  for (const auto& subscriber : subscribers) {
+    enqueue(subscriber, changes);
+  }
+}
+
+void StateChangePublisher::subscribe(
+    folly::EventBase* evb,
+    std::set<StateChangeKind> kinds,
+    SendFn send) {
+  auto subscriber = std::make_shared<Subscriber>(
+      evb,
+      std::move(kinds),
+      std::move(send),
+      FLAGS_state_change_subscriber_queue_size);
+  auto lockedSubscribers = subscribers_.wlock();
+  lockedSubscribers->push_back(std::move(subscriber));
+  fb303::fbData->setCounter(kSubscribers, lockedSubscribers->size());
+}
+
+void StateChangePublisher::enqueue(
+    const std::shared_ptr<Subscriber>& subscriber,
+    const std::vector<StateChange>& changes) {
+  bool schedule = false;
+  {
+    auto pending = subscriber->pending.wlock();
+    for (const auto& change : changes) {
+      if (pending->resync) {
+        // Subscriber re-reads everything anyway
+        break;
+      }
+      if (subscriber->kinds.find(change.kind) == subscriber->kinds.end()) {
+        continue;
+      }
+      pending->changes[ChangeKey(change.kind, change.key)] = change;
+      if (pending->changes.size() > subscriber->maxPendingChanges) {
+        pending->changes.clear();
+        pending->resync = true;
+        fb303::fbData->addStatValue(kResyncs, 1, fb303::SUM);
+      }
+    }
+    if (!pending->scheduled &&
+        (pending->resync || !pending->changes.empty())) {
+      pending->scheduled = true;
+      schedule = true;
+    }
+  }
+  if (schedule) {
+    scheduleSend(subscriber);
+  }
+}
+
+void StateChangePublisher::scheduleSend(
+    std::shared_ptr<Subscriber> subscriber) {
+  auto evb = subscriber->evb;
+  evb->runInEventBaseThread([subscriber = std::move(subscriber)]() mutable {
+    if (FLAGS_state_change_coalesce_ms > 0) {
+      subscriber->evb->runAfterDelay(
+          [subscriber]() { sendPending(subscriber); },
+          FLAGS_state_change_coalesce_ms);
+    } else {
+      sendPending(std::move(subscriber));
+    }
+  });
+}
+
+void StateChangePublisher::sendPending(std::shared_ptr<Subscriber> subscriber) {
+  if (subscriber->broken) {
+    return;
+  }
+  StateChangeBatch batch;
+  {
+    auto pending = subscriber->pending.wlock();
+    if (!pending->resync && pending->changes.empty()) {
+      pending->scheduled = false;
+      return;
+    }
+    batch.resync = pending->resync;
+    batch.changes.reserve(pending->changes.size());
+    for (auto& keyAndChange : pending->changes) {
+      batch.changes.push_back(std::move(keyAndChange.second));
+    }
+    pending->changes.clear();
+    pending->resync = false;
+  }
+  fb303::fbData->addStatValue(kBatchesSent, 1, fb303::SUM);
+  fb303::fbData->addStatValue(kChangesSent, batch.changes.size(), fb303::SUM);
+  subscriber->send(std::move(batch), [subscriber](bool ok) {
+    if (!ok) {
+      XLOG(ERR) << "Dropping state change subscriber";
+      subscriber->broken = true;
+      return;
+    }
+    // Anything queued meanwhile goes out in the next batch
+    scheduleSend(subscriber);
+  });
+}
+
+} // namespace facebook::fboss
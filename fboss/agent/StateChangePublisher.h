@@ -0,0 +1,112 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/agent/StateObserver.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+
+#include <folly/Synchronized.h>
+#include <folly/io/async/EventBase.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class StateDelta;
+
+/*
+ * Publishes neighbor, route and port changes to subscribers as batches.
+ *
+ * Each subscriber has its own queue of pending changes, holding only the
+ * latest change per key. A batch is sent when the subscriber has no batch
+ * outstanding, so changes made while a subscriber is busy coalesce into its
+ * next batch. If a subscriber's queue grows past its bound, the queued
+ * changes are dropped and the next batch carries a resync marker instead.
+ * This keeps slow subscribers from building unbounded backlogs.
+ */
+class StateChangePublisher : public AutoRegisterStateObserver {
+ public:
+  /*
+   * Sends a batch to a subscriber. done(false) means the subscriber is
+   * gone and should be dropped.
+   */
+  using SendFn = std::function<
+      void(StateChangeBatch batch, std::function<void(bool)> done)>;
+
+  explicit StateChangePublisher(SwSwitch* sw);
+  ~StateChangePublisher() override;
+
+  void stateUpdated(const StateDelta& delta) override;
+  bool canRunConcurrently() const override {
+    return true;
+  }
+
+  /*
+   * Batches for the subscriber are sent from evb, and done must be invoked
+   * from evb too.
+   */
+  void subscribe(
+      folly::EventBase* evb,
+      std::set<StateChangeKind> kinds,
+      SendFn send);
+
+  size_t numSubscribers() const {
+    return subscribers_.rlock()->size();
+  }
+
+  /*
+   * Collect changes relevant to subscribers from a state delta
+   */
+  static std::vector<StateChange> getChanges(const StateDelta& delta);
+
+ private:
+  using ChangeKey = std::pair<StateChangeKind, std::string>;
+
+  struct PendingChanges {
+    std::map<ChangeKey, StateChange> changes;
+    bool resync{false};
+    // A batch is scheduled or outstanding
+    bool scheduled{false};
+  };
+
+  struct Subscriber {
+    Subscriber(
+        folly::EventBase* evb,
+        std::set<StateChangeKind> kinds,
+        SendFn send,
+        size_t maxPendingChanges)
+        : evb(evb),
+          kinds(std::move(kinds)),
+          send(std::move(send)),
+          maxPendingChanges(maxPendingChanges) {}
+
+    folly::EventBase* const evb;
+    const std::set<StateChangeKind> kinds;
+    const SendFn send;
+    const size_t maxPendingChanges;
+    folly::Synchronized<PendingChanges> pending;
+    std::atomic<bool> broken{false};
+  };
+
+  void enqueue(
+      const std::shared_ptr<Subscriber>& subscriber,
+      const std::vector<StateChange>& changes);
+  static void scheduleSend(std::shared_ptr<Subscriber> subscriber);
+  static void sendPending(std::shared_ptr<Subscriber> subscriber);
+
+  // Forbidden copy constructor and assignment operator
+  StateChangePublisher(StateChangePublisher const&) = delete;
+  StateChangePublisher& operator=(StateChangePublisher const&) = delete;
+
+  folly::Synchronized<std::vector<std::shared_ptr<Subscriber>>> subscribers_;
+};
+
+} // namespace facebook::fboss
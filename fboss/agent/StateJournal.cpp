@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateJournal.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/Random.h>
+#include <folly/experimental/bser/Bser.h>
+#include <folly/hash/Checksum.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+#include <gflags/gflags.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+DEFINE_int32(
+    state_journal_compaction_percent,
+    100,
+    "Compact the switch state journal into a new snapshot once the deltas "
+    "written since the last snapshot add up to this percentage of its size");
+
+namespace {
+constexpr auto kJournalFile = "switch_state_journal";
+constexpr auto kJournalId = "id";
+constexpr auto kSequence = "sequence";
+constexpr uint32_t kRecordMagic = 0x534a524e; // "SJRN"
+
+enum RecordType : uint32_t {
+  SNAPSHOT = 0,
+  DELTA = 1,
+};
+
+struct RecordHeader {
+  uint32_t magic;
+  uint32_t type;
+  uint64_t journalId;
+  uint64_t sequence;
+  uint32_t length;
+  uint32_t checksum;
+};
+
+std::string journalPath(const std::string& dir) {
+  return folly::to<std::string>(dir, "/", kJournalFile);
+}
+
+// Returns the size of the record written
+size_t appendRecord(
+    const folly::File& file,
+    RecordType type,
+    uint64_t journalId,
+    uint64_t sequence,
+    const folly::dynamic& payload) {
+  auto bser = folly::bser::toBser(payload, folly::bser::serialization_opts());
+  RecordHeader header{
+      kRecordMagic,
+      type,
+      journalId,
+      sequence,
+      static_cast<uint32_t>(bser.size()),
+      folly::crc32c(
+          reinterpret_cast<const uint8_t*>(bser.data()), bser.size())};
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(bser.data(), bser.size());
+  auto ret = folly::writeFull(file.fd(), record.data(), record.size());
+  if (ret != static_cast<ssize_t>(record.size())) {
+    throw facebook::fboss::SysError(errno, "failed to write state journal");
+  }
+  return record.size();
+}
+} // namespace
+
+namespace facebook::fboss {
+
+StateJournal::StateJournal(
+    const std::string& dir,
+    std::shared_ptr<SwitchState> initialState)
+    : path_(journalPath(dir)),
+      // Kept positive so it round trips through folly::dynamic
+      journalId_(folly::Random::rand64() >> 1),
+      pending_(std::move(initialState)),
+      queued_(1) {
+  thread_ = std::thread([this]() {
+    folly::setThreadName("fbossStateJournal");
+    threadMain();
+  });
+}
+
+StateJournal::~StateJournal() {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void StateJournal::append(std::shared_ptr<SwitchState> state) {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    pending_ = std::move(state);
+    ++queued_;
+  }
+  cv_.notify_all();
+}
+
+std::optional<folly::dynamic> StateJournal::flush(
+    std::shared_ptr<SwitchState> state) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_ = std::move(state);
+  auto ticket = ++queued_;
+  syncRequested_ = true;
+  cv_.notify_all();
+  cv_.wait(lock, [this, ticket]() {
+    return written_ >= ticket || failed_ >= ticket;
+  });
+  if (failed_ >= ticket) {
+    return std::nullopt;
+  }
+  folly::dynamic journalRef = folly::dynamic::object;
+  journalRef[kJournalId] = static_cast<int64_t>(journalId_);
+  journalRef[kSequence] = static_cast<int64_t>(writtenSequence_);
+  return journalRef;
+}
+
+void StateJournal::threadMain() {
+  while (true) {
+    std::shared_ptr<SwitchState> state;
+    uint64_t ticket;
+    bool sync;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return pending_ || stop_; });
+      if (!pending_) {
+        return;
+      }
+      state = std::move(pending_);
+      ticket = queued_;
+      sync = syncRequested_;
+      syncRequested_ = false;
+    }
+    bool written = true;
+    try {
+      writeRecord(state);
+      if (sync) {
+        sysCheckError(
+            ::fdatasync(file_.fd()), "failed to sync state journal ", path_);
+      }
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to journal switch state: " << ex.what();
+      // Start over with a snapshot on the next update
+      lastJournaled_.reset();
+      written = false;
+    }
+    {
+      std::lock_guard<std::mutex> g(mutex_);
+      if (written) {
+        written_ = ticket;
+        writtenSequence_ = sequence_;
+      } else {
+        failed_ = ticket;
+      }
+    }
+    cv_.notify_all();
+  }
+}
+
+void StateJournal::writeRecord(const std::shared_ptr<SwitchState>& state) {
+  // Deltas hold whole top level fields, so a few of them can add up to more
+  // than a snapshot. Compact by size to keep the journal, and replaying it,
+  // bounded by a small multiple of the snapshot.
+  auto compactionBytes = snapshotBytes_ / 100 *
+      std::max(FLAGS_state_journal_compaction_percent, 0);
+  if (!lastJournaled_ || deltaBytesSinceSnapshot_ >= compactionBytes) {
+    writeSnapshot(state);
+  } else if (state != lastJournaled_) {
+    auto delta = state->changedFieldsToFollyDynamic(*lastJournaled_);
+    if (!delta.empty()) {
+      deltaBytesSinceSnapshot_ +=
+          appendRecord(file_, DELTA, journalId_, sequence_ + 1, delta);
+      ++sequence_;
+    }
+  }
+  lastJournaled_ = state;
+}
+
+void StateJournal::writeSnapshot(const std::shared_ptr<SwitchState>& state) {
+  // Write the snapshot to a new file and move it in place, so that the
+  // journal is never without a complete snapshot
+  auto tmpPath = folly::to<std::string>(path_, ".tmp");
+  folly::File file(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  auto snapshotBytes = appendRecord(
+      file, SNAPSHOT, journalId_, sequence_ + 1, state->toFollyDynamic());
+  sysCheckError(
+      ::rename(tmpPath.c_str(), path_.c_str()),
+      "failed to rename ",
+      tmpPath,
+      " to ",
+      path_);
+  file_ = std::move(file);
+  ++sequence_;
+  snapshotBytes_ = snapshotBytes;
+  deltaBytesSinceSnapshot_ = 0;
+}
+
+folly::dynamic StateJournal::replay(
+    const std::string& dir,
+    const folly::dynamic& journalRef) {
+  auto path = journalPath(dir);
+  std::string journal;
+  if (!folly::readFile(path.c_str(), journal)) {
+    throw FbossError("unable to read state journal ", path);
+  }
+  auto journalId = static_cast<uint64_t>(journalRef[kJournalId].asInt());
+  auto sequence = static_cast<uint64_t>(journalRef[kSequence].asInt());
+
+  folly::dynamic state = nullptr;
+  uint64_t lastSequence = 0;
+  folly::ByteRange remaining(folly::StringPiece(journal));
+  while (remaining.size() >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    std::memcpy(&header, remaining.data(), sizeof(header));
+    remaining.advance(sizeof(header));
+    // A record that doesn't check out is the torn tail of a journal that
+    // wasn't flushed, nothing after it can be trusted
+    if (header.magic != kRecordMagic || header.journalId != journalId ||
+        header.length > remaining.size() ||
+        header.checksum != folly::crc32c(remaining.data(), header.length)) {
+      break;
+    }
+    auto payload =
+        folly::bser::parseBser(remaining.subpiece(0, header.length));
+    remaining.advance(header.length);
+
+    if (header.type == SNAPSHOT) {
+      state = std::move(payload);
+    } else {
+      if (state.isNull() || header.sequence != lastSequence + 1) {
+        break;
+      }
+      for (const auto& field : payload.items()) {
+        if (field.second.isNull()) {
+          state.erase(field.first);
+        } else {
+          state[field.first] = field.second;
+        }
+      }
+    }
+    lastSequence = header.sequence;
+    if (lastSequence == sequence) {
+      return state;
+    }
+  }
+  throw FbossError(
+      "state journal ", path, " does not reach sequence ", sequence);
+}
+
+} // namespace facebook::fboss
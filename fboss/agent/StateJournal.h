@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/File.h>
+#include <folly/dynamic.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace facebook::fboss {
+
+class SwitchState;
+
+/*
+ * StateJournal keeps a serialized copy of the applied SwitchState in the warm
+ * boot directory up to date as states are applied, so that graceful exit
+ * doesn't have to serialize the whole state on the warm boot critical path.
+ *
+ * The journal is a sequence of checksummed binary records: a snapshot of the
+ * full state, followed by deltas holding the top level fields of the state
+ * that changed. Once the deltas add up to the size of the snapshot (see
+ * --state_journal_compaction_percent), the journal is compacted into a new
+ * snapshot. Records are written by a background thread; if it falls
+ * behind, intermediate states are folded into a single delta.
+ *
+ * At graceful exit, flush() writes out the tail of the journal and returns a
+ * reference to store in the warm boot state instead of the switch state.
+ * replay() rebuilds the switch state from that reference on warm boot.
+ */
+class StateJournal {
+ public:
+  /*
+   * Start a new journal in dir, replacing any journal there, beginning with
+   * a snapshot of initialState.
+   */
+  StateJournal(
+      const std::string& dir,
+      std::shared_ptr<SwitchState> initialState);
+  ~StateJournal();
+
+  /*
+   * Queue a newly applied state to be journaled. This only takes a reference
+   * to the state, serialization happens on the journal thread.
+   */
+  void append(std::shared_ptr<SwitchState> state);
+
+  /*
+   * Journal state, if it isn't already, and wait for the journal to reach the
+   * disk. Returns the reference to pass to replay(), or nullopt if the
+   * journal could not be written.
+   */
+  std::optional<folly::dynamic> flush(std::shared_ptr<SwitchState> state);
+
+  /*
+   * Rebuild the serialized state that flush() returned journalRef for, from
+   * the journal in dir. Throws if the journal doesn't hold that state.
+   */
+  static folly::dynamic replay(
+      const std::string& dir,
+      const folly::dynamic& journalRef);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  StateJournal(StateJournal const&) = delete;
+  StateJournal& operator=(StateJournal const&) = delete;
+
+  void threadMain();
+  void writeRecord(const std::shared_ptr<SwitchState>& state);
+  void writeSnapshot(const std::shared_ptr<SwitchState>& state);
+
+  const std::string path_;
+  const uint64_t journalId_;
+  folly::File file_;
+  // Only accessed by the journal thread
+  std::shared_ptr<SwitchState> lastJournaled_;
+  uint64_t sequence_{0};
+  uint64_t snapshotBytes_{0};
+  uint64_t deltaBytesSinceSnapshot_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::shared_ptr<SwitchState> pending_;
+  // Number of states queued so far, and how many of them have been written
+  // or failed to be written
+  uint64_t queued_{0};
+  uint64_t written_{0};
+  uint64_t failed_{0};
+  uint64_t writtenSequence_{0};
+  bool syncRequested_{false};
+  bool stop_{false};
+
+  std::thread thread_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,406 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateMemoryAccountant.h"
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/AggregatePortMap.h"
+#include "fboss/agent/state/ArpResponseTable.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/ForwardingInformationBase.h"
+#include "fboss/agent/state/ForwardingInformationBaseContainer.h"
+#include "fboss/agent/state/ForwardingInformationBaseMap.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/LabelForwardingInformationBase.h"
+#include "fboss/agent/state/LoadBalancerMap.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/MirrorMap.h"
+#include "fboss/agent/state/NdpResponseTable.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/NodeMapDelta.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/QosPolicyMap.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/SflowCollectorMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include "fboss/agent/state/NodeMapDelta-defs.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/logging/xlog.h>
+
+namespace {
+// Roughly what a shared_ptr control block of make_shared takes besides the
+// object itself
+constexpr uint64_t kControlBlockBytes = 16;
+// Previously accounted states to check for being retained
+constexpr size_t kMaxAccountedStates = 32;
+
+template <typename NodeT>
+uint64_t extraNodeBytes(const NodeT& /*node*/) {
+  return 0;
+}
+
+template <typename AddrT>
+uint64_t extraNodeBytes(const facebook::fboss::Route<AddrT>& route) {
+  return route.getForwardInfo().getNextHopSet().size() *
+      sizeof(facebook::fboss::NextHop);
+}
+
+template <typename MapT>
+uint64_t nodeBytes(const typename MapT::Node& node) {
+  return sizeof(typename MapT::Node) + kControlBlockBytes +
+      sizeof(typename MapT::NodeContainer::value_type) + extraNodeBytes(node);
+}
+
+template <typename MapT>
+uint64_t mapBytes() {
+  return sizeof(MapT) + kControlBlockBytes;
+}
+
+/*
+ * Usage of a radix tree, counting all its nodes. valueBytes returns the
+ * bytes a value owns on top of those of its tree node.
+ */
+template <typename TreeT, typename ValueBytesFn>
+facebook::fboss::StateMemoryAccountant::MemoryUsage radixTreeUsage(
+    const TreeT& tree,
+    ValueBytesFn valueBytes) {
+  facebook::fboss::StateMemoryAccountant::MemoryUsage usage;
+  for (typename TreeT::ConstIterator it(tree.root(), true); !it.atEnd(); ++it) {
+    ++usage.nodes;
+    usage.bytes += sizeof(typename TreeT::TreeNode);
+    if (it->isValueNode()) {
+      usage.bytes += valueBytes(it->value());
+    }
+  }
+  return usage;
+}
+
+/*
+ * Usage of the value nodes of a RIB radix tree with numRoutes routes, which
+ * hold the routes themselves.
+ */
+template <typename NetworkToRouteMapT>
+facebook::fboss::StateMemoryAccountant::MemoryUsage ribUsage(
+    size_t numRoutes) {
+  facebook::fboss::StateMemoryAccountant::MemoryUsage usage;
+  usage.nodes = numRoutes;
+  usage.bytes = numRoutes * sizeof(typename NetworkToRouteMapT::TreeNode);
+  return usage;
+}
+
+std::string counterName(const std::string& name, folly::StringPiece suffix) {
+  return folly::to<std::string>("state_memory.", name, ".", suffix);
+}
+} // namespace
+
+namespace facebook::fboss {
+
+StateMemoryAccountant::StateMemoryAccountant(
+    SwSwitch* sw,
+    std::chrono::seconds interval)
+    : folly::AsyncTimeout(sw->getBackgroundEvb()),
+      sw_(sw),
+      interval_(interval) {}
+
+StateMemoryAccountant::~StateMemoryAccountant() {}
+
+void StateMemoryAccountant::start() {
+  sw_->getBackgroundEvb()->runInEventBaseThread(
+      [this] { this->timeoutExpired(); });
+}
+
+void StateMemoryAccountant::stop() {
+  sw_->getBackgroundEvb()->runInEventBaseThreadAndWait(
+      [this] { this->cancelTimeout(); });
+}
+
+void StateMemoryAccountant::timeoutExpired() noexcept {
+  try {
+    account(
+        sw_->getState(),
+        sw_->isStandaloneRibEnabled() ? sw_->getRib() : nullptr);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to account switch state memory. Error:"
+              << folly::exceptionStr(ex);
+  }
+  scheduleTimeout(interval_);
+}
+
+StateMemoryAccountant::Report StateMemoryAccountant::getReport() const {
+  return report_.copy();
+}
+
+void StateMemoryAccountant::account(
+    const std::shared_ptr<SwitchState>& state,
+    const rib::RoutingInformationBase* rib) {
+  usage_.clear();
+  mapUsage_.clear();
+  accountState(lastState_.get(), *state);
+  if (rib) {
+    accountRib(*rib);
+  }
+  lastMapUsage_.swap(mapUsage_);
+  mapUsage_.clear();
+  // Release the previous state before checking who else retains it
+  lastState_ = state;
+
+  Report report;
+  report.generation = state->getGeneration();
+  report.usage = usage_;
+  if (accountedStates_.empty() || accountedStates_.back().lock() != state) {
+    accountedStates_.push_back(state);
+  }
+  while (accountedStates_.size() > kMaxAccountedStates) {
+    accountedStates_.pop_front();
+  }
+  for (auto it = accountedStates_.begin(); it != accountedStates_.end();) {
+    auto accountedState = it->lock();
+    if (!accountedState) {
+      it = accountedStates_.erase(it);
+      continue;
+    }
+    if (accountedState != state) {
+      ++report.retainedGenerations;
+    }
+    ++it;
+  }
+  publishCounters(report);
+  *report_.wlock() = std::move(report);
+}
+
+template <typename MapT>
+void StateMemoryAccountant::accountNodeMap(
+    folly::StringPiece name,
+    const std::shared_ptr<MapT>& oldMap,
+    const std::shared_ptr<MapT>& newMap) {
+  if (!newMap) {
+    return;
+  }
+  MemoryUsage usage;
+  auto cached =
+      oldMap ? lastMapUsage_.find(oldMap.get()) : lastMapUsage_.end();
+  if (cached != lastMapUsage_.end()) {
+    // Start from the old map being entirely shared, and take out the nodes
+    // that changed
+    usage = cached->second;
+    usage.sharedBytes = usage.bytes;
+    if (oldMap != newMap) {
+      usage.sharedBytes -= mapBytes<MapT>();
+      for (const auto& delta :
+           NodeMapDelta<MapT>(oldMap.get(), newMap.get())) {
+        if (const auto& oldNode = delta.getOld()) {
+          auto bytes = nodeBytes<MapT>(*oldNode);
+          --usage.nodes;
+          usage.bytes -= bytes;
+          usage.sharedBytes -= bytes;
+        }
+        if (const auto& newNode = delta.getNew()) {
+          ++usage.nodes;
+          usage.bytes += nodeBytes<MapT>(*newNode);
+        }
+      }
+    }
+  } else {
+    usage.nodes = 1;
+    usage.bytes = mapBytes<MapT>();
+    for (const auto& node : *newMap) {
+      ++usage.nodes;
+      usage.bytes += nodeBytes<MapT>(*node);
+    }
+  }
+  mapUsage_[newMap.get()] = usage;
+  usage_[name.str()] += usage;
+}
+
+template <typename AddrT>
+void StateMemoryAccountant::accountRadixTree(
+    folly::StringPiece name,
+    const RouteTableRib<AddrT>* oldRib,
+    const RouteTableRib<AddrT>* newRib) {
+  if (!newRib) {
+    return;
+  }
+  MemoryUsage usage;
+  auto cached = oldRib == newRib ? lastMapUsage_.find(oldRib)
+                                 : lastMapUsage_.end();
+  if (cached != lastMapUsage_.end()) {
+    usage = cached->second;
+    usage.sharedBytes = usage.bytes;
+  } else {
+    // Routes are already accounted in the routes maps, the tree only
+    // points to them
+    usage = radixTreeUsage(
+        newRib->routesRadixTree(),
+        [](const std::shared_ptr<Route<AddrT>>& /*route*/) { return 0; });
+  }
+  mapUsage_[newRib] = usage;
+  usage_[name.str()] += usage;
+}
+
+void StateMemoryAccountant::accountState(
+    const SwitchState* oldState,
+    const SwitchState& newState) {
+  // Accounts the map getMap returns of newNode, against that of oldNode if
+  // there is one
+  auto accountChild = [this](
+                          folly::StringPiece name,
+                          const auto* oldNode,
+                          const auto& newNode,
+                          auto getMap) {
+    accountNodeMap(
+        name, oldNode ? getMap(*oldNode) : nullptr, getMap(newNode));
+  };
+
+  accountChild("ports", oldState, newState, [](const SwitchState& state) {
+    return state.getPorts();
+  });
+  accountChild(
+      "aggregate_ports", oldState, newState, [](const SwitchState& state) {
+        return state.getAggregatePorts();
+      });
+  accountChild("vlans", oldState, newState, [](const SwitchState& state) {
+    return state.getVlans();
+  });
+  accountChild("interfaces", oldState, newState, [](const SwitchState& state) {
+    return state.getInterfaces();
+  });
+  accountChild(
+      "route_tables", oldState, newState, [](const SwitchState& state) {
+        return state.getRouteTables();
+      });
+  accountChild("acls", oldState, newState, [](const SwitchState& state) {
+    return state.getAcls();
+  });
+  accountChild(
+      "sflow_collectors", oldState, newState, [](const SwitchState& state) {
+        return state.getSflowCollectors();
+      });
+  accountChild(
+      "qos_policies", oldState, newState, [](const SwitchState& state) {
+        return state.getQosPolicies();
+      });
+  accountChild(
+      "load_balancers", oldState, newState, [](const SwitchState& state) {
+        return state.getLoadBalancers();
+      });
+  accountChild("mirrors", oldState, newState, [](const SwitchState& state) {
+    return state.getMirrors();
+  });
+  accountChild("fibs", oldState, newState, [](const SwitchState& state) {
+    return state.getFibs();
+  });
+  accountChild("label_fib", oldState, newState, [](const SwitchState& state) {
+    return state.getLabelForwardingInformationBase();
+  });
+
+  const auto* oldVlans = oldState ? oldState->getVlans().get() : nullptr;
+  for (const auto& vlan : *newState.getVlans()) {
+    auto oldVlan = oldVlans ? oldVlans->getNodeIf(vlan->getID()) : nullptr;
+    accountChild("arp_tables", oldVlan.get(), *vlan, [](const Vlan& v) {
+      return v.getArpTable();
+    });
+    accountChild("ndp_tables", oldVlan.get(), *vlan, [](const Vlan& v) {
+      return v.getNdpTable();
+    });
+    accountChild(
+        "arp_response_tables", oldVlan.get(), *vlan, [](const Vlan& v) {
+          return v.getArpResponseTable();
+        });
+    accountChild(
+        "ndp_response_tables", oldVlan.get(), *vlan, [](const Vlan& v) {
+          return v.getNdpResponseTable();
+        });
+    accountChild("mac_tables", oldVlan.get(), *vlan, [](const Vlan& v) {
+      return v.getMacTable();
+    });
+  }
+
+  const auto* oldRouteTables =
+      oldState ? oldState->getRouteTables().get() : nullptr;
+  for (const auto& routeTable : *newState.getRouteTables()) {
+    auto oldRouteTable = oldRouteTables
+        ? oldRouteTables->getNodeIf(routeTable->getID())
+        : nullptr;
+    accountChild(
+        "routes_v4",
+        oldRouteTable.get(),
+        *routeTable,
+        [](const RouteTable& table) { return table.getRibV4()->routes(); });
+    accountChild(
+        "routes_v6",
+        oldRouteTable.get(),
+        *routeTable,
+        [](const RouteTable& table) { return table.getRibV6()->routes(); });
+    accountRadixTree(
+        "route_radix_trees_v4",
+        oldRouteTable ? oldRouteTable->getRibV4().get() : nullptr,
+        routeTable->getRibV4().get());
+    accountRadixTree(
+        "route_radix_trees_v6",
+        oldRouteTable ? oldRouteTable->getRibV6().get() : nullptr,
+        routeTable->getRibV6().get());
+  }
+
+  const auto* oldFibs = oldState ? oldState->getFibs().get() : nullptr;
+  for (const auto& fibs : *newState.getFibs()) {
+    auto oldContainer = oldFibs ? oldFibs->getNodeIf(fibs->getID()) : nullptr;
+    accountChild(
+        "fib_v4",
+        oldContainer.get(),
+        *fibs,
+        [](const ForwardingInformationBaseContainer& container) {
+          return container.getFibV4();
+        });
+    accountChild(
+        "fib_v6",
+        oldContainer.get(),
+        *fibs,
+        [](const ForwardingInformationBaseContainer& container) {
+          return container.getFibV6();
+        });
+  }
+}
+
+void StateMemoryAccountant::accountRib(
+    const rib::RoutingInformationBase& rib) {
+  // Walking the RIB would hold up route updates for as long as it takes,
+  // so it is estimated from the number of routes alone. RIB routes are
+  // updated in place, so nothing is shared between runs.
+  for (const auto& entry : rib.getRouteTableSizes()) {
+    usage_["rib_v4"] +=
+        ribUsage<rib::IPv4NetworkToRouteMap>(entry.second.first);
+    usage_["rib_v6"] +=
+        ribUsage<rib::IPv6NetworkToRouteMap>(entry.second.second);
+  }
+}
+
+void StateMemoryAccountant::publishCounters(const Report& report) const {
+  for (const auto& entry : report.usage) {
+    fb303::fbData->setCounter(
+        counterName(entry.first, "nodes"), entry.second.nodes);
+    fb303::fbData->setCounter(
+        counterName(entry.first, "bytes"), entry.second.bytes);
+    fb303::fbData->setCounter(
+        counterName(entry.first, "shared_bytes"), entry.second.sharedBytes);
+  }
+  fb303::fbData->setCounter(
+      "state_memory.retained_generations", report.retainedGenerations);
+}
+
+} // namespace facebook::fboss
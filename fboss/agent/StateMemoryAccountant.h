@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/io/async/AsyncTimeout.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class SwitchState;
+
+template <typename AddrT>
+class RouteTableRib;
+
+namespace rib {
+class RoutingInformationBase;
+}
+
+/*
+ * StateMemoryAccountant periodically estimates how much memory each kind of
+ * map in the SwitchState tree and in the standalone RIB takes up, on the
+ * background thread.
+ *
+ * A node is estimated at its size plus that of its shared_ptr control block
+ * and its map entry. Heap memory a node owns is not followed, except for the
+ * maps nested in it, the next hops of routes and the radix trees routes are
+ * indexed by.
+ *
+ * Each run is relative to the previous one: maps that are shared with the
+ * previously accounted state are not walked again, and maps that changed
+ * are only walked through their delta. This also gives the bytes each map
+ * shares with the previous state. The previously accounted state is kept
+ * alive for that until the next run, so up to one state more than the
+ * switch needs is held at any time. Radix trees are never shared, so they
+ * are walked whenever they change.
+ *
+ * The standalone RIB is not walked, as that would block route updates for
+ * the whole walk. Its usage is estimated from the number of routes of each
+ * VRF, at one radix tree node per route, without their next hops.
+ */
+class StateMemoryAccountant : private folly::AsyncTimeout {
+ public:
+  struct MemoryUsage {
+    uint64_t nodes{0};
+    uint64_t bytes{0};
+    // Bytes shared with the previously accounted state
+    uint64_t sharedBytes{0};
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+      nodes += other.nodes;
+      bytes += other.bytes;
+      sharedBytes += other.sharedBytes;
+      return *this;
+    }
+  };
+
+  struct Report {
+    uint32_t generation{0};
+    // Usage per kind of map, e.g. "arp_tables" or "rib_v4"
+    std::map<std::string, MemoryUsage> usage;
+    // Previously accounted states that are still held by someone, e.g. by
+    // an observer
+    uint32_t retainedGenerations{0};
+  };
+
+  StateMemoryAccountant(SwSwitch* sw, std::chrono::seconds interval);
+  ~StateMemoryAccountant() override;
+
+  /*
+   * Start and stop accounting the state of the switch every interval.
+   */
+  void start();
+  void stop();
+
+  /*
+   * Account state and rib, which may be null. Only called from one thread
+   * at a time.
+   */
+  void account(
+      const std::shared_ptr<SwitchState>& state,
+      const rib::RoutingInformationBase* rib);
+
+  /*
+   * The report of the last run. May be called from any thread.
+   */
+  Report getReport() const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  StateMemoryAccountant(StateMemoryAccountant const&) = delete;
+  StateMemoryAccountant& operator=(StateMemoryAccountant const&) = delete;
+
+  void timeoutExpired() noexcept override;
+
+  void accountState(const SwitchState* oldState, const SwitchState& newState);
+  template <typename MapT>
+  void accountNodeMap(
+      folly::StringPiece name,
+      const std::shared_ptr<MapT>& oldMap,
+      const std::shared_ptr<MapT>& newMap);
+  template <typename AddrT>
+  void accountRadixTree(
+      folly::StringPiece name,
+      const RouteTableRib<AddrT>* oldRib,
+      const RouteTableRib<AddrT>* newRib);
+  void accountRib(const rib::RoutingInformationBase& rib);
+  void publishCounters(const Report& report) const;
+
+  SwSwitch* sw_;
+  const std::chrono::seconds interval_;
+
+  // Only accessed by the accounting thread
+  std::shared_ptr<SwitchState> lastState_;
+  // Usage of each map and radix tree of the last accounted state, and of
+  // the current one while it is being accounted
+  folly::F14FastMap<const void*, MemoryUsage> lastMapUsage_;
+  folly::F14FastMap<const void*, MemoryUsage> mapUsage_;
+  std::map<std::string, MemoryUsage> usage_;
+  std::deque<std::weak_ptr<SwitchState>> accountedStates_;
+
+  folly::Synchronized<Report> report_;
+};
+
+} // namespace facebook::fboss
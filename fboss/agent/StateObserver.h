@@ -11,6 +11,9 @@
 
 #include <boost/core/noncopyable.hpp>
 
+#include <string>
+#include <vector>
+
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/StateDelta.h"
 
@@ -20,6 +23,24 @@ class StateObserver : public boost::noncopyable {
  public:
   virtual ~StateObserver() {}
   virtual void stateUpdated(const StateDelta& delta) = 0;
+
+  /*
+   * Whether stateUpdated() may be called off the update thread, while
+   * other observers are notified of the same delta. Only observers that
+   * read the delta, touch nothing but their own state and use thread safe
+   * SwSwitch APIs (e.g. updateState()) should return true.
+   */
+  virtual bool canRunConcurrently() const {
+    return false;
+  }
+
+  /*
+   * Names of the observers that must have processed a delta before this
+   * one is notified of it. Observers that are not registered are ignored.
+   */
+  virtual std::vector<std::string> getStateObserverDependencies() const {
+    return {};
+  }
 };
 
 class AutoRegisterStateObserver : public StateObserver {
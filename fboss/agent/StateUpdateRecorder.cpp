@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateUpdateRecorder.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Bits.h>
+#include <folly/Conv.h>
+
+#include <algorithm>
+#include <cctype>
+
+using std::chrono::microseconds;
+using std::chrono::system_clock;
+
+namespace {
+std::string histogramName(
+    const std::string& updateName,
+    folly::StringPiece suffix) {
+  std::string name = folly::to<std::string>("state_update.", updateName);
+  std::replace_if(
+      name.begin(),
+      name.end(),
+      [](char c) {
+        return !std::isalnum(static_cast<unsigned char>(c)) && c != '.' &&
+            c != '_';
+      },
+      '_');
+  return folly::to<std::string>(name, ".", suffix);
+}
+
+std::string addHistogram(
+    const std::string& updateName,
+    folly::StringPiece suffix) {
+  auto histogram = histogramName(updateName, suffix);
+  facebook::fb303::fbData->addHistogram(histogram, 1000, 0, 1000000);
+  facebook::fb303::fbData->exportHistogramPercentile(
+      histogram, 50, 95, 99, 100);
+  return histogram;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+StateUpdateRecorder::StateUpdateRecorder(size_t capacity)
+    : mask_(folly::nextPowTwo(std::max<size_t>(capacity, 1)) - 1),
+      slots_(std::make_unique<Slot[]>(mask_ + 1)),
+      hwProgrammingHistogram_(addHistogram("batch", "hw_programming.us")),
+      observersHistogram_(addHistogram("batch", "observers.us")) {
+  // Name id 0 collects the updates past kMaxNames names
+  addName(kOtherName.str());
+}
+
+StateUpdateRecorder::~StateUpdateRecorder() {}
+
+StateUpdateRecorder::NameId StateUpdateRecorder::getNameId(
+    const std::string& name) {
+  auto it = nameIds_.find(name);
+  if (it != nameIds_.end()) {
+    return it->second;
+  }
+  if (nameIds_.size() >= kMaxNames) {
+    return 0;
+  }
+  return addName(name);
+}
+
+StateUpdateRecorder::NameId StateUpdateRecorder::addName(
+    const std::string& name) {
+  auto histograms = std::make_unique<Histograms>();
+  histograms->name = name;
+  histograms->queueWait = addHistogram(name, "queue_wait.us");
+  histograms->apply = addHistogram(name, "apply.us");
+
+  folly::SpinLockGuard guard(namesLock_);
+  NameId id = names_.size();
+  names_.push_back(std::move(histograms));
+  nameIds_.emplace(name, id);
+  return id;
+}
+
+void StateUpdateRecorder::record(
+    const std::vector<UpdateTiming>& updates,
+    const BatchTiming& batch) {
+  if (updates.empty()) {
+    return;
+  }
+  auto finishedAt = std::chrono::duration_cast<microseconds>(
+                        system_clock::now().time_since_epoch())
+                        .count();
+  auto index = numRecords_.load(std::memory_order_relaxed);
+  for (const auto& update : updates) {
+    auto& slot = slots_[index & mask_];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(update.name, std::memory_order_relaxed);
+    std::array<int64_t, NUM_FIELDS> values{
+        finishedAt,
+        update.queueWait.count(),
+        update.apply.count(),
+        batch.hwProgramming.count(),
+        batch.observers.count(),
+        static_cast<int64_t>(batch.deltaSize),
+        static_cast<int64_t>(updates.size())};
+    for (size_t i = 0; i < NUM_FIELDS; ++i) {
+      slot.fields[i].store(values[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    ++index;
+
+    // Only the update thread appends to names_, so no need to lock it here
+    const auto& histograms = *names_[update.name];
+    fb303::fbData->addHistogramValue(
+        histograms.queueWait, update.queueWait.count());
+    fb303::fbData->addHistogramValue(histograms.apply, update.apply.count());
+  }
+  numRecords_.store(index, std::memory_order_release);
+
+  // Hw programming and observers ran once for the whole batch
+  fb303::fbData->addHistogramValue(
+      hwProgrammingHistogram_, batch.hwProgramming.count());
+  fb303::fbData->addHistogramValue(
+      observersHistogram_, batch.observers.count());
+}
+
+std::vector<StateUpdateRecorder::Record> StateUpdateRecorder::getRecords(
+    size_t maxRecords) const {
+  auto numRecords = numRecords_.load(std::memory_order_acquire);
+  auto numToRead = std::min<uint64_t>(
+      std::min<uint64_t>(numRecords, mask_ + 1), maxRecords);
+
+  std::vector<std::pair<NameId, std::array<int64_t, NUM_FIELDS>>> copied;
+  copied.reserve(numToRead);
+  for (uint64_t index = numRecords; index > numRecords - numToRead; --index) {
+    const auto& slot = slots_[(index - 1) & mask_];
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index) {
+      // The writer has wrapped around and moved on to a newer record, and
+      // so will have for all older ones too
+      break;
+    }
+    std::pair<NameId, std::array<int64_t, NUM_FIELDS>> values;
+    values.first = slot.name.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < NUM_FIELDS; ++i) {
+      values.second[i] = slot.fields[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      break;
+    }
+    copied.push_back(values);
+  }
+
+  std::vector<Record> records;
+  records.reserve(copied.size());
+  folly::SpinLockGuard guard(namesLock_);
+  for (const auto& values : copied) {
+    const auto& fields = values.second;
+    records.push_back(Record{
+        names_[values.first]->name,
+        system_clock::time_point(microseconds(fields[FINISHED_AT])),
+        microseconds(fields[QUEUE_WAIT]),
+        microseconds(fields[APPLY]),
+        microseconds(fields[HW_PROGRAMMING]),
+        microseconds(fields[OBSERVERS]),
+        static_cast<uint64_t>(fields[DELTA_SIZE]),
+        static_cast<uint32_t>(fields[BATCH_SIZE])});
+  }
+  return records;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/SpinLock.h>
+#include <folly/container/F14Map.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * StateUpdateRecorder is a flight recorder for the update thread. For every
+ * StateUpdate it keeps how long the update waited in its queue and took to
+ * apply, and how long hw programming and observers took for the batch it
+ * was coalesced into, along with the size of that batch's delta.
+ *
+ * The last records are kept in a fixed size ring buffer. The update thread
+ * is the only writer and never blocks on readers: each slot is guarded by a
+ * sequence number, and readers drop slots that were overwritten while they
+ * were being copied. The timings are also exported as fb303 histograms:
+ * queue wait and apply time per update name, hw programming and observer
+ * time once per batch.
+ */
+class StateUpdateRecorder {
+ public:
+  using NameId = uint32_t;
+
+  struct UpdateTiming {
+    NameId name;
+    std::chrono::microseconds queueWait;
+    std::chrono::microseconds apply;
+  };
+
+  struct BatchTiming {
+    std::chrono::microseconds hwProgramming{0};
+    std::chrono::microseconds observers{0};
+    // Route and neighbor changes in the delta, 0 if they were not computed
+    uint64_t deltaSize{0};
+  };
+
+  struct Record {
+    std::string name;
+    // When the batch of the update finished
+    std::chrono::system_clock::time_point finishedAt;
+    std::chrono::microseconds queueWait;
+    std::chrono::microseconds apply;
+    std::chrono::microseconds hwProgramming;
+    std::chrono::microseconds observers;
+    uint64_t deltaSize;
+    uint32_t batchSize;
+  };
+
+  /*
+   * Keep the last capacity records, rounded up to a power of two.
+   */
+  explicit StateUpdateRecorder(size_t capacity);
+  ~StateUpdateRecorder();
+
+  /*
+   * Returns the id to record updates named name under. Only called from the
+   * update thread.
+   */
+  NameId getNameId(const std::string& name);
+
+  /*
+   * Record the updates of a batch. Only called from the update thread.
+   */
+  void record(
+      const std::vector<UpdateTiming>& updates,
+      const BatchTiming& batch);
+
+  /*
+   * Returns up to maxRecords of the last records, newest first. May be
+   * called from any thread.
+   */
+  std::vector<Record> getRecords(size_t maxRecords) const;
+
+  // Updates beyond this many distinct names are recorded as kOtherName
+  static constexpr size_t kMaxNames = 256;
+  static constexpr folly::StringPiece kOtherName{"other"};
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  StateUpdateRecorder(StateUpdateRecorder const&) = delete;
+  StateUpdateRecorder& operator=(StateUpdateRecorder const&) = delete;
+
+  enum Field {
+    FINISHED_AT,
+    QUEUE_WAIT,
+    APPLY,
+    HW_PROGRAMMING,
+    OBSERVERS,
+    DELTA_SIZE,
+    BATCH_SIZE,
+    NUM_FIELDS,
+  };
+
+  struct Slot {
+    // 2 * (index + 1) once record index is written to the slot, odd while
+    // a record is being written
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<NameId> name{0};
+    std::array<std::atomic<int64_t>, NUM_FIELDS> fields{};
+  };
+
+  struct Histograms {
+    std::string name;
+    std::string queueWait;
+    std::string apply;
+  };
+
+  NameId addName(const std::string& name);
+
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  const std::string hwProgrammingHistogram_;
+  const std::string observersHistogram_;
+  // Number of records written so far
+  std::atomic<uint64_t> numRecords_{0};
+
+  // Only accessed from the update thread
+  folly::F14FastMap<std::string, NameId> nameIds_;
+  // Appended to by the update thread, read by readers to resolve names
+  mutable folly::SpinLock namesLock_;
+  std::vector<std::unique_ptr<Histograms>> names_;
+};
+
+} // namespace facebook::fboss
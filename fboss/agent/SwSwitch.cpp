@@ -18,6 +18,7 @@
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/IPv4Handler.h"
 #include "fboss/agent/IPv6Handler.h"
+#include "fboss/agent/IcmpErrorRateLimiter.h"
 #include "fboss/agent/L2Entry.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LinkAggregationManager.h"
@@ -34,6 +35,10 @@
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/StateChangePublisher.h"
+#include "fboss/agent/StateJournal.h"
+#include "fboss/agent/StateMemoryAccountant.h"
+#include "fboss/agent/StateUpdateRecorder.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TunManager.h"
@@ -48,6 +53,7 @@
 #include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 #include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
@@ -59,6 +65,8 @@
 #include <folly/MapUtil.h>
 #include <folly/SocketAddress.h>
 #include <folly/String.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
 #include <glog/logging.h>
@@ -67,9 +75,12 @@
 #include <thrift/lib/cpp2/async/RequestChannel.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <exception>
+#include <iterator>
+#include <optional>
 #include <tuple>
 
 using folly::EventBase;
@@ -93,6 +104,46 @@ using namespace apache::thrift::transport;
 using namespace apache::thrift::protocol;
 
 DEFINE_int32(thread_heartbeat_ms, 1000, "Thread heartbeat interval (ms)");
+DEFINE_int32(
+    state_observer_threads,
+    4,
+    "Number of threads to notify concurrent state observers on, 0 notifies "
+    "all state observers on the update thread");
+DEFINE_int32(
+    state_update_max_lane_skips,
+    8,
+    "Max number of batches pending lower priority state updates may be "
+    "passed over in favor of higher priority ones");
+DEFINE_bool(
+    neighbor_hit_bulk_scan,
+    true,
+    "Check stale neighbor entries against one bulk scan of HW hit bits per "
+    "stale entry interval, instead of querying HW once per entry");
+DEFINE_bool(
+    state_journal,
+    false,
+    "Journal applied switch states to the warm boot dir in the background, "
+    "so graceful exit only needs to flush the tail of the journal");
+DEFINE_bool(
+    state_update_pipeline,
+    false,
+    "Program state deltas to hw on a dedicated thread, so the update thread "
+    "can compute the next batch of state updates meanwhile. With this on, "
+    "getState() returns a state before hw has applied it, and update "
+    "functions must build on the state they are passed rather than call "
+    "getState()");
+DEFINE_int32(
+    state_update_recorder_size,
+    1024,
+    "Number of state updates to keep timings of in the update thread flight "
+    "recorder, 0 disables it");
+DEFINE_int32(
+    state_memory_accounting_interval_s,
+    0,
+    "Interval at which the memory taken by the switch state and the RIB is "
+    "accounted per map type in the background, 0 (the default) disables "
+    "it. The last accounted switch state is kept alive until the next run, "
+    "so enabling this may hold one extra switch state in memory");
 DEFINE_int32(
     distribution_timeout_ms,
     1000,
@@ -100,6 +151,16 @@ DEFINE_int32(
 
 namespace {
 
+constexpr auto kNeighborHitScans = "neighbor_hit.scans";
+
+std::string stateUpdateLaneCounter(size_t lane, folly::StringPiece suffix) {
+  return folly::to<std::string>(
+      "state_update.",
+      StateUpdate::getPriorityName(static_cast<StateUpdate::Priority>(lane)),
+      ".",
+      suffix);
+}
+
 /**
  * Transforms the IPAddressV6 to MacAddress. RFC 2464
  * 33:33:xx:xx:xx:xx (lower 32 bits are copied from addr)
@@ -157,11 +218,28 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       rib_(new rib::RoutingInformationBase()),
       portUpdateHandler_(new PortUpdateHandler(this)),
       lookupClassUpdater_(new LookupClassUpdater(this)),
-      macTableManager_(new MacTableManager(this)) {
+      macTableManager_(new MacTableManager(this)),
+      stateChangePublisher_(new StateChangePublisher(this)),
+      icmpErrorRateLimiter_(new IcmpErrorRateLimiter()) {
   // Create the platform-specific state directories if they
   // don't exist already.
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+
+  if (FLAGS_state_observer_threads > 0) {
+    stateObserverExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_state_observer_threads,
+        std::make_shared<folly::NamedThreadFactory>("StateObserver"));
+  }
+  for (size_t lane = 0; lane < StateUpdate::kNumPriorities; ++lane) {
+    auto histogram = stateUpdateLaneCounter(lane, "wait_time.us");
+    fb303::fbData->addHistogram(histogram, 10000, 0, 1000000);
+    fb303::fbData->exportHistogramPercentile(histogram, 50, 95, 99, 100);
+  }
+  if (FLAGS_state_update_recorder_size > 0) {
+    stateUpdateRecorder_ =
+        std::make_unique<StateUpdateRecorder>(FLAGS_state_update_recorder_size);
+  }
 }
 
 SwSwitch::~SwSwitch() {
@@ -202,6 +280,10 @@ void SwSwitch::stop() {
     lldpManager_->stop();
   }
 
+  if (stateMemoryAccountant_) {
+    stateMemoryAccountant_->stop();
+  }
+
   if (lagManager_) {
     lagManager_.reset();
   }
@@ -301,10 +383,19 @@ void SwSwitch::gracefulExit() {
     // file. Right now we just serialize applied state and
     // then rely on a route/FIB sync on warm boot to recover
     // desired state.
-    switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
+    std::optional<folly::dynamic> journalRef;
+    if (stateJournal_) {
+      journalRef = stateJournal_->flush(getAppliedState());
+    }
+    if (journalRef) {
+      switchState[kStateJournal] = std::move(*journalRef);
+    } else {
+      switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
+    }
 
     steady_clock::time_point switchStateToFollyDone = steady_clock::now();
     XLOG(INFO) << "[Exit] Switch state to folly dynamic "
+               << (journalRef ? "(journal flush) " : "")
                << duration_cast<duration<float>>(
                       switchStateToFollyDone - stopThreadsAndHandlersDone)
                       .count();
@@ -323,6 +414,7 @@ void SwSwitch::getProductInfo(ProductInfo& productInfo) const {
 void SwSwitch::updateStats() {
   updateRouteStats();
   updatePortInfo();
+  updateLinkFlapStats();
   try {
     getHw()->updateStats(stats());
   } catch (const std::exception& ex) {
@@ -331,6 +423,12 @@ void SwSwitch::updateStats() {
   }
 }
 
+void SwSwitch::updateLinkFlapStats() {
+  auto minMax = linkStateChanges_.getMinMax();
+  fb303::fbData->setCounter(
+      "link_state.flaps.600", minMax ? minMax->second - minMax->first : 0);
+}
+
 void SwSwitch::registerNeighborListener(
     std::function<void(
         const std::vector<std::string>& added,
@@ -353,6 +451,32 @@ bool SwSwitch::getAndClearNeighborHit(RouterID vrf, folly::IPAddress ip) {
   return hw_->getAndClearNeighborHit(vrf, ip);
 }
 
+bool SwSwitch::getAndClearNeighborHitFromScan(
+    RouterID vrf,
+    folly::IPAddress ip,
+    std::chrono::milliseconds maxScanAge) {
+  if (!FLAGS_neighbor_hit_bulk_scan) {
+    return getAndClearNeighborHit(vrf, ip);
+  }
+  std::lock_guard<std::mutex> g(neighborHitScansMutex_);
+  auto now = steady_clock::now();
+  auto iter = neighborHitScans_.find(vrf);
+  if (iter == neighborHitScans_.end() ||
+      now - iter->second.scannedAt >= maxScanAge) {
+    auto hits = hw_->getAndClearNeighborHits(vrf);
+    if (!hits) {
+      return getAndClearNeighborHit(vrf, ip);
+    }
+    fb303::fbData->addStatValue(kNeighborHitScans, 1, fb303::SUM);
+    iter = neighborHitScans_.try_emplace(vrf).first;
+    iter->second.scannedAt = now;
+    iter->second.hits = std::unordered_set<folly::IPAddress>(
+        std::make_move_iterator(hits->begin()),
+        std::make_move_iterator(hits->end()));
+  }
+  return iter->second.hits.erase(ip) > 0;
+}
+
 void SwSwitch::exitFatal() const noexcept {
   folly::dynamic switchState = folly::dynamic::object;
   switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
@@ -407,6 +531,11 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   initialStateDesired->publish();
   setStateInternal(initialState, initialStateDesired);
 
+  if (FLAGS_state_journal && !platform_->getWarmBootDir().empty()) {
+    stateJournal_ = std::make_unique<StateJournal>(
+        platform_->getWarmBootDir(), initialState);
+  }
+
   if (flags & SwitchFlags::ENABLE_TUN) {
     if (tunMgr) {
       tunMgr_ = std::move(tunMgr);
@@ -457,6 +586,11 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
     lldpManager_ = std::make_unique<LldpManager>(this);
   }
 
+  if (FLAGS_state_memory_accounting_interval_s > 0) {
+    stateMemoryAccountant_ = std::make_unique<StateMemoryAccountant>(
+        this, std::chrono::seconds(FLAGS_state_memory_accounting_interval_s));
+  }
+
   if (flags & SwitchFlags::ENABLE_LACP) {
     lagManager_ = std::make_unique<LinkAggregationManager>(this);
   }
@@ -542,6 +676,10 @@ void SwSwitch::initialConfigApplied(const steady_clock::time_point& startTime) {
     lldpManager_->start();
   }
 
+  if (stateMemoryAccountant_) {
+    stateMemoryAccountant_->start();
+  }
+
   if (flags_ & SwitchFlags::PUBLISH_STATS) {
     publishInitTimes(
         "fboss.agent.switch_configured",
@@ -600,6 +738,51 @@ void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
     throw FbossError("State observer add failed: ", name, " already exists");
   }
   stateObservers_.emplace(observer, name);
+  auto histogram = folly::to<string>("state_observers.", name, ".us");
+  fb303::fbData->addHistogram(histogram, 100, 0, 10000);
+  fb303::fbData->exportHistogramPercentile(histogram, 50, 95, 99, 100);
+}
+
+std::vector<std::vector<StateObserver*>> SwSwitch::getStateObserverLevels()
+    const {
+  std::map<std::string, StateObserver*> observersByName;
+  for (const auto& observerName : stateObservers_) {
+    observersByName.emplace(observerName.second, observerName.first);
+  }
+
+  // Level of an observer is one more than the highest level among its
+  // dependencies. Observers being visited are marked with -1.
+  std::map<StateObserver*, int> levels;
+  std::function<int(StateObserver*)> getLevel = [&](StateObserver* observer) {
+    auto iter = levels.find(observer);
+    if (iter != levels.end()) {
+      if (iter->second < 0) {
+        XLOG(FATAL) << "State observer dependency cycle through "
+                    << stateObservers_.at(observer);
+      }
+      return iter->second;
+    }
+    levels[observer] = -1;
+    int level = 0;
+    for (const auto& dependency : observer->getStateObserverDependencies()) {
+      auto depIter = observersByName.find(dependency);
+      if (depIter != observersByName.end()) {
+        level = std::max(level, getLevel(depIter->second) + 1);
+      }
+    }
+    levels[observer] = level;
+    return level;
+  };
+
+  std::vector<std::vector<StateObserver*>> observerLevels;
+  for (const auto& observerName : stateObservers_) {
+    auto level = getLevel(observerName.first);
+    if (observerLevels.size() <= static_cast<size_t>(level)) {
+      observerLevels.resize(level + 1);
+    }
+    observerLevels[level].push_back(observerName.first);
+  }
+  return observerLevels;
 }
 
 void SwSwitch::notifyStateObservers(const StateDelta& delta) {
@@ -608,22 +791,65 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
     // Make sure the SwSwitch is not already being destroyed
     return;
   }
-  for (auto observerName : stateObservers_) {
-    try {
-      auto observer = observerName.first;
-      observer->stateUpdated(delta);
-    } catch (const std::exception& ex) {
-      // TODO: Figure out the best way to handle errors here.
-      XLOG(FATAL) << "error notifying " << observerName.second
-                  << " of update: " << folly::exceptionStr(ex);
+  // Build the change log shared by observers up front, so that its cost
+  // is not charged to whichever observer happens to look at it first.
+  auto start = steady_clock::now();
+  delta.getChangeLog();
+  fb303::fbData->addStatValue(
+      "state_observers.change_log.us",
+      duration_cast<microseconds>(steady_clock::now() - start).count(),
+      fb303::AVG);
+
+  // Concurrent observers run on the observer pool and refer to their names
+  // until their level is done. stateObservers_ is only safe to use from this
+  // thread, so hand them names from a snapshot instead.
+  auto observerNames = stateObservers_;
+  for (const auto& level : getStateObserverLevels()) {
+    std::vector<folly::Future<folly::Unit>> concurrentObservers;
+    std::vector<StateObserver*> serialObservers;
+    for (auto observer : level) {
+      if (stateObserverExecutor_ && observer->canRunConcurrently()) {
+        concurrentObservers.push_back(
+            folly::via(
+                stateObserverExecutor_.get(),
+                [this, observer, &name = observerNames[observer], &delta]() {
+                  notifyStateObserver(observer, name, delta);
+                }));
+      } else {
+        serialObservers.push_back(observer);
+      }
+    }
+    for (auto observer : serialObservers) {
+      notifyStateObserver(observer, observerNames[observer], delta);
     }
+    folly::collectAll(concurrentObservers).wait();
   }
 }
 
+void SwSwitch::notifyStateObserver(
+    StateObserver* observer,
+    const std::string& name,
+    const StateDelta& delta) {
+  auto start = steady_clock::now();
+  try {
+    observer->stateUpdated(delta);
+  } catch (const std::exception& ex) {
+    // TODO: Figure out the best way to handle errors here.
+    XLOG(FATAL) << "error notifying " << name
+                << " of update: " << folly::exceptionStr(ex);
+  }
+  fb303::fbData->addHistogramValue(
+      folly::to<string>("state_observers.", name, ".us"),
+      duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
 void SwSwitch::updateState(unique_ptr<StateUpdate> update) {
+  auto lane = static_cast<size_t>(update->getPriority());
+  update->queuedAt_ = steady_clock::now();
   {
     folly::SpinLockGuard guard(pendingUpdatesLock_);
-    pendingUpdates_.push_back(*update.release());
+    pendingUpdates_[lane].push_back(*update.release());
+    ++pendingUpdateCounts_[lane];
   }
 
   // Signal the update thread that updates are pending.
@@ -635,14 +861,16 @@ void SwSwitch::updateState(unique_ptr<StateUpdate> update) {
 void SwSwitch::queueStateUpdateForGettingHwInSync(
     StringPiece name,
     StateUpdateFn fn) {
-  auto update = make_unique<FunctionStateUpdate>(name, std::move(fn));
+  auto update = make_unique<FunctionStateUpdate>(
+      name, std::move(fn), true, StateUpdate::Priority::HIGH);
+  update->queuedAt_ = steady_clock::now();
   {
-    // Push the state update in front to preserver ordering.
-    // This is not particularly necessary, since this state
-    // update is freely coalesced with other state updates when
-    // we come to processing pending updates
+    // Keep the state update aside so that it is applied first in the next
+    // batch, whichever lane that batch comes from. It returns the desired
+    // state as of the failed batch, so any update applied before it would
+    // be overwritten.
     folly::SpinLockGuard guard(pendingUpdatesLock_);
-    pendingUpdates_.push_front(*update.release());
+    hwSyncUpdates_.push_front(*update.release());
   }
   // Don't inform updateEventBase about this update being queued.
   // Rather let this update be processed with the next incoming update.
@@ -657,19 +885,31 @@ void SwSwitch::queueStateUpdateForGettingHwInSync(
   // optimizations).
 }
 
-void SwSwitch::updateState(StringPiece name, StateUpdateFn fn) {
-  auto update = make_unique<FunctionStateUpdate>(name, std::move(fn));
+void SwSwitch::updateState(
+    StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
+  auto update =
+      make_unique<FunctionStateUpdate>(name, std::move(fn), true, priority);
   updateState(std::move(update));
 }
 
-void SwSwitch::updateStateNoCoalescing(StringPiece name, StateUpdateFn fn) {
-  auto update = make_unique<FunctionStateUpdate>(name, std::move(fn), false);
+void SwSwitch::updateStateNoCoalescing(
+    StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
+  auto update =
+      make_unique<FunctionStateUpdate>(name, std::move(fn), false, priority);
   updateState(std::move(update));
 }
 
-void SwSwitch::updateStateBlocking(folly::StringPiece name, StateUpdateFn fn) {
+void SwSwitch::updateStateBlocking(
+    folly::StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
   auto result = std::make_shared<BlockingUpdateResult>();
-  auto update = make_unique<BlockingStateUpdate>(name, std::move(fn), result);
+  auto update = make_unique<BlockingStateUpdate>(
+      name, std::move(fn), result, true, priority);
   updateState(std::move(update));
   result->wait();
 }
@@ -678,30 +918,65 @@ void SwSwitch::handlePendingUpdatesHelper(SwSwitch* sw) {
   sw->handlePendingUpdates();
 }
 
+std::optional<size_t> SwSwitch::pickPendingUpdateLaneLocked() {
+  std::optional<size_t> lane;
+  for (size_t i = 0; i < pendingUpdates_.size(); ++i) {
+    if (pendingUpdates_[i].empty()) {
+      continue;
+    }
+    if (!lane) {
+      lane = i;
+    } else if (skippedBatches_[i] >=
+               static_cast<uint32_t>(
+                   std::max(FLAGS_state_update_max_lane_skips, 0))) {
+      // Don't let a steady stream of higher priority updates starve us
+      lane = i;
+      break;
+    }
+  }
+  for (size_t i = 0; i < pendingUpdates_.size(); ++i) {
+    if (lane && i == *lane) {
+      skippedBatches_[i] = 0;
+    } else if (!pendingUpdates_[i].empty()) {
+      ++skippedBatches_[i];
+    }
+  }
+  return lane;
+}
+
 void SwSwitch::handlePendingUpdates() {
   // Get the list of updates to run.
   //
-  // We might pull multiple updates off the list at once if several updates
+  // We might pull multiple updates off a lane at once if several updates
   // were scheduled before we had a chance to process them.  In some cases we
   // might also end up finding 0 updates to process if a previous
   // handlePendingUpdates() call processed multiple updates.
   StateUpdateList updates;
+  std::optional<size_t> lane;
+  std::array<size_t, StateUpdate::kNumPriorities> queueDepths;
   {
     folly::SpinLockGuard guard(pendingUpdatesLock_);
-    // When deciding how many elements to pull off the pendingUpdates_
-    // list, we pull as many as we can, while making sure we don't
-    // include any updates after an update that does not allow
-    // coalescing.
-    auto iter = pendingUpdates_.begin();
-    while (iter != pendingUpdates_.end()) {
-      StateUpdate* update = &(*iter);
-      ++iter;
-      if (!update->allowsCoalescing()) {
-        break;
+    lane = pickPendingUpdateLaneLocked();
+    if (lane) {
+      // When deciding how many elements to pull off the lane, we pull as
+      // many as we can, while making sure we don't include any updates
+      // after an update that does not allow coalescing.
+      auto& pending = pendingUpdates_[*lane];
+      size_t numUpdates = 0;
+      auto iter = pending.begin();
+      while (iter != pending.end()) {
+        StateUpdate* update = &(*iter);
+        ++iter;
+        ++numUpdates;
+        if (!update->allowsCoalescing()) {
+          break;
+        }
       }
+      updates.splice(updates.begin(), pending, pending.begin(), iter);
+      pendingUpdateCounts_[*lane] -= numUpdates;
+      updates.splice(updates.begin(), hwSyncUpdates_);
     }
-    updates.splice(
-        updates.begin(), pendingUpdates_, pendingUpdates_.begin(), iter);
+    queueDepths = pendingUpdateCounts_;
   }
 
   // handlePendingUpdates() is invoked once for each update, but a previous
@@ -711,6 +986,18 @@ void SwSwitch::handlePendingUpdates() {
     return;
   }
 
+  auto dequeuedAt = steady_clock::now();
+  for (const auto& update : updates) {
+    fb303::fbData->addHistogramValue(
+        stateUpdateLaneCounter(
+            static_cast<size_t>(update.getPriority()), "wait_time.us"),
+        duration_cast<microseconds>(dequeuedAt - update.queuedAt_).count());
+  }
+  for (size_t i = 0; i < queueDepths.size(); ++i) {
+    fb303::fbData->setCounter(
+        stateUpdateLaneCounter(i, "queue_depth"), queueDepths[i]);
+  }
+
   // This function should never be called with valid updates while we are
   // not initialized yet
   DCHECK(isInitialized());
@@ -724,7 +1011,13 @@ void SwSwitch::handlePendingUpdates() {
   // oldDesiredState. This is the one we always enqueue at the front of the
   // queue whenever applied and desired states diverge. After that, other
   // supplied state updates are applied (that were spliced above).
-  auto newDesiredState = oldAppliedState;
+  //
+  // If the previous batch is still being programmed to hw, we build on the
+  // state it is programming instead, see pipelineStateUpdate().
+  auto baseState =
+      inFlightUpdate_ ? inFlightUpdate_->newState : oldAppliedState;
+  auto newDesiredState = baseState;
+  std::vector<StateUpdateRecorder::UpdateTiming> timings;
   auto iter = updates.begin();
   while (iter != updates.end()) {
     StateUpdate* update = &(*iter);
@@ -732,14 +1025,26 @@ void SwSwitch::handlePendingUpdates() {
 
     shared_ptr<SwitchState> intermediateState;
     XLOG(INFO) << "preparing state update " << update->getName();
+    auto applyStart = steady_clock::now();
+    auto recordTiming = [&]() {
+      if (stateUpdateRecorder_) {
+        timings.push_back(StateUpdateRecorder::UpdateTiming{
+            stateUpdateRecorder_->getNameId(update->getName()),
+            duration_cast<microseconds>(dequeuedAt - update->queuedAt_),
+            duration_cast<microseconds>(steady_clock::now() - applyStart)});
+      }
+    };
     try {
       intermediateState = update->applyUpdate(newDesiredState);
+      recordTiming();
     } catch (const std::exception& ex) {
+      recordTiming();
       // Call the update's onError() function, and then immediately delete
       // it (therefore removing it from the intrusive list).  This way we won't
       // call it's onSuccess() function later.
       update->onError(ex);
       delete update;
+      continue;
     }
     // We have applied the update to software switch state, so call success
     // on the update.
@@ -754,36 +1059,149 @@ void SwSwitch::handlePendingUpdates() {
     }
   }
 
+  if (FLAGS_state_update_pipeline) {
+    pipelineStateUpdate(
+        std::move(newDesiredState), &updates, std::move(timings));
+    return;
+  }
+
   // Now apply the update and notify subscribers
+  StateUpdateRecorder::BatchTiming batchTiming;
   if (newDesiredState != oldAppliedState) {
     // There was some change during these state updates
-    auto newAppliedState = applyUpdate(oldAppliedState, newDesiredState);
+    auto newAppliedState =
+        applyUpdate(oldAppliedState, newDesiredState, &batchTiming);
     // Stick the initial applied->desired in the beginning
     bool newOutOfSync = (newAppliedState != newDesiredState);
     fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
     if (newOutOfSync) {
-      // If we could not apply the whole delta successfully, put the difference
-      // as a state update at the beginning
-      queueStateUpdateForGettingHwInSync(
-          "state update for failed hardware application",
-          [newDesiredState,
-           newAppliedState](const std::shared_ptr<SwitchState>& /*oldState*/) {
-            // clone the newDesiredState and then inheritGeneration from
-            // newAppliedState otherwise the return state has a smaller gen#
-            // than the one of appliedState
-            auto hwOutOfSyncState = newDesiredState->clone();
-            hwOutOfSyncState->inheritGeneration(*newAppliedState);
-            return hwOutOfSyncState;
-          });
+      queueHwOutOfSyncUpdate(newAppliedState, newDesiredState);
+    }
+  }
+
+  recordStateUpdates(timings, batchTiming);
+  notifyStateUpdatesSuccess(&updates);
+}
+
+void SwSwitch::pipelineStateUpdate(
+    std::shared_ptr<SwitchState> newDesiredState,
+    StateUpdateList* updates,
+    std::vector<StateUpdateRecorder::UpdateTiming> timings) {
+  // The batch was computed on top of the delta in flight, if any, so that
+  // delta has to be applied before we can program ours
+  if (inFlightUpdate_) {
+    finishInFlightUpdate(false /* lastInPipeline */);
+  }
+  auto oldAppliedState = getAppliedState();
+  if (newDesiredState == oldAppliedState) {
+    recordStateUpdates(timings, StateUpdateRecorder::BatchTiming());
+    notifyStateUpdatesSuccess(updates);
+    return;
+  }
+  if (newDesiredState->getGeneration() <= oldAppliedState->getGeneration()) {
+    // The delta in flight was only partly applied, and the state hw returned
+    // for it is as new as ours. Our delta carries what it failed to apply,
+    // so we just need to move the generation past it, like a state update
+    // for failed hw application would.
+    newDesiredState = newDesiredState->clone();
+    newDesiredState->inheritGeneration(*oldAppliedState);
+    newDesiredState->publish();
+  }
+  XLOG(INFO) << "Programming state: old_gen="
+             << oldAppliedState->getGeneration()
+             << " new_gen=" << newDesiredState->getGeneration();
+
+  // The desired state moves ahead right away, the applied state once hw has
+  // been programmed
+  setDesiredState(newDesiredState);
+  auto inFlight = std::make_unique<InFlightStateUpdate>();
+  inFlight->oldState = oldAppliedState;
+  inFlight->newState = newDesiredState;
+  inFlight->start = steady_clock::now();
+  inFlight->updates.splice(inFlight->updates.begin(), *updates);
+  inFlight->timings = std::move(timings);
+  folly::Promise<std::shared_ptr<SwitchState>> promise;
+  inFlight->appliedState = promise.getSemiFuture();
+  auto* hwProgramming = &inFlight->batchTiming.hwProgramming;
+  inFlightUpdate_ = std::move(inFlight);
+
+  hwUpdateEventBase_.runInEventBaseThread(
+      [this,
+       oldAppliedState = std::move(oldAppliedState),
+       newDesiredState = std::move(newDesiredState),
+       hwProgramming,
+       promise = std::move(promise)]() mutable {
+        auto start = steady_clock::now();
+        auto newAppliedState = programHw(oldAppliedState, newDesiredState);
+        // Only read by the update thread once the promise is fulfilled
+        *hwProgramming =
+            duration_cast<microseconds>(steady_clock::now() - start);
+        promise.setValue(std::move(newAppliedState));
+        // If no batch is waiting on this delta, finish it right away so
+        // that the applied state and observers don't lag behind hw
+        updateEventBase_.runInEventBaseThread([this]() {
+          if (inFlightUpdate_ && inFlightUpdate_->appliedState.isReady()) {
+            finishInFlightUpdate(true /* lastInPipeline */);
+          }
+        });
+      });
+}
+
+void SwSwitch::finishInFlightUpdate(bool lastInPipeline) {
+  DCHECK(updateEventBase_.isInEventBaseThread());
+  auto inFlight = std::move(inFlightUpdate_);
+  auto newAppliedState = std::move(inFlight->appliedState).get();
+  if (newAppliedState) {
+    finishUpdate(
+        StateDelta(inFlight->oldState, inFlight->newState),
+        newAppliedState,
+        inFlight->start,
+        &inFlight->batchTiming);
+    bool newOutOfSync = (newAppliedState != inFlight->newState);
+    fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
+    // When another batch follows, its delta starts from the applied state
+    // and so already carries the difference
+    if (newOutOfSync && lastInPipeline) {
+      queueHwOutOfSyncUpdate(newAppliedState, inFlight->newState);
     }
   }
+  recordStateUpdates(inFlight->timings, inFlight->batchTiming);
+  notifyStateUpdatesSuccess(&inFlight->updates);
+}
+
+void SwSwitch::queueHwOutOfSyncUpdate(
+    const std::shared_ptr<SwitchState>& newAppliedState,
+    const std::shared_ptr<SwitchState>& newDesiredState) {
+  // If we could not apply the whole delta successfully, put the difference
+  // as a state update at the beginning
+  queueStateUpdateForGettingHwInSync(
+      "state update for failed hardware application",
+      [newDesiredState,
+       newAppliedState](const std::shared_ptr<SwitchState>& /*oldState*/) {
+        // clone the newDesiredState and then inheritGeneration from
+        // newAppliedState otherwise the return state has a smaller gen#
+        // than the one of appliedState
+        auto hwOutOfSyncState = newDesiredState->clone();
+        hwOutOfSyncState->inheritGeneration(*newAppliedState);
+        return hwOutOfSyncState;
+      });
+}
 
+void SwSwitch::recordStateUpdates(
+    const std::vector<StateUpdateRecorder::UpdateTiming>& timings,
+    const StateUpdateRecorder::BatchTiming& batchTiming) {
+  if (stateUpdateRecorder_ && !timings.empty()) {
+    stateUpdateRecorder_->record(timings, batchTiming);
+  }
+}
+
+void SwSwitch::notifyStateUpdatesSuccess(StateUpdateList* updates) {
   // Notify all of the updates of success, and delete them. Success is defined
   // as SwSwitch's attempt to apply them to hw, even though they might have not
   // actually been applied yet.
-  while (!updates.empty()) {
-    unique_ptr<StateUpdate> update(&updates.front());
-    updates.pop_front();
+  while (!updates->empty()) {
+    unique_ptr<StateUpdate> update(&updates->front());
+    updates->pop_front();
     update->onSuccess();
   }
 }
@@ -811,20 +1229,38 @@ void SwSwitch::setDesiredState(std::shared_ptr<SwitchState> newDesiredState) {
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     const shared_ptr<SwitchState>& oldState,
-    const shared_ptr<SwitchState>& newState) {
+    const shared_ptr<SwitchState>& newState,
+    StateUpdateRecorder::BatchTiming* timing) {
   // Check that we are starting from what has been already applied
   DCHECK_EQ(oldState, getAppliedState());
 
   auto start = std::chrono::steady_clock::now();
   XLOG(INFO) << "Updating state: old_gen=" << oldState->getGeneration()
              << " new_gen=" << newState->getGeneration();
+
+  auto newAppliedState = programHw(oldState, newState);
+  // If we are already exiting, the update was aborted
+  if (!newAppliedState) {
+    return oldState;
+  }
+  if (timing) {
+    timing->hwProgramming =
+        duration_cast<microseconds>(steady_clock::now() - start);
+  }
+  finishUpdate(StateDelta(oldState, newState), newAppliedState, start, timing);
+  return newAppliedState;
+}
+
+std::shared_ptr<SwitchState> SwSwitch::programHw(
+    const shared_ptr<SwitchState>& oldState,
+    const shared_ptr<SwitchState>& newState) {
   DCHECK_GT(newState->getGeneration(), oldState->getGeneration());
 
   StateDelta delta(oldState, newState);
 
   // If we are already exiting, abort the update
   if (isExiting()) {
-    return oldState;
+    return nullptr;
   }
 
   std::shared_ptr<SwitchState> newAppliedState;
@@ -855,21 +1291,40 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     XLOG(FATAL) << "error applying state change to hardware: "
                 << folly::exceptionStr(ex);
   }
+  return newAppliedState;
+}
 
-  setStateInternal(newAppliedState, newState);
+void SwSwitch::finishUpdate(
+    const StateDelta& delta,
+    const std::shared_ptr<SwitchState>& newAppliedState,
+    std::chrono::steady_clock::time_point start,
+    StateUpdateRecorder::BatchTiming* timing) {
+  setStateInternal(newAppliedState, delta.newState());
+  if (stateJournal_) {
+    stateJournal_->append(newAppliedState);
+  }
 
   // Notifies all observers of the current state update. We notify them that
   // the state changed to "desired state", even if the whole state might not
   // have been applied yet. If an observer wants to know the applied state,
   // they can query the SwSwitch about it.
+  auto observersStart = std::chrono::steady_clock::now();
   notifyStateObservers(delta);
 
   auto end = std::chrono::steady_clock::now();
+  if (timing) {
+    timing->observers = duration_cast<microseconds>(end - observersStart);
+    // Only report the delta size if observers needed the change log anyway,
+    // it is not worth building just for this
+    if (auto changeLog = delta.getChangeLogIfBuilt()) {
+      timing->deltaSize =
+          changeLog->numRouteChanges() + changeLog->numNeighborChanges();
+    }
+  }
   auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(end - start);
   stats()->stateUpdate(duration);
   XLOG(DBG0) << "Update state took " << duration.count() << "us";
-  return newAppliedState;
 }
 
 void SwSwitch::dumpBadStateUpdate(
@@ -1065,12 +1520,17 @@ void SwSwitch::linkStateChanged(PortID portId, bool up) {
     return newState;
   };
   updateStateNoCoalescing(
-      "Port OperState Update", std::move(updateOperStateFn));
+      "Port OperState Update",
+      std::move(updateOperStateFn),
+      StateUpdate::Priority::HIGH);
 
   // Log event and update counters
   logLinkStateEvent(portId, up);
   setPortStatusCounter(portId, up);
   portStats(portId)->linkStateChange();
+  auto numChanges = numLinkStateChanges_.fetch_add(1);
+  linkStateChanges_.addValue(numChanges);
+  linkStateChanges_.addValue(numChanges + 1);
 }
 
 void SwSwitch::startThreads() {
@@ -1078,6 +1538,11 @@ void SwSwitch::startThreads() {
       [=] { this->threadLoop("fbossBgThread", &backgroundEventBase_); }));
   updateThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossUpdateThread", &updateEventBase_); }));
+  if (FLAGS_state_update_pipeline) {
+    hwUpdateThread_.reset(new std::thread([=] {
+      this->threadLoop("fbossHwUpdateThread", &hwUpdateEventBase_);
+    }));
+  }
   packetTxThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossPktTxThread", &packetTxEventBase_); }));
   pcapDistributionThread_.reset(new std::thread([=] {
@@ -1103,8 +1568,14 @@ void SwSwitch::stopThreads() {
         [this] { backgroundEventBase_.terminateLoopSoon(); });
   }
   if (updateThread_) {
-    updateEventBase_.runInEventBaseThread(
-        [this] { updateEventBase_.terminateLoopSoon(); });
+    updateEventBase_.runInEventBaseThread([this] {
+      // Let the delta being programmed to hw finish, so the applied state
+      // matches hw when we exit
+      if (inFlightUpdate_) {
+        finishInFlightUpdate(false /* lastInPipeline */);
+      }
+      updateEventBase_.terminateLoopSoon();
+    });
   }
   if (packetTxThread_) {
     packetTxEventBase_.runInEventBaseThread(
@@ -1128,6 +1599,13 @@ void SwSwitch::stopThreads() {
   if (updateThread_) {
     updateThread_->join();
   }
+  // The update thread is done handing deltas to the hw update thread, so it
+  // can be stopped now
+  if (hwUpdateThread_) {
+    hwUpdateEventBase_.runInEventBaseThread(
+        [this] { hwUpdateEventBase_.terminateLoopSoon(); });
+    hwUpdateThread_->join();
+  }
   if (packetTxThread_) {
     packetTxThread_->join();
   }
@@ -1448,7 +1926,8 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
             &newConfig,
             getPlatform(),
             (getFlags() & SwitchFlags::ENABLE_STANDALONE_RIB) ? getRib()
-                                                              : nullptr);
+                                                              : nullptr,
+            &configFingerprints_);
 
         if (newState && !isValidStateUpdate(StateDelta(state, newState))) {
           throw FbossError("Invalid config passed in, skipping");
@@ -1458,6 +1937,10 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
         // not change (as this might be during warmboot).
         curConfig_ = newConfig;
         curConfigStr_ = target->swConfigRaw();
+        icmpErrorRateLimiter_->updateConfig(
+            curConfig_.icmpErrorRateLimits_ref()
+                ? &(*curConfig_.icmpErrorRateLimits_ref())
+                : nullptr);
         target->dumpConfig(platform_->getRunningConfigDumpFile());
 
         if (!newState) {
@@ -1467,7 +1950,8 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
           return nullptr;
         }
         return newState;
-      });
+      },
+      StateUpdate::Priority::LOW);
 }
 
 bool SwSwitch::isValidStateUpdate(const StateDelta& delta) const {
@@ -9,7 +9,9 @@
  */
 #pragma once
 
+#include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/HwSwitch.h"
+#include "fboss/agent/StateUpdateRecorder.h"
 #include "fboss/agent/ThreadHeartbeat.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
@@ -17,24 +19,33 @@
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/StateUpdate.h"
 #include "fboss/agent/types.h"
+#include "fboss/lib/TimeSeriesWithMinMax.h"
 
 #include <folly/IntrusiveList.h>
 #include <folly/Range.h>
 #include <folly/SpinLock.h>
 #include <folly/ThreadLocal.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/io/async/EventBase.h>
 #include <optional>
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <unordered_set>
+#include <vector>
 
 namespace facebook::fboss {
 
 class ArpHandler;
 class IPv4Handler;
+class IcmpErrorRateLimiter;
 class IPv6Handler;
 class LinkAggregationManager;
 class LldpManager;
@@ -44,6 +55,9 @@ class Port;
 class PortDescriptor;
 class PortStats;
 class PortUpdateHandler;
+class StateChangePublisher;
+class StateJournal;
+class StateMemoryAccountant;
 class RxPacket;
 class SwitchState;
 class SwitchStats;
@@ -187,7 +201,9 @@ class SwSwitch : public HwSwitch::Callback {
    *
    * However, note that the state may be modified by another thread immediately
    * after getState() returns, in which case the caller may now have an out-of-
-   * date copy of the state.
+   * date copy of the state. State update functions should not call this,
+   * but use the state they are passed: with --state_update_pipeline, the
+   * updates of a batch build on a state that may be ahead of this one.
    * See the comments in SwitchState.h for more details about the copy-on-write
    * semantics of SwitchState.
    */
@@ -229,8 +245,14 @@ class SwSwitch : public HwSwitch::Callback {
    * send a single update notification to the HwSwitch and other update
    * subscribers.  Therefore the StateUpdateFn may be called with an
    * unpublished SwitchState in some cases.
+   *
+   * Updates are applied in the order they were scheduled only among updates
+   * of the same priority; higher priority lanes are drained first.
    */
-  void updateState(folly::StringPiece name, StateUpdateFn fn);
+  void updateState(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /**
    * Schedule an update to the switch state.
@@ -244,7 +266,10 @@ class SwSwitch : public HwSwitch::Callback {
    * but can be used when there is an update that MUST be seen by the hw
    * implementation, even if the inverse update is immediately applied.
    */
-  void updateStateNoCoalescing(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateNoCoalescing(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /*
    * A version of updateState() that doesn't return until the update has been
@@ -260,7 +285,10 @@ class SwSwitch : public HwSwitch::Callback {
    * thread, and would simply block the calling thread until the operation
    * completes.
    */
-  void updateStateBlocking(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateBlocking(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /**
    * Apply config from the config file (specified in 'config' flag).
@@ -561,6 +589,17 @@ class SwSwitch : public HwSwitch::Callback {
     return lookupClassUpdater_.get();
   }
 
+  StateChangePublisher* getStateChangePublisher() {
+    return stateChangePublisher_.get();
+  }
+
+  /*
+   * Rate limits for the ICMP errors generated by the agent
+   */
+  IcmpErrorRateLimiter* getIcmpErrorRateLimiter() {
+    return icmpErrorRateLimiter_.get();
+  }
+
   rib::RoutingInformationBase* getRib() {
     DCHECK(isStandaloneRibEnabled());
     return rib_.get();
@@ -612,6 +651,18 @@ class SwSwitch : public HwSwitch::Callback {
    */
   bool getAndClearNeighborHit(RouterID vrf, folly::IPAddress ip);
 
+  /*
+   * Like getAndClearNeighborHit(), but looks the entry up in a bulk scan of
+   * all neighbor hit bits in vrf taken at most maxScanAge ago, taking a new
+   * scan when the last one is older. Checking every neighbor once per
+   * interval then costs a single HW table pass. Falls back to
+   * getAndClearNeighborHit() if the HwSwitch does not support bulk scans.
+   */
+  bool getAndClearNeighborHitFromScan(
+      RouterID vrf,
+      folly::IPAddress ip,
+      std::chrono::milliseconds maxScanAge);
+
   const std::string& getConfigStr() const {
     return curConfigStr_;
   }
@@ -670,6 +721,20 @@ class SwSwitch : public HwSwitch::Callback {
     return resolvedNexthopProbeScheduler_.get();
   }
 
+  /*
+   * Timings of the last state updates, null if the recorder is disabled.
+   */
+  const StateUpdateRecorder* getStateUpdateRecorder() const {
+    return stateUpdateRecorder_.get();
+  }
+
+  /*
+   * Memory accounting of the switch state and the RIB, null if disabled.
+   */
+  const StateMemoryAccountant* getStateMemoryAccountant() const {
+    return stateMemoryAccountant_.get();
+  }
+
  private:
   void queueStateUpdateForGettingHwInSync(
       folly::StringPiece name,
@@ -701,6 +766,7 @@ class SwSwitch : public HwSwitch::Callback {
   void publishInitTimes(std::string name, const float& time);
   void updatePortInfo();
   void updateRouteStats();
+  void updateLinkFlapStats();
   void publishSwitchInfo(struct HwInitResult hwInitRet);
   void setSwitchRunState(SwitchRunState desiredState);
   SwitchStats* createSwitchStats();
@@ -708,9 +774,53 @@ class SwSwitch : public HwSwitch::Callback {
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
+  /*
+   * Picks the lane to take the next batch of pending updates from: the
+   * highest priority non-empty lane, unless a lower priority lane has been
+   * passed over for too many batches. pendingUpdatesLock_ must be held.
+   */
+  std::optional<size_t> pickPendingUpdateLaneLocked();
   std::shared_ptr<SwitchState> applyUpdate(
+      const std::shared_ptr<SwitchState>& oldState,
+      const std::shared_ptr<SwitchState>& newState,
+      StateUpdateRecorder::BatchTiming* timing = nullptr);
+  /*
+   * Programs the delta between the states to hw, returning the state hw
+   * applied or null if we are exiting.
+   */
+  std::shared_ptr<SwitchState> programHw(
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState);
+  /*
+   * Records a delta programmed to hw as applied and notifies observers.
+   */
+  void finishUpdate(
+      const StateDelta& delta,
+      const std::shared_ptr<SwitchState>& newAppliedState,
+      std::chrono::steady_clock::time_point start,
+      StateUpdateRecorder::BatchTiming* timing);
+  /*
+   * With state_update_pipeline, hands the delta to newDesiredState to the hw
+   * update thread, once the delta in flight before it has been applied. The
+   * update thread goes on to compute the next batch meanwhile.
+   */
+  void pipelineStateUpdate(
+      std::shared_ptr<SwitchState> newDesiredState,
+      StateUpdateList* updates,
+      std::vector<StateUpdateRecorder::UpdateTiming> timings);
+  /*
+   * Waits for the delta in flight to be programmed and finishes it. Unless
+   * another batch is about to be programmed, a failure to apply all of it is
+   * queued to be retried like in the non pipelined case.
+   */
+  void finishInFlightUpdate(bool lastInPipeline);
+  void queueHwOutOfSyncUpdate(
+      const std::shared_ptr<SwitchState>& newAppliedState,
+      const std::shared_ptr<SwitchState>& newDesiredState);
+  void recordStateUpdates(
+      const std::vector<StateUpdateRecorder::UpdateTiming>& timings,
+      const StateUpdateRecorder::BatchTiming& batchTiming);
+  void notifyStateUpdatesSuccess(StateUpdateList* updates);
 
   void startThreads();
   void stopThreads();
@@ -736,8 +846,21 @@ class SwSwitch : public HwSwitch::Callback {
 
   /*
    * Notifies all the observers that a state update occured.
+   *
+   * Observers are notified in dependency order. Those that can run
+   * concurrently are dispatched to stateObserverExecutor_, the others run
+   * on the update thread. Returns once every observer is done.
    */
   void notifyStateObservers(const StateDelta& delta);
+  void notifyStateObserver(
+      StateObserver* observer,
+      const std::string& name,
+      const StateDelta& delta);
+  /*
+   * Group observers so that each only depends on observers of earlier
+   * groups.
+   */
+  std::vector<std::vector<StateObserver*>> getStateObserverLevels() const;
 
   void logLinkStateEvent(PortID port, bool up);
 
@@ -754,12 +877,25 @@ class SwSwitch : public HwSwitch::Callback {
 
   std::string curConfigStr_;
   cfg::SwitchConfig curConfig_;
+  // Per-section fingerprints of the last applied config. Only accessed from
+  // the update thread.
+  ThriftConfigFingerprints configFingerprints_;
 
   // The HwSwitch object.  This object is owned by the Platform.
   HwSwitch* hw_;
   std::unique_ptr<Platform> platform_;
   std::atomic<SwitchRunState> runState_{SwitchRunState::UNINITIALIZED};
   folly::ThreadLocalPtr<SwitchStats, SwSwitch> stats_;
+  /*
+   * Running count of link state changes, recorded before and after every
+   * change so that the number of changes within the window is max - min.
+   * Link state changes may be reported from several threads at once.
+   */
+  std::atomic<int64_t> numLinkStateChanges_{0};
+  TimeSeriesWithMinMax<int64_t> linkStateChanges_{
+      std::chrono::seconds(600),
+      std::chrono::seconds(10),
+      4};
   /**
    * The object to sync the interfaces to the system. This pointer could
    * be nullptr if interface sync is not enabled during init()
@@ -767,10 +903,15 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<TunManager> tunMgr_;
 
   /*
-   * A list of pending state updates to be applied.
+   * Lists of pending state updates to be applied, one per priority, and
+   * their sizes. Updates getting HW back in sync with the desired state are
+   * kept aside and applied first in whichever batch runs next.
    */
   folly::SpinLock pendingUpdatesLock_;
-  StateUpdateList pendingUpdates_;
+  std::array<StateUpdateList, StateUpdate::kNumPriorities> pendingUpdates_;
+  std::array<size_t, StateUpdate::kNumPriorities> pendingUpdateCounts_{};
+  std::array<uint32_t, StateUpdate::kNumPriorities> skippedBatches_{};
+  StateUpdateList hwSyncUpdates_;
 
   /*
    * The current switch state: modelled as two states:
@@ -827,6 +968,29 @@ class SwSwitch : public HwSwitch::Callback {
   folly::EventBase updateEventBase_;
   std::unique_ptr<ThreadHeartbeat> updThreadHeartbeat_;
 
+  /*
+   * A thread programming state deltas to hw, with state_update_pipeline.
+   */
+  std::unique_ptr<std::thread> hwUpdateThread_;
+  folly::EventBase hwUpdateEventBase_;
+
+  /*
+   * The delta the hw update thread is programming, if any. Only accessed
+   * from the update thread. Its new state is already the desired state, and
+   * becomes the applied state once programmed.
+   */
+  struct InFlightStateUpdate {
+    std::shared_ptr<SwitchState> oldState;
+    std::shared_ptr<SwitchState> newState;
+    folly::SemiFuture<std::shared_ptr<SwitchState>> appliedState{
+        folly::SemiFuture<std::shared_ptr<SwitchState>>::makeEmpty()};
+    std::chrono::steady_clock::time_point start;
+    StateUpdateList updates;
+    std::vector<StateUpdateRecorder::UpdateTiming> timings;
+    StateUpdateRecorder::BatchTiming batchTiming;
+  };
+  std::unique_ptr<InFlightStateUpdate> inFlightUpdate_;
+
   /*
    * A thread dedicated to LACP processing.
    */
@@ -850,12 +1014,25 @@ class SwSwitch : public HwSwitch::Callback {
       const std::vector<std::string>& deleted)>
       neighborListener_{nullptr};
 
+  /*
+   * The last bulk neighbor hit scan of each vrf. Hits are removed as the
+   * neighbor cache consumes them.
+   */
+  struct NeighborHitScan {
+    std::chrono::steady_clock::time_point scannedAt;
+    std::unordered_set<folly::IPAddress> hits;
+  };
+  std::mutex neighborHitScansMutex_;
+  std::map<RouterID, NeighborHitScan> neighborHitScans_;
+
   /*
    * The list of classes to notify on a state update. This container should only
    * be accessed/modified from the update thread. This removes the need for
    * locking when we access the container during a state update.
    */
   std::map<StateObserver*, std::string> stateObservers_;
+  // Runs observers that can run concurrently, null if disabled
+  std::unique_ptr<folly::CPUThreadPoolExecutor> stateObserverExecutor_;
 
   std::unique_ptr<ArpHandler> arp_;
   std::unique_ptr<IPv4Handler> ipv4_;
@@ -876,6 +1053,14 @@ class SwSwitch : public HwSwitch::Callback {
 
   std::unique_ptr<LookupClassUpdater> lookupClassUpdater_;
   std::unique_ptr<MacTableManager> macTableManager_;
+  std::unique_ptr<StateChangePublisher> stateChangePublisher_;
+  // Journal of applied states in the warm boot dir, when enabled
+  std::unique_ptr<StateJournal> stateJournal_;
+  // Flight recorder of state update timings, null if disabled
+  std::unique_ptr<StateUpdateRecorder> stateUpdateRecorder_;
+  // Background memory accounting of states, null if disabled
+  std::unique_ptr<StateMemoryAccountant> stateMemoryAccountant_;
+  std::unique_ptr<IcmpErrorRateLimiter> icmpErrorRateLimiter_;
 };
 
 } // namespace facebook::fboss
@@ -80,6 +80,18 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           RATE),
       updateState_(map, kCounterPrefix + "state_update.us", 50000, 0, 1000000),
       routeUpdate_(map, kCounterPrefix + "route_update.us", 50, 0, 500),
+      routeUpdateQueueDelay_(
+          map,
+          kCounterPrefix + "route_update_queue_delay.us",
+          1000,
+          0,
+          100000),
+      routeUpdateBatchSize_(
+          map,
+          kCounterPrefix + "route_update_batch_size",
+          1,
+          0,
+          32),
       bgHeartbeatDelay_(
           map,
           kCounterPrefix + "bg_heartbeat_delay.ms",
@@ -177,6 +189,16 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           kCounterPrefix + "update_stats_exceptions",
           SUM),
       trapPktTooBig_(map, kCounterPrefix + "trapped.packet_too_big", SUM, RATE),
+      icmpTimeExceededSuppressed_(
+          map,
+          kCounterPrefix + "icmp.time_exceeded_suppressed",
+          SUM,
+          RATE),
+      icmpPktTooBigSuppressed_(
+          map,
+          kCounterPrefix + "icmp.packet_too_big_suppressed",
+          SUM,
+          RATE),
       LldpRecvdPkt_(map, kCounterPrefix + "lldp.recvd", SUM, RATE),
       LldpBadPkt_(map, kCounterPrefix + "lldp.recv_bad", SUM, RATE),
       LldpValidateMisMatch_(
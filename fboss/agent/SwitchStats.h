@@ -234,6 +234,11 @@ class SwitchStats : public boost::noncopyable {
     routeUpdate_.addRepeatedValue(us.count() / routes, routes);
   }
 
+  void routeUpdateBatch(std::chrono::microseconds queueDelay, size_t size) {
+    routeUpdateQueueDelay_.addValue(queueDelay.count());
+    routeUpdateBatchSize_.addValue(size);
+  }
+
   void bgHeartbeatDelay(int delay) {
     bgHeartbeatDelay_.addValue(delay);
   }
@@ -290,6 +295,13 @@ class SwitchStats : public boost::noncopyable {
     trapPktTooBig_.addValue(1);
   }
 
+  void icmpTimeExceededSuppressed() {
+    icmpTimeExceededSuppressed_.addValue(1);
+  }
+  void icmpPktTooBigSuppressed() {
+    icmpPktTooBigSuppressed_.addValue(1);
+  }
+
   void LldpRecvdPkt() {
     LldpRecvdPkt_.addValue(1);
   }
@@ -416,6 +428,13 @@ class SwitchStats : public boost::noncopyable {
    */
   TLHistogram routeUpdate_;
 
+  /**
+   * Time route updates waited for earlier updates to be committed (in
+   * microsecond), and number of route updates committed together
+   */
+  TLHistogram routeUpdateQueueDelay_;
+  TLHistogram routeUpdateBatchSize_;
+
   /**
    * Background thread heartbeat delay (ms)
    */
@@ -477,6 +496,10 @@ class SwitchStats : public boost::noncopyable {
   // Number of packet too big ICMPv6 triggered
   TLTimeseries trapPktTooBig_;
 
+  // Number of ICMP errors not sent due to rate limiting
+  TLTimeseries icmpTimeExceededSuppressed_;
+  TLTimeseries icmpPktTooBigSuppressed_;
+
   // Number of LLDP packets.
   TLTimeseries LldpRecvdPkt_;
   // Number of bad LLDP packets.
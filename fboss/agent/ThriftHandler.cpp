@@ -17,6 +17,8 @@
 #include "fboss/agent/LldpManager.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/RouteUpdateLogger.h"
+#include "fboss/agent/StateChangePublisher.h"
+#include "fboss/agent/StateMemoryAccountant.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
@@ -61,6 +63,7 @@
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
 
+#include <algorithm>
 #include <limits>
 
 using apache::thrift::ClientReceiveState;
@@ -81,6 +84,7 @@ using std::string;
 using std::unique_ptr;
 using std::vector;
 using std::chrono::duration_cast;
+using std::chrono::microseconds;
 using std::chrono::seconds;
 using std::chrono::steady_clock;
 
@@ -141,7 +145,8 @@ void dynamicFibUpdate(
       vrf, v4NetworkToRoute, v6NetworkToRoute);
 
   auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
-  sw->updateStateBlocking("", std::move(fibUpdater));
+  sw->updateStateBlocking(
+      "", std::move(fibUpdater), StateUpdate::Priority::LOW);
 }
 
 void fillPortStats(PortInfoThrift& portInfo, int numPortQs) {
@@ -570,7 +575,7 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
         clientID,
         defaultAdminDistance,
         {} /* routes to add */,
-        *prefixes /* prefixes to delete */,
+        std::move(*prefixes) /* prefixes to delete */,
         false /* reset routes for client */,
         "delete unicast route",
         &dynamicFibUpdate,
@@ -581,6 +586,7 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
 
     auto totalRouteCount = stats.v4RoutesDeleted + stats.v6RoutesDeleted;
     sw_->stats()->routeUpdate(stats.duration, totalRouteCount);
+    sw_->stats()->routeUpdateBatch(stats.queueDelay, stats.batchSize);
     XLOG(DBG0) << "Delete " << totalRouteCount << " routes took "
                << stats.duration.count() << "us";
 
@@ -614,7 +620,8 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
     newState->resetRouteTables(std::move(newRt));
     return newState;
   };
-  sw_->updateStateBlocking("delete unicast route", updateFn);
+  sw_->updateStateBlocking(
+      "delete unicast route", updateFn, StateUpdate::Priority::LOW);
 }
 
 void ThriftHandler::deleteUnicastRoutes(
@@ -661,7 +668,7 @@ void ThriftHandler::updateUnicastRoutesImpl(
         routerID,
         clientID,
         defaultAdminDistance,
-        *routes /* routes to add */,
+        std::move(*routes) /* routes to add */,
         {} /* prefixes to delete */,
         sync,
         updType,
@@ -673,6 +680,7 @@ void ThriftHandler::updateUnicastRoutesImpl(
 
     auto totalRouteCount = stats.v4RoutesAdded + stats.v6RoutesAdded;
     sw_->stats()->routeUpdate(stats.duration, totalRouteCount);
+    sw_->stats()->routeUpdateBatch(stats.queueDelay, stats.batchSize);
     XLOG(DBG0) << updType << " " << totalRouteCount << " routes took "
                << stats.duration.count() << "us";
 
@@ -739,7 +747,7 @@ void ThriftHandler::updateUnicastRoutesImpl(
     newState->resetRouteTables(std::move(newRt));
     return newState;
   };
-  sw_->updateStateBlocking(updType, updateFn);
+  sw_->updateStateBlocking(updType, updateFn, StateUpdate::Priority::LOW);
 }
 
 static void populateInterfaceDetail(
@@ -1218,6 +1226,33 @@ void ThriftHandler::async_eb_registerForNeighborChanged(
   cb->done();
 }
 
+void ThriftHandler::async_eb_subscribeToStateChanges(
+    ThriftCallback<void> cb,
+    std::unique_ptr<std::set<StateChangeKind>> kinds) {
+  ensureConfigured("subscribeToStateChanges");
+  auto ctx = cb->getConnectionContext()->getConnectionContext();
+  auto client = ctx->getDuplexClient<NeighborListenerClientAsyncClient>();
+  sw_->getStateChangePublisher()->subscribe(
+      cb->getEventBase(),
+      std::move(*kinds),
+      [client](StateChangeBatch batch, std::function<void(bool)> done) {
+        client->stateChanged(
+            [done = std::move(done)](ClientReceiveState&& state) {
+              try {
+                NeighborListenerClientAsyncClient::recv_stateChanged(state);
+              } catch (const std::exception& ex) {
+                XLOG(ERR) << "Exception in state change subscriber: "
+                          << ex.what();
+                done(false);
+                return;
+              }
+              done(true);
+            },
+            batch);
+      });
+  cb->done();
+}
+
 void ThriftHandler::startPktCapture(unique_ptr<CaptureInfo> info) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured();
@@ -1526,6 +1561,49 @@ SwitchRunState ThriftHandler::getSwitchRunState() {
   return sw_->getSwitchRunState();
 }
 
+void ThriftHandler::getStateUpdateRecords(
+    std::vector<StateUpdateRecord>& records,
+    int32_t maxRecords) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  auto recorder = sw_->getStateUpdateRecorder();
+  if (!recorder) {
+    throw FbossError("state update recorder is disabled");
+  }
+  for (const auto& record :
+       recorder->getRecords(std::max<int32_t>(maxRecords, 0))) {
+    StateUpdateRecord thriftRecord;
+    thriftRecord.name = record.name;
+    thriftRecord.finishedAtUsecs = duration_cast<microseconds>(
+                                       record.finishedAt.time_since_epoch())
+                                       .count();
+    thriftRecord.queueWaitUsecs = record.queueWait.count();
+    thriftRecord.applyUsecs = record.apply.count();
+    thriftRecord.hwProgrammingUsecs = record.hwProgramming.count();
+    thriftRecord.observersUsecs = record.observers.count();
+    thriftRecord.deltaSize = record.deltaSize;
+    thriftRecord.batchSize = record.batchSize;
+    records.push_back(std::move(thriftRecord));
+  }
+}
+
+void ThriftHandler::getStateMemoryUsage(StateMemoryUsage& usage) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  auto accountant = sw_->getStateMemoryAccountant();
+  if (!accountant) {
+    throw FbossError("state memory accounting is disabled");
+  }
+  auto report = accountant->getReport();
+  usage.generation = report.generation;
+  for (const auto& entry : report.usage) {
+    MapMemoryUsage mapUsage;
+    mapUsage.nodes = entry.second.nodes;
+    mapUsage.bytes = entry.second.bytes;
+    mapUsage.sharedBytes = entry.second.sharedBytes;
+    usage.maps.emplace(entry.first, std::move(mapUsage));
+  }
+  usage.retainedGenerations = report.retainedGenerations;
+}
+
 SSLType ThriftHandler::getSSLPolicy() {
   auto log = LOG_THRIFT_CALL(DBG1);
   SSLType sslType = SSLType::PERMITTED;
@@ -1573,7 +1651,8 @@ void ThriftHandler::addMplsRoutes(
     }
     return newState;
   };
-  sw_->updateStateBlocking("addMplsRoutes", updateFn);
+  sw_->updateStateBlocking(
+      "addMplsRoutes", updateFn, StateUpdate::Priority::LOW);
 }
 
 void ThriftHandler::addMplsRoutesImpl(
@@ -1619,7 +1698,8 @@ void ThriftHandler::deleteMplsRoutes(
     }
     return newState;
   };
-  sw_->updateStateBlocking("deleteMplsRoutes", updateFn);
+  sw_->updateStateBlocking(
+      "deleteMplsRoutes", updateFn, StateUpdate::Priority::LOW);
 }
 
 void ThriftHandler::syncMplsFib(
@@ -1639,7 +1719,8 @@ void ThriftHandler::syncMplsFib(
     }
     return newState;
   };
-  sw_->updateStateBlocking("syncMplsFib", updateFn);
+  sw_->updateStateBlocking(
+      "syncMplsFib", updateFn, StateUpdate::Priority::LOW);
 }
 
 void ThriftHandler::getMplsRouteTableByClient(
@@ -60,6 +60,10 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void async_eb_registerForNeighborChanged(
       ThriftCallback<void> callback) override;
 
+  void async_eb_subscribeToStateChanges(
+      ThriftCallback<void> callback,
+      std::unique_ptr<std::set<StateChangeKind>> kinds) override;
+
   void flushCountersNow() override;
 
   void addUnicastRoute(int16_t client, std::unique_ptr<UnicastRoute> route)
@@ -290,6 +294,12 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
 
   SwitchRunState getSwitchRunState() override;
 
+  void getStateUpdateRecords(
+      std::vector<StateUpdateRecord>& records,
+      int32_t maxRecords) override;
+
+  void getStateMemoryUsage(StateMemoryUsage& usage) override;
+
   void setSSLPolicy(apache::thrift::SSLPolicy sslPolicy) {
     sslPolicy_ = sslPolicy;
   }
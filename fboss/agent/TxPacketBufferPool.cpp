@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/TxPacketBufferPool.h"
+
+#include <fb303/ServiceData.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+DEFINE_int32(
+    tx_packet_pool_size,
+    256,
+    "Max number of free TX packet buffers kept per thread and size class, "
+    "0 disables pooling");
+
+namespace {
+constexpr auto kHits = "tx_packet_pool.hits";
+constexpr auto kMisses = "tx_packet_pool.misses";
+} // namespace
+
+namespace facebook::fboss {
+
+TxPacketBufferPool& TxPacketBufferPool::get() {
+  // Leaked on purpose, IOBufs may be freed during static destruction
+  static auto* pool = new TxPacketBufferPool();
+  return *pool;
+}
+
+TxPacketBufferPool::FreeLists::~FreeLists() {
+  for (auto& sizeClassBuffers : buffers) {
+    for (auto* buffer : sizeClassBuffers) {
+      std::free(buffer);
+    }
+  }
+}
+
+std::unique_ptr<folly::IOBuf> TxPacketBufferPool::allocate(uint32_t size) {
+  auto iter = std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), size);
+  if (FLAGS_tx_packet_pool_size <= 0 || iter == kSizeClasses.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return folly::IOBuf::createSeparate(size);
+  }
+  size_t sizeClass = iter - kSizeClasses.begin();
+  auto& freeBuffers = freeLists_->buffers[sizeClass];
+  void* buffer;
+  if (!freeBuffers.empty()) {
+    buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    buffer = std::malloc(*iter);
+    if (!buffer) {
+      throw std::bad_alloc();
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return folly::IOBuf::takeOwnership(
+      buffer,
+      *iter,
+      0,
+      &TxPacketBufferPool::freeBuffer,
+      reinterpret_cast<void*>(sizeClass));
+}
+
+void TxPacketBufferPool::freeBuffer(void* buffer, void* sizeClass) {
+  get().release(buffer, reinterpret_cast<uintptr_t>(sizeClass));
+}
+
+void TxPacketBufferPool::release(void* buffer, size_t sizeClass) {
+  auto& freeBuffers = freeLists_->buffers[sizeClass];
+  if (freeBuffers.size() >=
+      static_cast<size_t>(std::max(FLAGS_tx_packet_pool_size, 0))) {
+    std::free(buffer);
+    return;
+  }
+  freeBuffers.push_back(buffer);
+}
+
+void TxPacketBufferPool::publishStats() const {
+  fb303::fbData->setCounter(kHits, getHits());
+  fb303::fbData->setCounter(kMisses, getMisses());
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/ThreadLocal.h>
+#include <folly/io/IOBuf.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Pool of buffers for TxPackets.
+ *
+ * Buffers are rounded up to a handful of size classes and kept on per
+ * thread free lists, so allocating the buffer for an ARP reply or an LLDP
+ * frame does not go to the heap once the pool is warm. A buffer goes back
+ * to the free list of the thread that drops the last reference to its
+ * IOBuf, which is typically the thread that finished sending it.
+ *
+ * Buffers larger than the largest size class are not pooled.
+ */
+class TxPacketBufferPool {
+ public:
+  static TxPacketBufferPool& get();
+
+  /*
+   * Returns an IOBuf with at least size bytes of capacity, and no data.
+   */
+  std::unique_ptr<folly::IOBuf> allocate(uint32_t size);
+
+  uint64_t getHits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+  uint64_t getMisses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  /*
+   * Export hit and miss counters to fb303
+   */
+  void publishStats() const;
+
+  static constexpr std::array<uint32_t, 6> kSizeClasses = {
+      {128, 256, 512, 1024, 2048, 9216}};
+
+ private:
+  struct FreeLists {
+    ~FreeLists();
+    std::array<std::vector<void*>, kSizeClasses.size()> buffers;
+  };
+
+  TxPacketBufferPool() {}
+
+  static void freeBuffer(void* buffer, void* sizeClass);
+  void release(void* buffer, size_t sizeClass);
+
+  // Forbidden copy constructor and assignment operator
+  TxPacketBufferPool(TxPacketBufferPool const&) = delete;
+  TxPacketBufferPool& operator=(TxPacketBufferPool const&) = delete;
+
+  folly::ThreadLocal<FreeLists> freeLists_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace facebook::fboss
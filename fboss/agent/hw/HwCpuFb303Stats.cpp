@@ -38,11 +38,23 @@ void HwCpuFb303Stats::setupStats() {
   XLOG(DBG2) << "Initializing CPU stats";
 
   for (auto queueIdAndName : queueId2Name_) {
-    for (auto statKey : kQueueStatKeys()) {
-      auto newStatName =
-          statName(statKey, queueIdAndName.first, queueIdAndName.second);
-      queueCounters_.reinitStat(newStatName, std::nullopt);
-    }
+    reinitQueueStats(
+        queueIdAndName.first, queueIdAndName.second, std::nullopt);
+  }
+}
+
+void HwCpuFb303Stats::reinitQueueStats(
+    int queueId,
+    const std::string& queueName,
+    std::optional<std::string> oldQueueName) {
+  auto& handles = queueStatHandles_[queueId];
+  auto statKeys = kQueueStatKeys();
+  for (size_t i = 0; i < statKeys.size(); ++i) {
+    handles[i] = queueCounters_.reinitStat(
+        statName(statKeys[i], queueId, queueName),
+        oldQueueName ? std::optional<std::string>(
+                           statName(statKeys[i], queueId, *oldQueueName))
+                     : std::nullopt);
   }
 }
 
@@ -54,13 +66,7 @@ void HwCpuFb303Stats::queueChanged(
       ? std::nullopt
       : std::optional<std::string>(qitr->second);
   queueId2Name_[queueId] = queueName;
-  for (auto statKey : kQueueStatKeys()) {
-    queueCounters_.reinitStat(
-        statName(statKey, queueId, queueName),
-        oldQueueName ? std::optional<std::string>(
-                           statName(statKey, queueId, *oldQueueName))
-                     : std::nullopt);
-  }
+  reinitQueueStats(queueId, queueName, oldQueueName);
 }
 
 void HwCpuFb303Stats::queueRemoved(int queueId) {
@@ -70,6 +76,7 @@ void HwCpuFb303Stats::queueRemoved(int queueId) {
         statName(statKey, queueId, queueId2Name_[queueId]));
   }
   queueId2Name_.erase(queueId);
+  queueStatHandles_.erase(queueId);
 }
 
 void HwCpuFb303Stats::updateStats(
@@ -79,24 +86,25 @@ void HwCpuFb303Stats::updateStats(
   // Update queue stats
   auto updateQueueStat = [this](
                              folly::StringPiece statKey,
+                             HwFb303Stats::StatHandle stat,
                              int queueId,
                              const std::map<int16_t, int64_t>& queueStats) {
     auto qitr = queueStats.find(queueId);
     CHECK(qitr != queueStats.end())
         << "Missing stat: " << statKey
         << " for queue: :" << queueId2Name_[queueId];
-    queueCounters_.updateStat(
-        timeRetrieved_,
-        statName(statKey, queueId, queueId2Name_[queueId]),
-        qitr->second);
+    queueCounters_.updateStat(timeRetrieved_, stat, qitr->second);
   };
-  for (const auto& queueIdAndName : queueId2Name_) {
+  for (const auto& queueIdAndHandles : queueStatHandles_) {
+    auto queueId = queueIdAndHandles.first;
+    const auto& handles = queueIdAndHandles.second;
+    updateQueueStat(
+        kInPkts(), handles[0], queueId, curPortStats.queueOutPackets_);
     updateQueueStat(
         kInDroppedPkts(),
-        queueIdAndName.first,
+        handles[1],
+        queueId,
         curPortStats.queueOutDiscardPackets_);
-    updateQueueStat(
-        kInPkts(), queueIdAndName.first, curPortStats.queueOutPackets_);
   }
 }
 
@@ -15,6 +15,7 @@
 
 #include "folly/container/F14Map.h"
 
+#include <array>
 #include <optional>
 #include <string>
 
@@ -47,15 +48,17 @@ class HwCpuFb303Stats {
 
  private:
   void setupStats();
-
-  void updateStat(
-      const std::chrono::seconds& now,
-      const std::string& statName,
-      int64_t val);
+  void reinitQueueStats(
+      int queueId,
+      const std::string& queueName,
+      std::optional<std::string> oldQueueName);
 
   std::chrono::seconds timeRetrieved_{0};
   HwFb303Stats queueCounters_;
   QueueId2Name queueId2Name_;
+  // Per queue handles of the kQueueStatKeys() stats, in that order
+  folly::F14FastMap<int, std::array<HwFb303Stats::StatHandle, 2>>
+      queueStatHandles_;
 };
 
 } // namespace facebook::fboss
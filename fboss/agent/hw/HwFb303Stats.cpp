@@ -17,63 +17,69 @@
 namespace facebook::fboss {
 
 HwFb303Stats::~HwFb303Stats() {
-  for (const auto& statNameAndStat : counters_) {
-    utility::deleteCounter(statNameAndStat.second.getName());
+  for (const auto& counter : counters_) {
+    if (counter) {
+      utility::deleteCounter(counter->getName());
+    }
   }
 }
 
-const stats::MonotonicCounter* HwFb303Stats::getCounterIf(
+std::optional<HwFb303Stats::StatHandle> HwFb303Stats::getHandleIf(
     const std::string& statName) const {
-  auto pcitr = counters_.find(statName);
-  return pcitr != counters_.end() ? &pcitr->second : nullptr;
-}
-
-stats::MonotonicCounter* HwFb303Stats::getCounterIf(
-    const std::string& statName) {
-  return const_cast<stats::MonotonicCounter*>(
-      const_cast<const HwFb303Stats*>(this)->getCounterIf(statName));
+  auto hitr = statHandles_.find(statName);
+  return hitr != statHandles_.end() ? std::optional<StatHandle>(hitr->second)
+                                    : std::nullopt;
 }
 
 int64_t HwFb303Stats::getCounterLastIncrement(
     const std::string& statName) const {
-  return getCounterIf(statName)->get();
+  return counters_[*getHandleIf(statName)]->get();
 }
 
 /*
  * Reinit port or port queue stat
  */
-void HwFb303Stats::reinitStat(
+HwFb303Stats::StatHandle HwFb303Stats::reinitStat(
     const std::string& statName,
     std::optional<std::string> oldStatName) {
   if (oldStatName) {
+    auto handle = getHandleIf(*oldStatName);
+    CHECK(handle) << "Missing stat: " << *oldStatName;
     if (oldStatName == statName) {
-      return;
+      return *handle;
     }
-    auto stat = getCounterIf(*oldStatName);
     stats::MonotonicCounter newStat{statName, fb303::SUM, fb303::RATE};
-    stat->swap(newStat);
+    counters_[*handle]->swap(newStat);
     utility::deleteCounter(newStat.getName());
-    counters_.insert(std::make_pair(statName, std::move(*stat)));
-    counters_.erase(*oldStatName);
+    statHandles_.erase(*oldStatName);
+    statHandles_.emplace(statName, *handle);
+    return *handle;
+  }
+  if (auto handle = getHandleIf(statName)) {
+    return *handle;
+  }
+  auto counter = std::make_unique<stats::MonotonicCounter>(
+      statName, fb303::SUM, fb303::RATE);
+  StatHandle handle;
+  if (!freeHandles_.empty()) {
+    handle = freeHandles_.back();
+    freeHandles_.pop_back();
+    counters_[handle] = std::move(counter);
   } else {
-    counters_.emplace(
-        statName, stats::MonotonicCounter(statName, fb303::SUM, fb303::RATE));
+    handle = counters_.size();
+    counters_.push_back(std::move(counter));
   }
+  statHandles_.emplace(statName, handle);
+  return handle;
 }
 
 void HwFb303Stats::removeStat(const std::string& statName) {
-  auto stat = getCounterIf(statName);
-  utility::deleteCounter(stat->getName());
-  counters_.erase(stat->getName());
-}
-
-void HwFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    const std::string& statName,
-    int64_t val) {
-  auto stat = getCounterIf(statName);
-  CHECK(stat);
-  stat->updateValue(now, val);
+  auto handle = getHandleIf(statName);
+  CHECK(handle) << "Missing stat: " << statName;
+  utility::deleteCounter(statName);
+  counters_[*handle].reset();
+  freeHandles_.push_back(*handle);
+  statHandles_.erase(statName);
 }
 
 } // namespace facebook::fboss
@@ -14,12 +14,21 @@
 
 #include "folly/container/F14Map.h"
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 namespace facebook::fboss {
 
+/*
+ * Stats are looked up by name only when they are (re)initialized or
+ * removed. reinitStat returns a handle which stays valid across renames
+ * until the stat is removed, and which is all updateStat needs.
+ */
 class HwFb303Stats {
  public:
+  using StatHandle = uint32_t;
+
   ~HwFb303Stats();
 
   int64_t getCounterLastIncrement(const std::string& statName) const;
@@ -27,23 +36,23 @@ class HwFb303Stats {
   /*
    * Reinit stat
    */
-  void reinitStat(
+  StatHandle reinitStat(
       const std::string& statName,
       std::optional<std::string> oldStatName);
   void updateStat(
       const std::chrono::seconds& now,
-      const std::string& statName,
-      int64_t val);
+      StatHandle stat,
+      int64_t val) {
+    counters_[stat]->updateValue(now, val);
+  }
   void removeStat(const std::string& statName);
 
  private:
-  /*
-   * Update queue stat
-   */
-  stats::MonotonicCounter* getCounterIf(const std::string& statName);
-  const stats::MonotonicCounter* getCounterIf(
-      const std::string& statName) const;
+  std::optional<StatHandle> getHandleIf(const std::string& statName) const;
 
-  folly::F14FastMap<std::string, stats::MonotonicCounter> counters_;
+  std::vector<std::unique_ptr<stats::MonotonicCounter>> counters_;
+  // Slots in counters_ freed by removeStat
+  std::vector<StatHandle> freeHandles_;
+  folly::F14FastMap<std::string, StatHandle> statHandles_;
 };
 } // namespace facebook::fboss
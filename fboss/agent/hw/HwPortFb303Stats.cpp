@@ -13,6 +13,7 @@
 #include "fboss/agent/hw/CounterUtils.h"
 #include "fboss/agent/hw/StatsConstants.h"
 
+#include <fb303/ServiceData.h>
 #include <folly/logging/xlog.h>
 
 namespace facebook::fboss {
@@ -71,50 +72,47 @@ int64_t HwPortFb303Stats::getCounterLastIncrement(
 void HwPortFb303Stats::reinitStats(std::optional<std::string> oldPortName) {
   XLOG(DBG2) << "Reinitializing stats for " << portName_;
 
-  for (auto statKey : kPortStatKeys()) {
-    reinitStat(statKey, portName_, oldPortName);
+  auto statKeys = kPortStatKeys();
+  for (size_t i = 0; i < statKeys.size(); ++i) {
+    portStatHandles_[i] = portCounters_.reinitStat(
+        statName(statKeys[i], portName_),
+        oldPortName
+            ? std::optional<std::string>(statName(statKeys[i], *oldPortName))
+            : std::nullopt);
   }
   for (auto queueIdAndName : queueId2Name_) {
-    for (auto statKey : kQueueStatKeys()) {
-      auto newStatName = statName(
-          statKey, portName_, queueIdAndName.first, queueIdAndName.second);
-      std::optional<std::string> oldStatName = oldPortName
-          ? std::optional<std::string>(statName(
-                statKey,
-                *oldPortName,
-                queueIdAndName.first,
-                queueIdAndName.second))
-          : std::nullopt;
-      portCounters_.reinitStat(newStatName, oldStatName);
+    if (oldPortName) {
+      fb303::fbData->clearCounter(statName(
+          kWatermarkBytesMax(),
+          *oldPortName,
+          queueIdAndName.first,
+          queueIdAndName.second));
     }
+    reinitQueueStats(queueIdAndName.first, oldPortName, std::nullopt);
   }
 }
 
-/*
- * Reinit port stat
- */
-void HwPortFb303Stats::reinitStat(
-    folly::StringPiece statKey,
-    const std::string& portName,
-    std::optional<std::string> oldPortName) {
-  portCounters_.reinitStat(
-      statName(statKey, portName),
-      oldPortName ? std::optional<std::string>(statName(statKey, *oldPortName))
-                  : std::nullopt);
-}
-
-/*
- * Reinit port queue stat
- */
-void HwPortFb303Stats::reinitStat(
-    folly::StringPiece statKey,
+void HwPortFb303Stats::reinitQueueStats(
     int queueId,
+    std::optional<std::string> oldPortName,
     std::optional<std::string> oldQueueName) {
-  portCounters_.reinitStat(
-      statName(statKey, portName_, queueId, queueId2Name_[queueId]),
-      oldQueueName ? std::optional<std::string>(
-                         statName(statKey, portName_, queueId, *oldQueueName))
-                   : std::nullopt);
+  const auto& queueName = queueId2Name_[queueId];
+  auto& counters = queueCounters_[queueId];
+  auto statKeys = kQueueStatKeys();
+  for (size_t i = 0; i < statKeys.size(); ++i) {
+    std::optional<std::string> oldStatName;
+    if (oldPortName || oldQueueName) {
+      oldStatName = statName(
+          statKeys[i],
+          oldPortName.value_or(portName_),
+          queueId,
+          oldQueueName.value_or(queueName));
+    }
+    counters.stats[i] = portCounters_.reinitStat(
+        statName(statKeys[i], portName_, queueId, queueName), oldStatName);
+  }
+  counters.watermarkBytesMax =
+      statName(kWatermarkBytesMax(), portName_, queueId, queueName);
 }
 
 void HwPortFb303Stats::queueChanged(int queueId, const std::string& queueName) {
@@ -122,10 +120,11 @@ void HwPortFb303Stats::queueChanged(int queueId, const std::string& queueName) {
   std::optional<std::string> oldQueueName = qitr == queueId2Name_.end()
       ? std::nullopt
       : std::optional<std::string>(qitr->second);
-  queueId2Name_[queueId] = queueName;
-  for (auto statKey : kQueueStatKeys()) {
-    reinitStat(statKey, queueId, oldQueueName);
+  if (oldQueueName) {
+    clearQueueWatermarkMax(queueId, *oldQueueName);
   }
+  queueId2Name_[queueId] = queueName;
+  reinitQueueStats(queueId, std::nullopt, oldQueueName);
 }
 
 void HwPortFb303Stats::queueRemoved(int queueId) {
@@ -134,82 +133,85 @@ void HwPortFb303Stats::queueRemoved(int queueId) {
     portCounters_.removeStat(
         statName(statKey, portName_, queueId, queueId2Name_[queueId]));
   }
+  clearQueueWatermarkMax(queueId, queueId2Name_[queueId]);
   queueId2Name_.erase(queueId);
+  queueCounters_.erase(queueId);
 }
 
 void HwPortFb303Stats::updateStats(
     const HwPortStats& curPortStats,
     const std::chrono::seconds& retrievedAt) {
   timeRetrieved_ = retrievedAt;
-  updateStat(timeRetrieved_, kInBytes(), curPortStats.inBytes_);
-  updateStat(timeRetrieved_, kInUnicastPkts(), curPortStats.inUnicastPkts_);
-  updateStat(timeRetrieved_, kInMulticastPkts(), curPortStats.inMulticastPkts_);
-  updateStat(timeRetrieved_, kInBroadcastPkts(), curPortStats.inBroadcastPkts_);
-  updateStat(timeRetrieved_, kInDiscardsRaw(), curPortStats.inDiscardsRaw_);
-  updateStat(timeRetrieved_, kInDiscards(), curPortStats.inDiscards_);
-  updateStat(timeRetrieved_, kInErrors(), curPortStats.inErrors_);
-  updateStat(timeRetrieved_, kInPause(), curPortStats.inPause_);
-  updateStat(timeRetrieved_, kInIpv4HdrErrors(), curPortStats.inIpv4HdrErrors_);
-  updateStat(timeRetrieved_, kInIpv6HdrErrors(), curPortStats.inIpv6HdrErrors_);
-  updateStat(
-      timeRetrieved_, kInDstNullDiscards(), curPortStats.inDstNullDiscards_);
-  // Egress Stats
-  updateStat(timeRetrieved_, kOutBytes(), curPortStats.outBytes_);
-  updateStat(timeRetrieved_, kOutUnicastPkts(), curPortStats.outUnicastPkts_);
-  updateStat(
-      timeRetrieved_, kOutMulticastPkts(), curPortStats.outMulticastPkts_);
-  updateStat(
-      timeRetrieved_, kOutBroadcastPkts(), curPortStats.outBroadcastPkts_);
-  updateStat(timeRetrieved_, kOutDiscards(), curPortStats.outDiscards_);
-  updateStat(timeRetrieved_, kOutErrors(), curPortStats.outErrors_);
-  updateStat(timeRetrieved_, kOutPause(), curPortStats.outPause_);
-  updateStat(
-      timeRetrieved_,
-      kOutCongestionDiscards(),
-      curPortStats.outCongestionDiscardPkts_);
-  updateStat(timeRetrieved_, kOutEcnCounter(), curPortStats.outEcnCounter_);
-  updateStat(
-      timeRetrieved_, kFecCorrectable(), curPortStats.fecCorrectableErrors);
-  updateStat(
-      timeRetrieved_, kFecUncorrectable(), curPortStats.fecUncorrectableErrors);
-
-  // Update queue stats
-  auto updateQueueStat = [this](
-                             folly::StringPiece statKey,
-                             int queueId,
-                             const std::map<int16_t, int64_t>& queueStats) {
-    auto qitr = queueStats.find(queueId);
-    CHECK(qitr != queueStats.end())
-        << "Missing stat: " << statKey
-        << " for queue: :" << queueId2Name_[queueId];
-    updateStat(timeRetrieved_, statKey, queueId, qitr->second);
+  // In kPortStatKeys() order
+  const std::array<int64_t, 22> portStats = {
+      curPortStats.inBytes_,
+      curPortStats.inUnicastPkts_,
+      curPortStats.inMulticastPkts_,
+      curPortStats.inBroadcastPkts_,
+      curPortStats.inDiscards_,
+      curPortStats.inErrors_,
+      curPortStats.inPause_,
+      curPortStats.inIpv4HdrErrors_,
+      curPortStats.inIpv6HdrErrors_,
+      curPortStats.inDstNullDiscards_,
+      curPortStats.inDiscardsRaw_,
+      // Egress Stats
+      curPortStats.outBytes_,
+      curPortStats.outUnicastPkts_,
+      curPortStats.outMulticastPkts_,
+      curPortStats.outBroadcastPkts_,
+      curPortStats.outDiscards_,
+      curPortStats.outErrors_,
+      curPortStats.outPause_,
+      curPortStats.outCongestionDiscardPkts_,
+      curPortStats.outEcnCounter_,
+      curPortStats.fecCorrectableErrors,
+      curPortStats.fecUncorrectableErrors,
+  };
+  for (size_t i = 0; i < portStats.size(); ++i) {
+    portCounters_.updateStat(timeRetrieved_, portStatHandles_[i], portStats[i]);
+  }
+
+  // Update queue stats, in kQueueStatKeys() order
+  const std::array<const std::map<int16_t, int64_t>*, 3> queueStats = {
+      &curPortStats.queueOutDiscardBytes_,
+      &curPortStats.queueOutBytes_,
+      &curPortStats.queueOutPackets_,
   };
-  for (const auto& queueIdAndName : queueId2Name_) {
-    updateQueueStat(
-        kOutCongestionDiscards(),
-        queueIdAndName.first,
-        curPortStats.queueOutDiscardBytes_);
-    updateQueueStat(
-        kOutBytes(), queueIdAndName.first, curPortStats.queueOutBytes_);
-    updateQueueStat(
-        kOutPkts(), queueIdAndName.first, curPortStats.queueOutPackets_);
+  for (const auto& queueIdAndCounters : queueCounters_) {
+    auto queueId = queueIdAndCounters.first;
+    for (size_t i = 0; i < queueStats.size(); ++i) {
+      auto qitr = queueStats[i]->find(queueId);
+      CHECK(qitr != queueStats[i]->end())
+          << "Missing stat: " << kQueueStatKeys()[i]
+          << " for queue: :" << queueId2Name_[queueId];
+      portCounters_.updateStat(
+          timeRetrieved_, queueIdAndCounters.second.stats[i], qitr->second);
+    }
   }
   updateQueueWatermarkStats(curPortStats.queueWatermarkBytes_);
+  updateQueueWatermarkMax(curPortStats.queueWatermarkBytes_);
 }
 
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int queueId,
-    int64_t val) {
-  portCounters_.updateStat(
-      now, statName(statKey, portName_, queueId, queueId2Name_[queueId]), val);
+void HwPortFb303Stats::updateQueueWatermarkMax(
+    const std::map<int16_t, int64_t>& queueWatermarkBytes) {
+  for (const auto& queueIdAndCounters : queueCounters_) {
+    auto qitr = queueWatermarkBytes.find(queueIdAndCounters.first);
+    if (qitr == queueWatermarkBytes.end()) {
+      continue;
+    }
+    auto& watermarks = queueWatermarks_[queueIdAndCounters.first];
+    watermarks.addValue(qitr->second);
+    fb303::fbData->setCounter(
+        queueIdAndCounters.second.watermarkBytesMax, watermarks.getMax());
+  }
 }
 
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int64_t val) {
-  portCounters_.updateStat(now, statName(statKey, portName_), val);
+void HwPortFb303Stats::clearQueueWatermarkMax(
+    int queueId,
+    const std::string& queueName) {
+  queueWatermarks_.erase(queueId);
+  fb303::fbData->clearCounter(
+      statName(kWatermarkBytesMax(), portName_, queueId, queueName));
 }
 } // namespace facebook::fboss
@@ -12,9 +12,11 @@
 
 #include "fboss/agent/hw/HwCpuFb303Stats.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_types.h"
+#include "fboss/lib/TimeSeriesWithMinMax.h"
 
 #include "folly/container/F14Map.h"
 
+#include <array>
 #include <optional>
 #include <string>
 
@@ -65,48 +67,39 @@ class HwPortFb303Stats {
  private:
   void reinitStats(std::optional<std::string> oldPortName);
   /*
-   * Reinit port stat
+   * Reinit port queue stats, after the port or the queue got renamed
    */
-  void reinitStat(
-      folly::StringPiece statKey,
-      const std::string& portName,
-      std::optional<std::string> oldPortName);
-  /*
-   * Reinit port queue stat
-   */
-  void reinitStat(
-      folly::StringPiece statKey,
+  void reinitQueueStats(
       int queueId,
+      std::optional<std::string> oldPortName,
       std::optional<std::string> oldQueueName);
 
+  void updateQueueWatermarkStats(
+      const std::map<int16_t, int64_t>& queueWatermarkBytes) const;
   /*
-   * Reinit port or port queue stat
-   */
-  void reinitStat(
-      const std::string& statName,
-      std::optional<std::string> oldStatName);
-  /*
-   * update port stat
+   * Track max queue watermark over the last minute
    */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int64_t val);
+  void updateQueueWatermarkMax(
+      const std::map<int16_t, int64_t>& queueWatermarkBytes);
+  void clearQueueWatermarkMax(int queueId, const std::string& queueName);
   /*
-   * update port queue stat
+   * Counters of a port queue, resolved when the queue or port is named so
+   * that collecting stats does not build any stat names
    */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int queueId,
-      int64_t val);
+  struct QueueCounters {
+    // In kQueueStatKeys() order
+    std::array<HwFb303Stats::StatHandle, 3> stats;
+    std::string watermarkBytesMax;
+  };
 
-  void updateQueueWatermarkStats(
-      const std::map<int16_t, int64_t>& queueWatermarkBytes) const;
   std::chrono::seconds timeRetrieved_{0};
   std::string portName_;
   HwFb303Stats portCounters_;
+  // In kPortStatKeys() order
+  std::array<HwFb303Stats::StatHandle, 22> portStatHandles_;
   QueueId2Name queueId2Name_;
+  folly::F14FastMap<int, QueueCounters> queueCounters_;
+  folly::F14FastMap<int, TimeSeriesWithMinMax<int64_t>> queueWatermarks_;
 };
 
 } // namespace facebook::fboss
@@ -10,6 +10,8 @@
 
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 
+#include "fboss/agent/Constants.h"
+#include "fboss/agent/StateJournal.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/Utils.h"
 
@@ -144,7 +146,13 @@ folly::dynamic HwSwitchWarmBootHelper::getWarmBootState() const {
   auto ret = folly::readFile(warmBootSwitchStateFile().c_str(), warmBootJson);
   sysCheckError(
       ret, "Unable to read switch state from : ", warmBootSwitchStateFile());
-  return folly::parseJson(warmBootJson);
+  auto warmBootState = folly::parseJson(warmBootJson);
+  if (warmBootState.count(kStateJournal)) {
+    // The switch state was journaled as it was applied, rather than dumped
+    warmBootState[kSwSwitch] =
+        StateJournal::replay(warmBootDir_, warmBootState[kStateJournal]);
+  }
+  return warmBootState;
 }
 
 void HwSwitchWarmBootHelper::setupWarmBootFile() {
@@ -121,4 +121,8 @@ inline folly::StringPiece constexpr kFecUncorrectable() {
   return "fec_uncorrectable_errors";
 }
 
+inline folly::StringPiece constexpr kWatermarkBytesMax() {
+  return "watermark_bytes.max.60";
+}
+
 } // namespace facebook::fboss
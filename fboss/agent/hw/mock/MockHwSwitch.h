@@ -34,6 +34,9 @@ class MockHwSwitch : public HwSwitch {
       stateChanged,
       std::shared_ptr<SwitchState>(const StateDelta& delta));
   MOCK_METHOD2(getAndClearNeighborHit, bool(RouterID, folly::IPAddress&));
+  MOCK_METHOD1(
+      getAndClearNeighborHits,
+      std::optional<std::vector<folly::IPAddress>>(RouterID));
 
   std::unique_ptr<TxPacket> allocatePacket(uint32_t size) const override;
 
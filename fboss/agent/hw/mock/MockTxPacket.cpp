@@ -11,14 +11,13 @@
 
 #include <folly/io/IOBuf.h>
 
+#include "fboss/agent/TxPacketBufferPool.h"
 #include "fboss/agent/packet/EthHdr.h"
 
-using folly::IOBuf;
-
 namespace facebook::fboss {
 
 MockTxPacket::MockTxPacket(uint32_t size) {
-  buf_ = IOBuf::create(size);
+  buf_ = TxPacketBufferPool::get().allocate(size);
   buf_->append(size);
 }
 
@@ -115,11 +115,17 @@ class BridgeApi : public SaiApi<BridgeApi> {
     return api_->remove_bridge_port(id);
   }
 
-  sai_status_t _getAttribute(BridgeSaiId id, sai_attribute_t* attr) const {
-    return api_->get_bridge_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      BridgeSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_bridge_attribute(id, count, attr);
   }
-  sai_status_t _getAttribute(BridgePortSaiId id, sai_attribute_t* attr) const {
-    return api_->get_bridge_port_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      BridgePortSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_bridge_port_attribute(id, count, attr);
   }
 
   sai_status_t _setAttribute(BridgeSaiId id, const sai_attribute_t* attr) {
@@ -74,8 +74,11 @@ class HashApi : public SaiApi<HashApi> {
     return api_->remove_hash(id);
   }
 
-  sai_status_t _getAttribute(HashSaiId id, sai_attribute_t* attr) const {
-    return api_->get_hash_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      HashSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_hash_attribute(id, count, attr);
   }
 
   sai_status_t _setAttribute(HashSaiId id, const sai_attribute_t* attr) {
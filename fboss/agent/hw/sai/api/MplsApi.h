@@ -105,8 +105,9 @@ class MplsApi : public SaiApi<MplsApi> {
   }
   sai_status_t _getAttribute(
       const SaiInSegTraits::InSegEntry& inSegEntry,
-      sai_attribute_t* attr) const {
-    return api_->get_inseg_entry_attribute(inSegEntry.entry(), 1, attr);
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_inseg_entry_attribute(inSegEntry.entry(), count, attr);
   }
   sai_status_t _setAttribute(
       const SaiInSegTraits::InSegEntry& inSegEntry,
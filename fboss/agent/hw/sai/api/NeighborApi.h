@@ -116,8 +116,10 @@ class NeighborApi : public SaiApi<NeighborApi> {
   }
   sai_status_t _getAttribute(
       const SaiNeighborTraits::NeighborEntry& neighborEntry,
-      sai_attribute_t* attr) const {
-    return api_->get_neighbor_entry_attribute(neighborEntry.entry(), 1, attr);
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_neighbor_entry_attribute(
+        neighborEntry.entry(), count, attr);
   }
   sai_status_t _setAttribute(
       const SaiNeighborTraits::NeighborEntry& neighborEntry,
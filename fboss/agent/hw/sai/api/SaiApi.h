@@ -22,6 +22,7 @@
 
 #include <boost/variant.hpp>
 
+#include <atomic>
 #include <exception>
 #include <mutex>
 #include <stdexcept>
@@ -123,7 +124,7 @@ class SaiApi {
 
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
     sai_status_t status;
-    status = impl()._getAttribute(key, attr.saiAttr());
+    status = impl()._getAttribute(key, attr.saiAttr(), 1);
     /*
      * If this is a list attribute and we have not allocated enough
      * memory for the data coming from SAI, the Adapter will return
@@ -133,7 +134,7 @@ class SaiApi {
      */
     if (status == SAI_STATUS_BUFFER_OVERFLOW) {
       attr.realloc();
-      status = impl()._getAttribute(key, attr.saiAttr());
+      status = impl()._getAttribute(key, attr.saiAttr(), 1);
     }
     saiApiCheckError(status, ApiT::ApiType, "Failed to get sai attribute");
     XLOGF(DBG5, "got SAI attribute: {}: {}", key, attr);
@@ -150,6 +151,12 @@ class SaiApi {
       const AdapterKeyT& key,
       TupleT&& attrTuple) {
     // TODO: assert on All<IsSaiAttribute>
+    if constexpr (IsTupleOfSaiAttributes<std::decay_t<TupleT>>::value) {
+      std::decay_t<TupleT> attrs{attrTuple};
+      if (getAttributesBulk(key, attrs)) {
+        return attrs;
+      }
+    }
     auto recurse = [&key, this](auto&& attr) {
       return getAttribute(key, std::forward<decltype(attr)>(attr));
     };
@@ -227,6 +234,86 @@ class SaiApi {
   }
 
  private:
+  template <typename AttrT>
+  static AttrT& bulkGetAttr(AttrT& attr) {
+    return attr;
+  }
+  template <typename AttrT>
+  static AttrT& bulkGetAttr(std::optional<AttrT>& attrOptional) {
+    if (!attrOptional) {
+      attrOptional.emplace();
+    }
+    return attrOptional.value();
+  }
+
+  /*
+   * Fetch a tuple of attributes with a single multi-attribute SAI get call,
+   * instead of one call per attribute. This is what makes reloading objects
+   * with many attributes (e.g., on warm boot) cheap.
+   *
+   * List attributes are left out of the bulk call: their buffers may need to
+   * be sized by the adapter first (SAI_STATUS_BUFFER_OVERFLOW), so they still
+   * go through the single attribute getAttribute.
+   *
+   * Returns false, without touching attrTuple, if the adapter rejects the
+   * multi-attribute get. The caller then falls back to getting each attribute
+   * individually. If the adapter reports that it does not support
+   * multi-attribute gets at all, we stop trying for this api.
+   */
+  template <typename AdapterKeyT, typename TupleT>
+  bool getAttributesBulk(const AdapterKeyT& key, TupleT& attrTuple) {
+    if (!bulkGetSupported_.load(std::memory_order_relaxed) ||
+        std::tuple_size_v<TupleT> < 2) {
+      return false;
+    }
+    std::vector<sai_attribute_t> saiAttributeTs;
+    saiAttributeTs.reserve(std::tuple_size_v<TupleT>);
+    tupleForEach(
+        [&saiAttributeTs](auto& attr) {
+          auto& a = bulkGetAttr(attr);
+          if constexpr (!IsSaiListAttribute<
+                            std::remove_reference_t<decltype(a)>>::value) {
+            saiAttributeTs.push_back(*a.saiAttr());
+          }
+        },
+        attrTuple);
+    if (saiAttributeTs.empty()) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+      sai_status_t status = impl()._getAttribute(
+          key, saiAttributeTs.data(), saiAttributeTs.size());
+      if (status != SAI_STATUS_SUCCESS) {
+        if (status == SAI_STATUS_NOT_SUPPORTED ||
+            status == SAI_STATUS_NOT_IMPLEMENTED) {
+          bulkGetSupported_.store(false, std::memory_order_relaxed);
+        }
+        XLOGF(
+            DBG2,
+            "multi-attribute get failed for {} with status {}, "
+            "falling back to single attribute gets",
+            key,
+            status);
+        return false;
+      }
+    }
+    auto itr = saiAttributeTs.begin();
+    tupleForEach(
+        [&key, &itr, this](auto& attr) {
+          auto& a = bulkGetAttr(attr);
+          if constexpr (IsSaiListAttribute<
+                            std::remove_reference_t<decltype(a)>>::value) {
+            getAttribute(key, a);
+          } else {
+            *a.saiAttr() = *itr++;
+          }
+        },
+        attrTuple);
+    XLOGF(DBG5, "got {} SAI attributes of {}", saiAttributeTs.size(), key);
+    return true;
+  }
+
   template <typename SaiObjectTraits>
   std::vector<uint64_t> getStatsImpl(
       const typename SaiObjectTraits::AdapterKey& key,
@@ -257,6 +344,10 @@ class SaiApi {
   const ApiT& impl() const {
     return static_cast<const ApiT&>(*this);
   }
+  // Read without holding the SaiApiLock by concurrent store reloads. It only
+  // ever goes from true to false, so a stale true just costs one more
+  // rejected multi-attribute get.
+  std::atomic<bool> bulkGetSupported_{true};
 };
 
 } // namespace facebook::fboss
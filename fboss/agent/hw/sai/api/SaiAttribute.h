@@ -455,6 +455,16 @@ template <typename AttrEnumT, AttrEnumT AttrEnum, typename DataT>
 struct IsSaiAttribute<SaiAttribute<AttrEnumT, AttrEnum, DataT, void>>
     : public std::true_type {};
 
+// implement trait that detects SaiAttributes holding a SAI list, whose
+// storage has to be sized before the adapter can fill it in
+template <typename T>
+struct IsSaiListAttribute : public std::false_type {};
+
+template <typename AttrEnumT, AttrEnumT AttrEnum, typename T>
+struct IsSaiListAttribute<
+    SaiAttribute<AttrEnumT, AttrEnum, std::vector<T>, void>>
+    : public std::true_type {};
+
 template <typename AttrT>
 struct AttributeName {
   // N.B., we can't just use static_assert(false, msg) because the
@@ -10,9 +10,11 @@
 #pragma once
 
 #include "fboss/agent/hw/sai/api/SaiApiError.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
 #include "fboss/agent/hw/sai/api/Traits.h"
 
+#include <mutex>
 #include <type_traits>
 
 extern "C" {
@@ -49,6 +51,7 @@ getAdapterKey(const sai_object_key_t& key) {
 template <typename SaiObjectTraits>
 uint32_t getObjectCount(sai_object_id_t switch_id) {
   uint32_t count = 0;
+  std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
   sai_status_t status =
       sai_get_object_count(switch_id, SaiObjectTraits::ObjectType, &count);
   saiCheckError(status, "Failed to get object count");
@@ -62,6 +65,7 @@ std::vector<typename SaiObjectTraits::AdapterKey> getObjectKeys(
   std::vector<sai_object_key_t> keys;
   uint32_t c = getObjectCount<SaiObjectTraits>(switch_id);
   keys.resize(c);
+  std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
 #if SAI_API_VERSION >= SAI_VERSION(1, 4, 0)
   sai_status_t status = sai_get_object_key(
       switch_id, SaiObjectTraits::ObjectType, &c, keys.data());
@@ -95,8 +95,11 @@ class SchedulerApi : public SaiApi<SchedulerApi> {
   sai_status_t _remove(SchedulerSaiId id) {
     return api_->remove_scheduler(id);
   }
-  sai_status_t _getAttribute(SchedulerSaiId id, sai_attribute_t* attr) const {
-    return api_->get_scheduler_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      SchedulerSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_scheduler_attribute(id, count, attr);
   }
   sai_status_t _setAttribute(SchedulerSaiId id, const sai_attribute_t* attr) {
     return api_->set_scheduler_attribute(id, attr);
@@ -194,8 +194,11 @@ class SwitchApi : public SaiApi<SwitchApi> {
   sai_status_t _remove(SwitchSaiId id) {
     return api_->remove_switch(id);
   }
-  sai_status_t _getAttribute(SwitchSaiId id, sai_attribute_t* attr) const {
-    return api_->get_switch_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      SwitchSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_switch_attribute(id, count, attr);
   }
   sai_status_t _setAttribute(SwitchSaiId id, const sai_attribute_t* attr) {
     return api_->set_switch_attribute(id, attr);
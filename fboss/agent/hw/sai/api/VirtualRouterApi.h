@@ -72,9 +72,11 @@ class VirtualRouterApi : public SaiApi<VirtualRouterApi> {
   sai_status_t _remove(VirtualRouterSaiId virtual_router_id) {
     return api_->remove_virtual_router(virtual_router_id);
   }
-  sai_status_t _getAttribute(VirtualRouterSaiId handle, sai_attribute_t* attr)
-      const {
-    return api_->get_virtual_router_attribute(handle, 1, attr);
+  sai_status_t _getAttribute(
+      VirtualRouterSaiId handle,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_virtual_router_attribute(handle, count, attr);
   }
   sai_status_t _setAttribute(
       VirtualRouterSaiId handle,
@@ -99,11 +99,17 @@ class VlanApi : public SaiApi<VlanApi> {
     return api_->remove_vlan_member(id);
   }
 
-  sai_status_t _getAttribute(VlanSaiId id, sai_attribute_t* attr) const {
-    return api_->get_vlan_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      VlanSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_vlan_attribute(id, count, attr);
   }
-  sai_status_t _getAttribute(VlanMemberSaiId id, sai_attribute_t* attr) const {
-    return api_->get_vlan_member_attribute(id, 1, attr);
+  sai_status_t _getAttribute(
+      VlanMemberSaiId id,
+      sai_attribute_t* attr,
+      uint32_t count) const {
+    return api_->get_vlan_member_attribute(id, count, attr);
   }
 
   sai_status_t _setAttribute(VlanSaiId id, const sai_attribute_t* attr) {
@@ -216,6 +216,40 @@ TEST_F(PortApiTest, setGetOptionalAttributes) {
   EXPECT_EQ(gotPortMtu, mtu);
 }
 
+TEST_F(PortApiTest, getAttributeTuple) {
+  std::vector<uint32_t> inLanes{0, 1, 2, 3};
+  auto portId = createPort(100000, inLanes, true);
+  sai_uint32_t mtu{9000};
+  portApi->setAttribute(portId, SaiPortTraits::Attributes::Mtu{mtu});
+  std::vector<uint32_t> preemphasis{42, 43};
+  portApi->setAttribute(
+      portId, SaiPortTraits::Attributes::Preemphasis{preemphasis});
+
+  // Non-list attributes are fetched in one multi-attribute get, the lists
+  // (lanes, preemphasis) individually.
+  auto gotAttributes =
+      portApi->getAttribute(portId, SaiPortTraits::CreateAttributes{});
+  EXPECT_EQ(
+      std::get<SaiPortTraits::Attributes::HwLaneList>(gotAttributes).value(),
+      inLanes);
+  EXPECT_EQ(
+      std::get<SaiPortTraits::Attributes::Speed>(gotAttributes).value(),
+      100000);
+  EXPECT_TRUE(
+      std::get<std::optional<SaiPortTraits::Attributes::AdminState>>(
+          gotAttributes)
+          ->value());
+  EXPECT_EQ(
+      std::get<std::optional<SaiPortTraits::Attributes::Mtu>>(gotAttributes)
+          ->value(),
+      mtu);
+  EXPECT_EQ(
+      std::get<std::optional<SaiPortTraits::Attributes::Preemphasis>>(
+          gotAttributes)
+          ->value(),
+      preemphasis);
+}
+
 // ObjectApi tests
 TEST_F(PortApiTest, portCount) {
   uint32_t count = getObjectCount<SaiPortTraits>(0);
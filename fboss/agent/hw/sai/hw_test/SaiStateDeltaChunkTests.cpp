@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/test/HwTest.h"
+
+#include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
+#include "fboss/agent/hw/sai/switch/SaiRouteManager.h"
+#include "fboss/agent/hw/sai/switch/SaiSwitch.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/RouteDistributionGenerator.h"
+
+#include <gflags/gflags.h>
+
+DECLARE_int32(sai_state_delta_chunk_size);
+
+namespace facebook::fboss {
+
+class SaiStateDeltaChunkTest : public HwTest {
+ protected:
+  void SetUp() override {
+    HwTest::SetUp();
+    // 50 routes take 7 chunks
+    FLAGS_sai_state_delta_chunk_size = 8;
+  }
+
+  SaiSwitch* getSaiSwitch() {
+    return static_cast<SaiSwitch*>(getHwSwitch());
+  }
+
+  static std::shared_ptr<RouteTableRib<folly::IPAddressV4>> getRib(
+      const std::shared_ptr<SwitchState>& state) {
+    return state->getRouteTables()->getRouteTable(RouterID(0))->getRibV4();
+  }
+
+  // Number of the routes in state but not in baseState that are programmed
+  size_t numProgrammedRoutes(
+      const std::shared_ptr<SwitchState>& state,
+      const std::shared_ptr<SwitchState>& baseState) {
+    auto& routeManager = getSaiSwitch()->managerTable()->routeManager();
+    auto baseRoutes = getRib(baseState)->routes();
+    size_t numProgrammed = 0;
+    for (const auto& route : *getRib(state)->routes()) {
+      if (baseRoutes->getNodeIf(route->prefix())) {
+        continue;
+      }
+      if (routeManager.getRouteHandle(
+              routeManager.routeEntryFromSwRoute(RouterID(0), route))) {
+        ++numProgrammed;
+      }
+    }
+    return numProgrammed;
+  }
+
+  gflags::FlagSaver flagSaver_;
+};
+
+TEST_F(SaiStateDeltaChunkTest, multiChunkDelta) {
+  applyNewConfig(
+      utility::onePortPerVlanConfig(getHwSwitch(), masterLogicalPortIds()));
+  auto startingState = getProgrammedState();
+  // One state adding all routes, i.e. a single delta
+  auto states = utility::RouteDistributionGenerator(
+                    startingState, {}, {{24, 50}}, 50, 4)
+                    .getSwitchStates();
+  ASSERT_EQ(states.size(), 1);
+  auto routesState = states.back();
+
+  applyNewState(routesState);
+  auto numRoutes = getRib(routesState)->size() - getRib(startingState)->size();
+  EXPECT_EQ(numRoutes, 50);
+  EXPECT_EQ(numProgrammedRoutes(routesState, startingState), numRoutes);
+
+  // Removing them is chunked just the same
+  applyNewState(startingState);
+  EXPECT_EQ(numProgrammedRoutes(routesState, startingState), 0);
+}
+
+} // namespace facebook::fboss
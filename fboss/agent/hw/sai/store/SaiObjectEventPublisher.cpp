@@ -18,4 +18,14 @@ SaiObjectEventPublisher::getInstance() {
   return kSingleton.try_get();
 }
 
+SaiObjectEventStats SaiObjectEventPublisher::getStats() const {
+  SaiObjectEventStats stats;
+  std::apply(
+      [&stats](const auto&... publisher) {
+        (stats.merge(publisher.getStats()), ...);
+      },
+      publishers_);
+  return stats;
+}
+
 } // namespace facebook::fboss
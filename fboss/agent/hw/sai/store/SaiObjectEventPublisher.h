@@ -2,7 +2,13 @@
 
 #pragma once
 
-#include <boost/signals2.hpp>
+#include <boost/intrusive/list.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "fboss/agent/hw/sai/api/NeighborApi.h"
 #include "fboss/agent/hw/sai/api/NextHopApi.h"
@@ -37,6 +43,26 @@ struct IsObjectPublisher<SaiNeighborTraits> : std::true_type {};
 template <typename>
 class SaiObject;
 
+/* Counters about how publisher events fan out to subscribers */
+struct SaiObjectEventStats {
+  // create or remove events of publishers with subscribers
+  uint64_t events{0};
+  // create events folded into a later event of the same publisher within a
+  // batch
+  uint64_t coalesced{0};
+  // afterCreate and beforeRemove calls made on subscribers
+  uint64_t notifications{0};
+  // most subscribers notified for a single publisher event
+  uint64_t maxFanOut{0};
+
+  void merge(const SaiObjectEventStats& other) {
+    events += other.events;
+    coalesced += other.coalesced;
+    notifications += other.notifications;
+    maxFanOut = std::max(maxFanOut, other.maxFanOut);
+  }
+};
+
 namespace detail {
 /* publisher mechanism
  * 1) provide interface to publishers to notify subscribers
@@ -46,7 +72,17 @@ namespace detail {
  * subscribers
  * 5) tracks live publishers, this is done to handle situation if
  * subscribers come after publishers without having subscribers to actively poll
- * publisher */
+ * publisher
+ * 6) while batching, defers create notifications until the batch ends, and
+ * only delivers the final state of each publisher then. Remove
+ * notifications are never deferred: publishers notify before they are
+ * removed from the adapter, so that subscribers referencing them (e.g. next
+ * hops of a neighbor and their group members) are removed first.
+ * Coalescing is per publisher key, not per subscriber: a next hop group whose
+ * neighbors are removed and added back within a batch still loses each of
+ * those members right away, and gets them back at the end of the batch.
+ *
+ * All of this runs under the SAI switch lock, so there is no locking here. */
 template <typename PublishedObjectTrait>
 class SaiObjectEventPublisher {
  public:
@@ -56,79 +92,129 @@ class SaiObjectEventPublisher {
   using PublisherObject = const SaiObject<PublishedObjectTrait>;
 
  private:
-  class Subscription {
-    // a subscription, using boost signals since they are fast in issuing
-    // notifications to large number of subscribers, thread safe, re-entrant.
-    template <typename T>
-    using CreateSignal =
-        boost::signals2::signal<void(std::shared_ptr<const T>)>;
-    CreateSignal<SaiObject<PublishedObjectTrait>> createSignal_;
-    using CreateSignalSlot =
-        typename CreateSignal<SaiObject<PublishedObjectTrait>>::slot_type;
-
-    using RemoveSignal = boost::signals2::signal<void()>;
-    RemoveSignal removeSignal_;
-    using RemoveSignalSlot = typename RemoveSignal::slot_type;
-
-    friend class SaiObjectEventPublisher<PublishedObjectTrait>;
+  struct Subscription {
+    // subscribers unlink themselves when destroyed, see
+    // SaiObjectEventSubscriber
+    boost::intrusive::list<
+        Subscriber,
+        boost::intrusive::constant_time_size<false>>
+        subscribers;
   };
 
  public:
   void subscribe(std::weak_ptr<Subscriber> subscriberWeakPtr) {
     auto subscriber = subscriberWeakPtr.lock(); // non-owning reference
     CHECK(subscriber);
-    auto result =
-        subscriptions_.refOrEmplace(subscriber->getPublisherAttributes());
-
-    auto subscription = result.first;
-
-    // add a subscriber here for create or remove notifications.
-    // subscriptions are self managed, because they're put in ref map.
-    // further if subscriber gets removed, its not notified because
-    // "track_foreign" will delete its slot in general following principles hold
+    // subscriptions are self managed, because they're put in ref map. In
+    // general following principles hold
     // 1. a subscription exists only if at least one subscriber exists
     // 2. a subscription is deleted if no subscriber exists
-    // 3. a slot for subscriber in subscription is freed if subscriber is
-    // removed.
-    // 4. a subscriber is not notified only if it exists
-    typename Subscription::CreateSignalSlot createSignalSlot = std::bind(
-        &Subscriber::afterCreate, subscriber.get(), std::placeholders::_1);
-    subscription->createSignal_.connect(
-        createSignalSlot.track_foreign(subscriberWeakPtr));
-
-    typename Subscription::RemoveSignalSlot removeSignalSlot =
-        std::bind(&Subscriber::beforeRemove, subscriber.get());
-    subscription->removeSignal_.connect(
-        removeSignalSlot.track_foreign(subscriberWeakPtr));
-    subscriber->saveSubscription(subscription);
+    // 3. a subscriber leaves its subscription when it is removed
+    // 4. a subscriber is in its subscription only once, subscribing it
+    // again only catches it up with the publisher
+    if (!subscriber->is_linked()) {
+      auto result =
+          subscriptions_.refOrEmplace(subscriber->getPublisherAttributes());
+      auto subscription = result.first;
+      subscription->subscribers.push_back(*subscriber);
+      subscriber->saveSubscription(subscription, subscriberWeakPtr);
+    }
     // check if publisher is already live
     auto publisher = livePublishers_.find(subscriber->getPublisherAttributes());
     if (publisher != livePublishers_.end()) {
-      notifyCreate(publisher->first, publisher->second.lock());
+      auto object = publisher->second.lock();
+      if (object && subscriber->getPublisherObject().lock() != object) {
+        subscriber->afterCreate(object);
+        ++stats_.notifications;
+      }
     }
   }
 
   void notifyCreate(Key key, const std::shared_ptr<PublisherObject> object) {
-    livePublishers_.emplace(key, object);
-    auto subscription = subscriptions_.get(key);
-    if (!subscription) {
-      return;
-    }
-    subscription->createSignal_(object);
+    livePublishers_.insert_or_assign(key, object);
+    publish(key, true /* deferrable */);
   }
 
   void notifyDelete(Key key) {
+    livePublishers_.erase(key);
+    publish(key, false /* deferrable */);
+  }
+
+  void startBatch() {
+    batching_ = true;
+  }
+
+  void endBatch() {
+    batching_ = false;
+    auto pending = std::move(pending_);
+    pending_.clear();
+    pendingKeys_.clear();
+    for (const auto& key : pending) {
+      if (auto subscription = subscriptions_.get(key)) {
+        notifySubscribers(key, *subscription);
+      }
+    }
+  }
+
+  const SaiObjectEventStats& getStats() const {
+    return stats_;
+  }
+
+ private:
+  void publish(const Key& key, bool deferrable) {
     auto subscription = subscriptions_.get(key);
     if (!subscription) {
       return;
     }
-    subscription->removeSignal_();
-    livePublishers_.erase(key);
+    ++stats_.events;
+    if (batching_ && deferrable) {
+      if (pendingKeys_.insert(key).second) {
+        pending_.push_back(key);
+      } else {
+        ++stats_.coalesced;
+      }
+      return;
+    }
+    notifySubscribers(key, *subscription);
+  }
+
+  // bring every subscriber of key in line with the current publisher
+  void notifySubscribers(const Key& key, Subscription& subscription) {
+    std::shared_ptr<PublisherObject> object;
+    auto publisher = livePublishers_.find(key);
+    if (publisher != livePublishers_.end()) {
+      object = publisher->second.lock();
+    }
+    // notifications may subscribe or destroy other subscribers, so keep
+    // the ones we are about to notify alive
+    std::vector<std::shared_ptr<Subscriber>> subscribers;
+    for (auto& subscriber : subscription.subscribers) {
+      if (auto locked = subscriber.lockSelf()) {
+        subscribers.push_back(std::move(locked));
+      }
+    }
+    uint64_t fanOut = 0;
+    for (const auto& subscriber : subscribers) {
+      if (object) {
+        if (subscriber->getPublisherObject().lock() != object) {
+          subscriber->afterCreate(object);
+          ++fanOut;
+        }
+      } else if (subscriber->hasPublisherObject()) {
+        subscriber->beforeRemove();
+        ++fanOut;
+      }
+    }
+    stats_.notifications += fanOut;
+    stats_.maxFanOut = std::max(stats_.maxFanOut, fanOut);
   }
 
- private:
   std::unordered_map<Key, std::weak_ptr<PublisherObject>> livePublishers_;
   UnorderedRefMap<Key, Subscription> subscriptions_;
+  bool batching_{false};
+  std::vector<Key> pending_;
+  std::unordered_set<Key> pendingKeys_;
+  SaiObjectEventStats stats_;
 };
 
 } // namespace detail
@@ -164,12 +250,45 @@ class SaiObjectEventPublisher {
         publishers_);
   }
 
+  /*
+   * Run fn with create notifications deferred until it returns, e.g. while
+   * processing a state delta. Neighbors are flushed before next hops, so
+   * next hop changes caused by neighbor changes are batched as well.
+   * Remove notifications are still delivered right away, so this does not
+   * cap the updates of a next hop group to one per batch.
+   */
+  template <typename Fn>
+  void batchNotifications(Fn&& fn) {
+    if (batchDepth_++ == 0) {
+      std::apply([](auto&... publisher) { (publisher.startBatch(), ...); },
+                 publishers_);
+    }
+    try {
+      fn();
+    } catch (...) {
+      endBatch();
+      throw;
+    }
+    endBatch();
+  }
+
+  SaiObjectEventStats getStats() const;
+
  private:
+  void endBatch() {
+    if (--batchDepth_ == 0) {
+      std::apply([](auto&... publisher) { (publisher.endBatch(), ...); },
+                 publishers_);
+    }
+  }
+
+  // flushed in this order at the end of a batch
   std::tuple<
       detail::SaiObjectEventPublisher<SaiNeighborTraits>,
       detail::SaiObjectEventPublisher<SaiIpNextHopTraits>,
       detail::SaiObjectEventPublisher<SaiMplsNextHopTraits>>
       publishers_;
+  int batchDepth_{0};
 };
 
 } // namespace facebook::fboss
@@ -14,7 +14,10 @@ SaiObjectEventSubscriber<PublishedObjectTrait>::SaiObjectEventSubscriber(
     : publisherAttrs_(attr) {}
 
 template <typename PublishedObjectTrait>
-SaiObjectEventSubscriber<PublishedObjectTrait>::~SaiObjectEventSubscriber() {}
+SaiObjectEventSubscriber<PublishedObjectTrait>::~SaiObjectEventSubscriber() {
+  // leave the subscription before releasing our reference to it
+  this->unlink();
+}
 
 template <typename PublishedObjectTrait>
 typename SaiObjectEventSubscriber<PublishedObjectTrait>::PublisherObjectWeakPtr
@@ -26,6 +29,7 @@ template <typename PublishedObjectTrait>
 void SaiObjectEventSubscriber<PublishedObjectTrait>::setPublisherObject(
     PublisherObjectSharedPtr object) {
   publisherObject_ = object;
+  hasPublisherObject_ = object != nullptr;
 }
 } // namespace detail
 
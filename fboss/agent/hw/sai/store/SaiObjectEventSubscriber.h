@@ -6,6 +6,8 @@
 #include <any>
 #include <memory>
 
+#include <boost/intrusive/list_hook.hpp>
+
 #include "fboss/agent/hw/sai/store/Traits.h"
 #include "fboss/lib/TupleUtils.h"
 
@@ -20,9 +22,13 @@ namespace detail {
  * afterCreate and beforeRemove methods are invoked by publishers after and
  * before publishers are created or removed respectively.
  * saveSubscription  is invoked by publisher to save subscription.
+ * Subscribers are kept in an intrusive list by the publisher, and unlink
+ * themselves from it when destroyed.
  */
 template <typename PublisherObjectTraits>
-struct SaiObjectEventSubscriber {
+struct SaiObjectEventSubscriber
+    : public boost::intrusive::list_base_hook<
+          boost::intrusive::link_mode<boost::intrusive::auto_unlink>> {
   using PublisherObjectSharedPtr =
       std::shared_ptr<const SaiObject<PublisherObjectTraits>>;
   using PublisherObjectWeakPtr =
@@ -39,11 +45,24 @@ struct SaiObjectEventSubscriber {
   /* return non-owning reference to monitored object */
   PublisherObjectWeakPtr getPublisherObject() const;
 
+  /* whether the last notification this subscriber got was a create */
+  bool hasPublisherObject() const {
+    return hasPublisherObject_;
+  }
+
   virtual void afterCreate(PublisherObjectSharedPtr) = 0;
   virtual void beforeRemove() = 0;
 
-  void saveSubscription(std::any subscription) {
+  void saveSubscription(
+      std::any subscription,
+      std::weak_ptr<SaiObjectEventSubscriber> self) {
     subscription_ = std::move(subscription);
+    self_ = std::move(self);
+  }
+
+  /* owning reference held by publisher while notifying */
+  std::shared_ptr<SaiObjectEventSubscriber> lockSelf() const {
+    return self_.lock();
   }
 
  protected:
@@ -52,6 +71,8 @@ struct SaiObjectEventSubscriber {
  private:
   typename PublisherAttributes<PublisherObjectTraits>::type publisherAttrs_;
   PublisherObjectWeakPtr publisherObject_;
+  bool hasPublisherObject_{false};
+  std::weak_ptr<SaiObjectEventSubscriber> self_;
   // TODO(pshaikh): this is currently maintained as any to break circular
   // dependencies in object, publisher, and subscriber types investigate and
   // eliminate this any type with proper type
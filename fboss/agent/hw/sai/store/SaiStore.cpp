@@ -11,6 +11,21 @@
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 
 #include <folly/Singleton.h>
+#include <folly/logging/xlog.h>
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+DEFINE_int32(
+    sai_store_reload_threads,
+    4,
+    "Number of threads used to reload SAI object types concurrently");
 
 namespace {
 struct singleton_tag_type {};
@@ -37,13 +52,59 @@ void SaiStore::setSwitchId(sai_object_id_t switchId) {
 }
 
 void SaiStore::reload(const folly::dynamic* adapterKeysJson) {
+  std::vector<std::function<void()>> reloadFns;
+  std::vector<std::pair<std::string, std::chrono::microseconds>> reloadTimes;
   tupleForEach(
-      [adapterKeysJson](auto& store) {
-        store.reload(
-            adapterKeysJson ? &((*adapterKeysJson)[store.objectTypeName()])
-                            : nullptr);
+      [adapterKeysJson, &reloadFns, &reloadTimes](auto& store) {
+        auto idx = reloadTimes.size();
+        reloadTimes.emplace_back(
+            store.objectTypeName().str(), std::chrono::microseconds(0));
+        reloadFns.emplace_back([adapterKeysJson, &store, &reloadTimes, idx]() {
+          auto begin = std::chrono::steady_clock::now();
+          store.reload(
+              adapterKeysJson ? &((*adapterKeysJson)[store.objectTypeName()])
+                              : nullptr);
+          reloadTimes[idx].second =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - begin);
+        });
       },
       stores_);
+
+  std::atomic<size_t> next{0};
+  std::vector<std::exception_ptr> errors(reloadFns.size());
+  auto worker = [&reloadFns, &errors, &next]() {
+    for (auto i = next++; i < reloadFns.size(); i = next++) {
+      try {
+        reloadFns[i]();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  auto numThreads = std::min<size_t>(
+      std::max(FLAGS_sai_store_reload_threads, 1), reloadFns.size());
+  std::vector<std::thread> threads;
+  // The calling thread is one of the workers
+  for (size_t i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  reloadTimes_.clear();
+  for (const auto& [objectTypeName, reloadTime] : reloadTimes) {
+    XLOG(DBG2) << "SaiStore reloaded " << objectTypeName << " in "
+               << reloadTime.count() << "us";
+    reloadTimes_[objectTypeName] += reloadTime;
+  }
 }
 
 void SaiStore::release() {
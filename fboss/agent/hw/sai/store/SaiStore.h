@@ -22,8 +22,11 @@
 
 #include <folly/dynamic.h>
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <optional>
+#include <string>
 
 extern "C" {
 #include <sai.h>
@@ -208,9 +211,22 @@ class SaiStore {
 
   /*
    * Reload the SaiStore from the current SAI state via SAI api calls.
+   *
+   * Objects are loaded purely from the adapter (keys and attributes), so no
+   * SaiObjectStore depends on the contents of another one while reloading.
+   * The object types are therefore reloaded concurrently, on up to
+   * FLAGS_sai_store_reload_threads threads.
    */
   void reload(const folly::dynamic* adapterKeys = nullptr);
 
+  /*
+   * Time spent reloading each object type in the last reload(), keyed by
+   * object type name.
+   */
+  std::map<std::string, std::chrono::microseconds> getReloadTimes() const {
+    return reloadTimes_;
+  }
+
   /*
    *
    */
@@ -227,6 +243,7 @@ class SaiStore {
 
  private:
   sai_object_id_t switchId_{};
+  std::map<std::string, std::chrono::microseconds> reloadTimes_;
   std::tuple<
       detail::SaiObjectStore<SaiBridgeTraits>,
       detail::SaiObjectStore<SaiBridgePortTraits>,
@@ -127,22 +127,43 @@ void SaiNeighborManager::removeNeighbor(
 }
 
 void SaiNeighborManager::processNeighborDelta(const StateDelta& delta) {
+  for (const auto& change : getNeighborDeltaChanges(delta)) {
+    change();
+  }
+}
+
+std::vector<std::function<void()>> SaiNeighborManager::getNeighborDeltaChanges(
+    const StateDelta& delta) {
+  std::vector<std::function<void()>> changes;
+  auto processChanged = [this, &changes](
+                            const auto& oldNeighbor, const auto& newNeighbor) {
+    changes.emplace_back([this, oldNeighbor, newNeighbor]() {
+      changeNeighbor(oldNeighbor, newNeighbor);
+    });
+  };
+  auto processAdded = [this, &changes](const auto& newNeighbor) {
+    changes.emplace_back([this, newNeighbor]() { addNeighbor(newNeighbor); });
+  };
+  auto processRemoved = [this, &changes](const auto& oldNeighbor) {
+    changes.emplace_back(
+        [this, oldNeighbor]() { removeNeighbor(oldNeighbor); });
+  };
   for (const auto& vlanDelta : delta.getVlansDelta()) {
-    auto processChanged =
-        [this](const auto& oldNeighbor, const auto& newNeighbor) {
-          changeNeighbor(oldNeighbor, newNeighbor);
-        };
-    auto processAdded = [this](const auto& newNeighbor) {
-      addNeighbor(newNeighbor);
-    };
-    auto processRemoved = [this](const auto& oldNeighbor) {
-      removeNeighbor(oldNeighbor);
-    };
     DeltaFunctions::forEachChanged(
         vlanDelta.getArpDelta(), processChanged, processAdded, processRemoved);
     DeltaFunctions::forEachChanged(
         vlanDelta.getNdpDelta(), processChanged, processAdded, processRemoved);
   }
+  return changes;
+}
+
+std::vector<folly::IPAddress> SaiNeighborManager::getHitNeighbors() const {
+  std::vector<folly::IPAddress> hits;
+  hits.reserve(handles_.size());
+  for (const auto& entryAndHandle : handles_) {
+    hits.push_back(entryAndHandle.first.ip());
+  }
+  return hits;
 }
 
 void SaiNeighborManager::clear() {
@@ -19,7 +19,9 @@
 
 #include "folly/container/F14Map.h"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -62,6 +64,21 @@ class SaiNeighborManager {
       const SaiNeighborTraits::NeighborEntry& entry) const;
 
   void processNeighborDelta(const StateDelta& delta);
+
+  /*
+   * IPs of the programmed neighbors that have been hit. SAI exposes no
+   * neighbor hit bit, so like SaiSwitch::getAndClearNeighborHit this treats
+   * every resolved neighbor as hit, but in one pass over the table.
+   */
+  std::vector<folly::IPAddress> getHitNeighbors() const;
+
+  /*
+   * Rather than programming the neighbor changes in delta, return one closure
+   * per changed neighbor which programs it. This lets SaiSwitch program large
+   * deltas in chunks and release its lock in between.
+   */
+  std::vector<std::function<void()>> getNeighborDeltaChanges(
+      const StateDelta& delta);
   void clear();
 
  private:
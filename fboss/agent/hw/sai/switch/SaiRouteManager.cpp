@@ -226,6 +226,14 @@ void SaiRouteManager::removeRoute(
 }
 
 void SaiRouteManager::processRouteDelta(const StateDelta& delta) {
+  for (const auto& change : getRouteDeltaChanges(delta)) {
+    change();
+  }
+}
+
+std::vector<std::function<void()>> SaiRouteManager::getRouteDeltaChanges(
+    const StateDelta& delta) {
+  std::vector<std::function<void()>> changes;
   for (const auto& routeDelta : delta.getRouteTablesDelta()) {
     RouterID routerId;
     if (routeDelta.getOld()) {
@@ -233,15 +241,19 @@ void SaiRouteManager::processRouteDelta(const StateDelta& delta) {
     } else {
       routerId = routeDelta.getNew()->getID();
     }
-    auto processChanged = [this, routerId](
+    auto processChanged = [this, routerId, &changes](
                               const auto& oldRoute, const auto& newRoute) {
-      changeRoute(routerId, oldRoute, newRoute);
+      changes.emplace_back([this, routerId, oldRoute, newRoute]() {
+        changeRoute(routerId, oldRoute, newRoute);
+      });
     };
-    auto processAdded = [this, routerId](const auto& newRoute) {
-      addRoute(routerId, newRoute);
+    auto processAdded = [this, routerId, &changes](const auto& newRoute) {
+      changes.emplace_back(
+          [this, routerId, newRoute]() { addRoute(routerId, newRoute); });
     };
-    auto processRemoved = [this, routerId](const auto& oldRoute) {
-      removeRoute(routerId, oldRoute);
+    auto processRemoved = [this, routerId, &changes](const auto& oldRoute) {
+      changes.emplace_back(
+          [this, routerId, oldRoute]() { removeRoute(routerId, oldRoute); });
     };
     DeltaFunctions::forEachChanged(
         routeDelta.getRoutesV4Delta(),
@@ -254,6 +266,7 @@ void SaiRouteManager::processRouteDelta(const StateDelta& delta) {
         processAdded,
         processRemoved);
   }
+  return changes;
 }
 
 SaiRouteHandle* SaiRouteManager::getRouteHandle(
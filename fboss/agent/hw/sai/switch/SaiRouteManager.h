@@ -18,7 +18,9 @@
 
 #include "folly/container/F14Map.h"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -64,6 +66,14 @@ class SaiRouteManager {
 
   void processRouteDelta(const StateDelta& delta);
 
+  /*
+   * Rather than programming the route changes in delta, return one closure
+   * per changed route which programs it. This lets SaiSwitch program large
+   * deltas in chunks and release its lock in between.
+   */
+  std::vector<std::function<void()>> getRouteDeltaChanges(
+      const StateDelta& delta);
+
   SaiRouteHandle* getRouteHandle(const SaiRouteTraits::RouteEntry& entry);
   const SaiRouteHandle* getRouteHandle(
       const SaiRouteTraits::RouteEntry& entry) const;
@@ -11,6 +11,7 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/TxPacketBufferPool.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/hw/sai/api/AdapterKeySerializers.h"
 #include "fboss/agent/hw/sai/api/FdbApi.h"
@@ -19,6 +20,7 @@
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
+#include "fboss/agent/hw/sai/store/SaiObjectEventPublisher.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiHashManager.h"
@@ -43,8 +45,13 @@
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <optional>
 
 extern "C" {
@@ -52,6 +59,35 @@ extern "C" {
 }
 
 DEFINE_bool(enable_sai_debug_log, false, "Turn on SAI debugging logging");
+DEFINE_int32(
+    sai_state_delta_chunk_size,
+    1000,
+    "Max number of neighbor and route changes programmed while holding the "
+    "SAI switch lock. The lock is released between chunks of a large state "
+    "delta. 0 programs the whole delta under a single hold of the lock.");
+
+namespace {
+constexpr auto kStateDeltaChunkSize = "sai_switch.state_delta_chunk_size";
+constexpr auto kStateDeltaLockHoldUsecs =
+    "sai_switch.state_delta_lock_hold_usecs";
+constexpr auto kStateDeltaMaxLockHoldUsecs =
+    "sai_switch.state_delta_max_lock_hold_usecs";
+constexpr auto kObjectEvents = "sai_switch.object_events";
+constexpr auto kObjectEventsCoalesced = "sai_switch.object_events_coalesced";
+constexpr auto kObjectEventNotifications =
+    "sai_switch.object_event_notifications";
+constexpr auto kObjectEventMaxFanOut = "sai_switch.object_event_max_fan_out";
+
+void publishObjectEventStats() {
+  auto stats =
+      facebook::fboss::SaiObjectEventPublisher::getInstance()->getStats();
+  facebook::fb303::fbData->setCounter(kObjectEvents, stats.events);
+  facebook::fb303::fbData->setCounter(kObjectEventsCoalesced, stats.coalesced);
+  facebook::fb303::fbData->setCounter(
+      kObjectEventNotifications, stats.notifications);
+  facebook::fb303::fbData->setCounter(kObjectEventMaxFanOut, stats.maxFanOut);
+}
+} // namespace
 
 namespace facebook::fboss {
 
@@ -125,8 +161,12 @@ void SaiSwitch::unregisterCallbacks() noexcept {
 }
 
 std::shared_ptr<SwitchState> SaiSwitch::stateChanged(const StateDelta& delta) {
-  std::lock_guard<std::mutex> lock(saiSwitchMutex_);
-  return stateChangedLocked(lock, delta);
+  std::lock_guard<std::mutex> stateChangeLock(stateChangeMutex_);
+  if (FLAGS_sai_state_delta_chunk_size <= 0) {
+    std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+    return stateChangedLocked(lock, delta);
+  }
+  return stateChangedChunked(delta);
 }
 
 bool SaiSwitch::isValidStateUpdate(const StateDelta& delta) const {
@@ -198,6 +238,9 @@ void SaiSwitch::gracefulExit(folly::dynamic& switchState) {
     which is a deadlock.
   */
   stopNonCallbackThreads();
+  // Wait for a delta being programmed in chunks to be done, so we don't
+  // save a half programmed delta in the warm boot state
+  std::lock_guard<std::mutex> stateChangeLock(stateChangeMutex_);
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
   gracefulExitLocked(switchState, lock);
 }
@@ -214,6 +257,7 @@ void SaiSwitch::gracefulExitLocked(
 }
 
 folly::dynamic SaiSwitch::toFollyDynamic() const {
+  std::lock_guard<std::mutex> stateChangeLock(stateChangeMutex_);
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
   return toFollyDynamicLocked(lock);
 }
@@ -238,6 +282,12 @@ bool SaiSwitch::getAndClearNeighborHit(RouterID vrf, folly::IPAddress& ip) {
   return getAndClearNeighborHitLocked(lock, vrf, ip);
 }
 
+std::optional<std::vector<folly::IPAddress>>
+SaiSwitch::getAndClearNeighborHits(RouterID vrf) {
+  std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+  return getAndClearNeighborHitsLocked(lock, vrf);
+}
+
 void SaiSwitch::clearPortStats(
     const std::unique_ptr<std::vector<int32_t>>& ports) {
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
@@ -368,6 +418,13 @@ HwInitResult SaiSwitch::initLocked(
   saiStore->setSwitchId(switchId_);
   if (platform_->getObjectKeysSupported()) {
     saiStore->reload(adapterKeysJson.get());
+    for (const auto& [objectTypeName, reloadTime] :
+         saiStore->getReloadTimes()) {
+      fb303::fbData->setCounter(
+          folly::to<std::string>(
+              "sai_store_reload.", objectTypeName, ".usecs"),
+          reloadTime.count());
+    }
   }
   managerTable_->createSaiTableManagers(platform_, concurrentIndices_.get());
   callback_ = callback;
@@ -457,18 +514,86 @@ void SaiSwitch::unregisterCallbacksLocked(
 std::shared_ptr<SwitchState> SaiSwitch::stateChangedLocked(
     const std::lock_guard<std::mutex>& lock,
     const StateDelta& delta) {
+  // Neighbor and next hop creations are delivered once the whole delta is
+  // programmed, removals right away, see SaiObjectEventPublisher
+  SaiObjectEventPublisher::getInstance()->batchNotifications([&]() {
+    processDeltaBeforeNeighborsLocked(lock, delta);
+    managerTableLocked(lock)->neighborManager().processNeighborDelta(delta);
+    managerTableLocked(lock)->routeManager().processRouteDelta(delta);
+    processDeltaAfterRoutesLocked(lock, delta);
+  });
+  publishObjectEventStats();
+  return delta.newState();
+}
+
+std::shared_ptr<SwitchState> SaiSwitch::stateChangedChunked(
+    const StateDelta& delta) {
+  std::chrono::microseconds maxLockHold{0};
+  auto programLocked = [this, &maxLockHold](const auto& programFn) {
+    std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+    auto begin = std::chrono::steady_clock::now();
+    // Batch object create events per chunk, they must be delivered before
+    // the lock is released
+    SaiObjectEventPublisher::getInstance()->batchNotifications(
+        [&]() { programFn(lock); });
+    auto lockHold = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin);
+    fb303::fbData->addStatValue(
+        kStateDeltaLockHoldUsecs, lockHold.count(), fb303::AVG);
+    maxLockHold = std::max(maxLockHold, lockHold);
+  };
+
+  std::vector<std::function<void()>> changes;
+  programLocked([this, &delta, &changes](const auto& lock) {
+    processDeltaBeforeNeighborsLocked(lock, delta);
+    auto managers = managerTableLocked(lock);
+    changes = managers->neighborManager().getNeighborDeltaChanges(delta);
+    auto routeChanges = managers->routeManager().getRouteDeltaChanges(delta);
+    changes.insert(
+        changes.end(),
+        std::make_move_iterator(routeChanges.begin()),
+        std::make_move_iterator(routeChanges.end()));
+  });
+
+  size_t chunkSize = FLAGS_sai_state_delta_chunk_size;
+  for (size_t begin = 0; begin < changes.size(); begin += chunkSize) {
+    auto end = std::min(begin + chunkSize, changes.size());
+    programLocked([&changes, begin, end](const auto& /* lock */) {
+      for (auto i = begin; i < end; ++i) {
+        changes[i]();
+      }
+    });
+    fb303::fbData->addStatValue(kStateDeltaChunkSize, end - begin, fb303::AVG);
+  }
+
+  programLocked([this, &delta](const auto& lock) {
+    processDeltaAfterRoutesLocked(lock, delta);
+  });
+  {
+    std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+    publishObjectEventStats();
+  }
+  fb303::fbData->setCounter(kStateDeltaMaxLockHoldUsecs, maxLockHold.count());
+  return delta.newState();
+}
+
+void SaiSwitch::processDeltaBeforeNeighborsLocked(
+    const std::lock_guard<std::mutex>& lock,
+    const StateDelta& delta) {
   managerTableLocked(lock)->portManager().processPortDelta(delta);
   managerTableLocked(lock)->vlanManager().processVlanDelta(
       delta.getVlansDelta());
   managerTableLocked(lock)->routerInterfaceManager().processInterfaceDelta(
       delta);
-  managerTableLocked(lock)->neighborManager().processNeighborDelta(delta);
-  managerTableLocked(lock)->routeManager().processRouteDelta(delta);
+}
+
+void SaiSwitch::processDeltaAfterRoutesLocked(
+    const std::lock_guard<std::mutex>& lock,
+    const StateDelta& delta) {
   managerTableLocked(lock)->hostifManager().processHostifDelta(delta);
   managerTableLocked(lock)->inSegEntryManager().processInSegEntryDelta(
       delta.getLabelForwardingInformationBaseDelta());
   managerTableLocked(lock)->switchManager().processLoadBalancerDelta(delta);
-  return delta.newState();
 }
 
 bool SaiSwitch::isValidStateUpdateLocked(
@@ -605,6 +730,7 @@ void SaiSwitch::updateStatsLocked(
     const std::lock_guard<std::mutex>& /* lock */,
     SwitchStats* /* switchStats */) {
   managerTable_->portManager().updateStats();
+  TxPacketBufferPool::get().publishStats();
   managerTable_->hostifManager().updateStats();
 }
 
@@ -716,6 +842,12 @@ bool SaiSwitch::getAndClearNeighborHitLocked(
   return true;
 }
 
+std::vector<folly::IPAddress> SaiSwitch::getAndClearNeighborHitsLocked(
+    const std::lock_guard<std::mutex>& /* lock */,
+    RouterID /* vrf */) {
+  return managerTable_->neighborManager().getHitNeighbors();
+}
+
 void SaiSwitch::clearPortStatsLocked(
     const std::lock_guard<std::mutex>& /* lock */,
     const std::unique_ptr<std::vector<int32_t>>& /* ports */) {}
@@ -75,6 +75,9 @@ class SaiSwitch : public HwSwitch {
 
   bool getAndClearNeighborHit(RouterID vrf, folly::IPAddress& ip) override;
 
+  std::optional<std::vector<folly::IPAddress>> getAndClearNeighborHits(
+      RouterID vrf) override;
+
   void clearPortStats(
       const std::unique_ptr<std::vector<int32_t>>& ports) override;
 
@@ -144,6 +147,25 @@ class SaiSwitch : public HwSwitch {
       const std::lock_guard<std::mutex>& lock,
       const StateDelta& delta);
 
+  /*
+   * Program a StateDelta without holding saiSwitchMutex_ for all of it.
+   * Ports, vlans and router interfaces are programmed under one hold of the
+   * lock. Neighbor and route changes are then programmed in chunks of at
+   * most FLAGS_sai_state_delta_chunk_size changes, releasing the lock
+   * between chunks, so stats collection, packet tx and thrift getters are
+   * not stalled for the duration of large deltas. Called with
+   * stateChangeMutex_ held for the whole delta.
+   */
+  std::shared_ptr<SwitchState> stateChangedChunked(const StateDelta& delta);
+
+  void processDeltaBeforeNeighborsLocked(
+      const std::lock_guard<std::mutex>& lock,
+      const StateDelta& delta);
+
+  void processDeltaAfterRoutesLocked(
+      const std::lock_guard<std::mutex>& lock,
+      const StateDelta& delta);
+
   bool isValidStateUpdateLocked(
       const std::lock_guard<std::mutex>& lock,
       const StateDelta& delta) const;
@@ -200,6 +222,10 @@ class SaiSwitch : public HwSwitch {
       RouterID vrf,
       folly::IPAddress& ip);
 
+  std::vector<folly::IPAddress> getAndClearNeighborHitsLocked(
+      const std::lock_guard<std::mutex>& lock,
+      RouterID vrf);
+
   void clearPortStatsLocked(
       const std::lock_guard<std::mutex>& lock,
       const std::unique_ptr<std::vector<int32_t>>& ports);
@@ -246,6 +272,15 @@ class SaiSwitch : public HwSwitch {
    * packet without blocking normal hardware programming.
    */
   mutable std::mutex saiSwitchMutex_;
+  /*
+   * Held for the whole of a state delta, across the chunks it may be
+   * programmed in, and by whatever must not see half of a delta, i.e.
+   * graceful exit and dumping the warm boot state. Stats collection and
+   * packet tx only take saiSwitchMutex_, and link state callbacks only pass
+   * the port status on: none of them touch the neighbors and routes
+   * programmed in chunks. Always taken before saiSwitchMutex_.
+   */
+  mutable std::mutex stateChangeMutex_;
   std::unique_ptr<ConcurrentIndices> concurrentIndices_;
 
   /*
@@ -9,6 +9,7 @@
  */
 
 #include "fboss/agent/hw/sai/switch/SaiTxPacket.h"
+#include "fboss/agent/TxPacketBufferPool.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
 
 #include <folly/io/IOBuf.h>
@@ -16,7 +17,7 @@
 namespace facebook::fboss {
 
 SaiTxPacket::SaiTxPacket(uint32_t size) {
-  buf_ = folly::IOBuf::createSeparate(size);
+  buf_ = TxPacketBufferPool::get().allocate(size);
   buf_->append(size);
 }
 
@@ -104,6 +104,17 @@ TEST_F(NeighborManagerTest, unresolveNeighbor) {
   checkMissing(pendingEntry);
 }
 
+TEST_F(NeighborManagerTest, getHitNeighbors) {
+  auto arpEntry = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry);
+  auto pendingEntry = makePendingArpEntry(intf0.id, intf0.remoteHosts[1]);
+  saiManagerTable->neighborManager().addNeighbor(pendingEntry);
+  // Only programmed neighbors can be hit
+  auto hits = saiManagerTable->neighborManager().getHitNeighbors();
+  ASSERT_EQ(hits.size(), 1);
+  EXPECT_EQ(hits[0], h0.ip);
+}
+
 TEST_F(NeighborManagerTest, getNonexistentNeighbor) {
   auto arpEntry = makeArpEntry(intf0.id, h0);
   checkMissing(arpEntry);
@@ -10,6 +10,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/store/SaiObjectEventPublisher.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
 #include "fboss/agent/hw/sai/switch/SaiNextHopGroupManager.h"
@@ -17,6 +18,8 @@
 #include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/types.h"
 
+#include <functional>
+
 using namespace facebook::fboss;
 
 /*
@@ -215,3 +218,117 @@ TEST_F(NextHopGroupManagerTest, testNextHopGroupMemberWeights) {
       SaiNextHopGroupMemberTraits::Attributes::Weight{});
   EXPECT_EQ(weight, 42);
 }
+
+TEST_F(NextHopGroupManagerTest, neighborFlapInBatch) {
+  auto arpEntry0 = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+  auto arpEntry1 = makeArpEntry(intf1.id, h1);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry1);
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  RouteNextHopEntry::NextHopSet swNextHops{nh1, nh2};
+  auto saiNextHopGroupHandle =
+      saiManagerTable->nextHopGroupManager().incRefOrAddNextHopGroup(
+          swNextHops);
+  auto nextHopGroupId = saiNextHopGroupHandle->nextHopGroup->adapterKey();
+
+  auto publisher = SaiObjectEventPublisher::getInstance();
+  auto before = publisher->getStats();
+  publisher->batchNotifications([&]() {
+    saiManagerTable->neighborManager().removeNeighbor(arpEntry0);
+    // The removal is not deferred
+    checkNextHopGroup(nextHopGroupId, {h1.ip});
+    saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+    saiManagerTable->neighborManager().removeNeighbor(arpEntry0);
+    saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+    // Creations wait for the batch to end, and are coalesced
+    checkNextHopGroup(nextHopGroupId, {h1.ip});
+  });
+  auto after = publisher->getStats();
+  checkNextHopGroup(nextHopGroupId, {h0.ip, h1.ip});
+  EXPECT_EQ(after.coalesced - before.coalesced, 1);
+}
+
+namespace {
+/*
+ * Subscribes to a neighbor after everything else does, and runs a callback
+ * when told the neighbor is about to be removed
+ */
+class NeighborRemovalSubscriber
+    : public detail::SaiObjectEventSubscriber<SaiNeighborTraits> {
+ public:
+  NeighborRemovalSubscriber(
+      SaiNeighborTraits::NeighborEntry entry,
+      std::function<void()> onRemove)
+      : detail::SaiObjectEventSubscriber<SaiNeighborTraits>(entry),
+        onRemove_(std::move(onRemove)) {}
+
+  void afterCreate(PublisherObjectSharedPtr object) override {
+    setPublisherObject(object);
+  }
+  void beforeRemove() override {
+    onRemove_();
+    setPublisherObject(nullptr);
+  }
+
+ private:
+  std::function<void()> onRemove_;
+};
+} // namespace
+
+TEST_F(NextHopGroupManagerTest, neighborRemovalOrderInBatch) {
+  auto arpEntry0 = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+  auto arpEntry1 = makeArpEntry(intf1.id, h1);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry1);
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  auto saiNextHopGroupHandle =
+      saiManagerTable->nextHopGroupManager().incRefOrAddNextHopGroup(
+          RouteNextHopEntry::NextHopSet{nh1, nh2});
+  auto nextHopGroupId = saiNextHopGroupHandle->nextHopGroup->adapterKey();
+
+  auto numNeighbors = fs->neighborManager.map().size();
+  bool notified = false;
+  auto subscriber = std::make_shared<NeighborRemovalSubscriber>(
+      saiManagerTable->neighborManager().saiEntryFromSwEntry(arpEntry0),
+      [&]() {
+        notified = true;
+        // The neighbor is still programmed, but the group member using it
+        // is already gone
+        EXPECT_EQ(fs->neighborManager.map().size(), numNeighbors);
+        checkNextHopGroup(nextHopGroupId, {h1.ip});
+      });
+  SaiObjectEventPublisher::getInstance()->subscribe<SaiNeighborTraits>(
+      subscriber);
+
+  SaiObjectEventPublisher::getInstance()->batchNotifications([&]() {
+    saiManagerTable->neighborManager().removeNeighbor(arpEntry0);
+    EXPECT_TRUE(notified);
+    EXPECT_EQ(fs->neighborManager.map().size(), numNeighbors - 1);
+  });
+  checkNextHopGroup(nextHopGroupId, {h1.ip});
+}
+
+TEST_F(NextHopGroupManagerTest, sharedNextHopNotifiedOnce) {
+  auto arpEntry0 = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  auto saiNextHopGroupHandle1 =
+      saiManagerTable->nextHopGroupManager().incRefOrAddNextHopGroup(
+          RouteNextHopEntry::NextHopSet{nh1});
+  auto saiNextHopGroupHandle2 =
+      saiManagerTable->nextHopGroupManager().incRefOrAddNextHopGroup(
+          RouteNextHopEntry::NextHopSet{nh1, nh2});
+
+  auto before = SaiObjectEventPublisher::getInstance()->getStats();
+  saiManagerTable->neighborManager().removeNeighbor(arpEntry0);
+  auto after = SaiObjectEventPublisher::getInstance()->getStats();
+  // Neighbor removal reaches the one next hop subscriber shared by both
+  // groups, next hop removal reaches one member subscriber per group
+  EXPECT_EQ(after.events - before.events, 2);
+  EXPECT_EQ(after.notifications - before.notifications, 3);
+  checkNextHopGroup(saiNextHopGroupHandle1->nextHopGroup->adapterKey(), {});
+  checkNextHopGroup(saiNextHopGroupHandle2->nextHopGroup->adapterKey(), {});
+}
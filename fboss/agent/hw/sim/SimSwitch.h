@@ -69,6 +69,11 @@ class SimSwitch : public HwSwitch {
     return false;
   }
 
+  std::optional<std::vector<folly::IPAddress>> getAndClearNeighborHits(
+      RouterID /*vrf*/) override {
+    return std::vector<folly::IPAddress>();
+  }
+
   bool isPortUp(PortID /*port*/) const override {
     // Should be called only from SwSwitch which knows whether
     // the port is enabled or not
@@ -271,3 +271,50 @@ TEST(HwPortFb303Stats, queueNameChangeResetsValue) {
     }
   }
 }
+
+TEST(HwPortFb303Stats, queueWatermarkMax) {
+  HwPortFb303Stats portStats(kPortName, kQueue2Name);
+  updateStats(portStats);
+  auto watermarkMax = [](int queueId, const std::string& queueName) {
+    return HwPortFb303Stats::statName(
+        kWatermarkBytesMax(), kPortName, queueId, queueName);
+  };
+  EXPECT_EQ(fbData->getCounter(watermarkMax(1, "gold")), 0);
+  EXPECT_EQ(fbData->getCounter(watermarkMax(2, "silver")), 10);
+
+  // Max over the window sticks around after watermark goes down
+  auto stats = getInitedStats();
+  stats.queueWatermarkBytes_ = {{1, 5}, {2, 5}};
+  portStats.updateStats(
+      stats, duration_cast<seconds>(system_clock::now().time_since_epoch()));
+  EXPECT_EQ(fbData->getCounter(watermarkMax(1, "gold")), 5);
+  EXPECT_EQ(fbData->getCounter(watermarkMax(2, "silver")), 10);
+
+  portStats.queueRemoved(2);
+  EXPECT_FALSE(fbData->hasCounter(watermarkMax(2, "silver")));
+  EXPECT_TRUE(fbData->hasCounter(watermarkMax(1, "gold")));
+}
+
+TEST(HwPortFb303Stats, updateStatsAfterRename) {
+  HwPortFb303Stats portStats(kPortName, kQueue2Name);
+  portStats.queueChanged(1, "platinum");
+  portStats.queueRemoved(2);
+  portStats.queueChanged(3, "bronze");
+  // Counters get updated under their new names
+  auto stats = getInitedStats();
+  stats.queueOutDiscardBytes_[3] = 1;
+  stats.queueOutBytes_[3] = 2;
+  stats.queueOutPackets_[3] = 3;
+  auto now = duration_cast<seconds>(system_clock::now().time_since_epoch());
+  portStats.updateStats(stats, now);
+  stats.queueOutBytes_ = {{1, 4}, {2, 4}, {3, 6}};
+  portStats.updateStats(stats, now);
+  EXPECT_EQ(
+      portStats.getCounterLastIncrement(
+          HwPortFb303Stats::statName(kOutBytes(), kPortName, 1, "platinum")),
+      2);
+  EXPECT_EQ(
+      portStats.getCounterLastIncrement(
+          HwPortFb303Stats::statName(kOutBytes(), kPortName, 3, "bronze")),
+      4);
+}
@@ -452,6 +452,38 @@ struct LinkNeighborThrift {
   15: optional string localPortName
 }
 
+/*
+ * Timings of a state update, from the update thread flight recorder. Hw
+ * programming and observer times and the delta size are those of the batch
+ * of batchSize updates the update was coalesced into.
+ */
+struct StateUpdateRecord {
+  1: string name
+  2: i64 finishedAtUsecs
+  3: i64 queueWaitUsecs
+  4: i64 applyUsecs
+  5: i64 hwProgrammingUsecs
+  6: i64 observersUsecs
+  // Route and neighbor changes in the delta, 0 if they were not computed
+  7: i64 deltaSize
+  8: i32 batchSize
+}
+
+struct MapMemoryUsage {
+  1: i64 nodes
+  2: i64 bytes
+  // Bytes shared with the previously accounted state
+  3: i64 sharedBytes
+}
+
+struct StateMemoryUsage {
+  1: i64 generation
+  // Usage per kind of map, e.g. "arp_tables" or "rib_v4"
+  2: map<string, MapMemoryUsage> maps
+  // Previously accounted states still retained
+  3: i32 retainedGenerations
+}
+
 enum ClientID {
   BGPD = 0,
   STATIC_ROUTE = 1,
@@ -486,6 +518,35 @@ struct AclEntryThrift {
   22: optional byte lookupClassL2
 }
 
+enum StateChangeKind {
+  NEIGHBOR = 0,
+  ROUTE = 1,
+  PORT = 2,
+}
+
+/*
+ * Latest state of a neighbor, route or port. key is the neighbor IP,
+ * "<vrf>:<prefix>" for routes, or the port ID.
+ */
+struct StateChange {
+  1: StateChangeKind kind
+  2: string key
+  // Neighbor became unresolved or route was removed
+  3: bool removed
+  // Port operational state
+  4: optional bool up
+}
+
+struct StateChangeBatch {
+  // At most one change per kind and key
+  1: list<StateChange> changes
+  /*
+   * Set if changes were dropped because the subscriber fell behind. The
+   * subscriber should re-read the state it is interested in.
+   */
+  2: bool resync
+}
+
 service FbossCtrl extends fb303.FacebookService {
   /*
    * Retrieve up-to-date counters from the hardware, and publish all
@@ -615,6 +676,13 @@ service FbossCtrl extends fb303.FacebookService {
     throws (1: fboss.FbossBaseError error)
   void registerForNeighborChanged()
     throws (1: fboss.FbossBaseError error) (thread='eb')
+  /*
+   * Subscribe to neighbor, route and port changes over the duplex channel.
+   * Changes are coalesced per key while the previous batch is outstanding,
+   * and delivered through NeighborListenerClient.stateChanged().
+   */
+  void subscribeToStateChanges(1: set<StateChangeKind> kinds)
+    throws (1: fboss.FbossBaseError error) (thread='eb')
   list<string> getInterfaceList()
     throws (1: fboss.FbossBaseError error)
   /*
@@ -792,6 +860,19 @@ service FbossCtrl extends fb303.FacebookService {
   */
   SwitchRunState getSwitchRunState()
 
+  /*
+   * Timings of the last maxRecords state updates, newest first
+   */
+  list<StateUpdateRecord> getStateUpdateRecords(1: i32 maxRecords)
+    throws (1: fboss.FbossBaseError error)
+
+  /*
+   * Estimated memory taken by the switch state and the RIB, as of the last
+   * background accounting run
+   */
+  StateMemoryUsage getStateMemoryUsage()
+    throws (1: fboss.FbossBaseError error)
+
   SSLType getSSLPolicy()
     throws (1: fboss.FbossBaseError error)
 
@@ -812,4 +893,11 @@ service NeighborListenerClient extends fb303.FacebookService {
    */
   void neighborsChanged(1: list<string> added, 2: list<string> removed)
     throws (1: fboss.FbossBaseError error)
+
+  /*
+   * Sends a batch of changes to a subscriber of subscribeToStateChanges().
+   * The next batch is not sent until this one is acknowledged.
+   */
+  void stateChanged(1: StateChangeBatch batch)
+    throws (1: fboss.FbossBaseError error)
 }
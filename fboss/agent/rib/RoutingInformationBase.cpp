@@ -12,32 +12,19 @@
 
 #include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/rib/ConfigApplier.h"
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 #include "fboss/agent/rib/RouteNextHopEntry.h"
 #include "fboss/agent/rib/RouteUpdater.h"
 
+#include <folly/ScopeGuard.h>
+
+#include <algorithm>
 #include <memory>
+#include <tuple>
 #include <utility>
 
-namespace {
-class Timer {
- public:
-  explicit Timer(std::chrono::microseconds* duration)
-      : duration_(duration), start_(std::chrono::steady_clock::now()) {}
-
-  ~Timer() {
-    auto end = std::chrono::steady_clock::now();
-    *duration_ =
-        std::chrono::duration_cast<std::chrono::microseconds>(end - start_);
-  }
-
- private:
-  std::chrono::microseconds* duration_;
-  std::chrono::time_point<std::chrono::steady_clock> start_;
-};
-} // namespace
-
 namespace facebook::fboss::rib {
 
 void RoutingInformationBase::reconfigure(
@@ -107,69 +94,223 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
     RouterID routerID,
     ClientID clientID,
     AdminDistance adminDistanceFromClientID,
-    const std::vector<UnicastRoute>& toAdd,
-    const std::vector<IpPrefix>& toDelete,
+    std::vector<UnicastRoute> toAdd,
+    std::vector<IpPrefix> toDelete,
     bool resetClientsRoutes,
     folly::StringPiece updateType,
     FibUpdateFunction fibUpdateCallback,
     void* cookie) {
-  UpdateStatistics stats;
-
-  Timer updateTimer(&stats.duration);
-
-  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  return updateAsync(
+             routerID,
+             clientID,
+             adminDistanceFromClientID,
+             std::move(toAdd),
+             std::move(toDelete),
+             resetClientsRoutes,
+             updateType,
+             std::move(fibUpdateCallback),
+             cookie)
+      .get();
+}
 
-  auto it = lockedRouteTables->find(routerID);
-  if (it == lockedRouteTables->end()) {
-    throw FbossError("VRF ", routerID, " not configured");
+folly::SemiFuture<RoutingInformationBase::UpdateStatistics>
+RoutingInformationBase::updateAsync(
+    RouterID routerID,
+    ClientID clientID,
+    AdminDistance adminDistanceFromClientID,
+    std::vector<UnicastRoute> toAdd,
+    std::vector<IpPrefix> toDelete,
+    bool resetClientsRoutes,
+    folly::StringPiece updateType,
+    FibUpdateFunction fibUpdateCallback,
+    void* cookie) {
+  auto update = std::make_unique<PendingUpdate>(PendingUpdate{
+      routerID,
+      clientID,
+      adminDistanceFromClientID,
+      std::move(toAdd),
+      std::move(toDelete),
+      resetClientsRoutes,
+      updateType.str(),
+      std::move(fibUpdateCallback),
+      cookie,
+      std::chrono::steady_clock::now(),
+      UpdateStatistics{},
+      folly::Promise<UpdateStatistics>()});
+  auto future = update->promise.getSemiFuture();
+
+  auto queue = updateQueue_.wlock();
+  queue->updates.push_back(std::move(update));
+  // If a commit is in progress, the next one will pick up our update too
+  if (!std::exchange(queue->committing, true)) {
+    scheduleCommit();
   }
+  return future;
+}
 
-  RouteUpdater updater(
-      &(it->second.v4NetworkToRoute), &(it->second.v6NetworkToRoute));
+void RoutingInformationBase::scheduleCommit() {
+  commitThread_->getEventBase()->runInEventBaseThread(
+      [this]() { commitQueuedUpdates(); });
+}
 
-  if (resetClientsRoutes) {
-    updater.removeAllRoutesForClient(clientID);
-  }
+void RoutingInformationBase::commitQueuedUpdates() {
+  std::vector<std::unique_ptr<PendingUpdate>> updates;
+  updates.swap(updateQueue_.wlock()->updates);
+  SCOPE_EXIT {
+    auto queue = updateQueue_.wlock();
+    if (queue->updates.empty()) {
+      queue->committing = false;
+    } else {
+      // Updates queued up while we were committing make the next batch
+      scheduleCommit();
+    }
+  };
+  commitUpdates(std::move(updates));
+}
 
+namespace {
+/*
+ * The routes of a queued update, converted before any of them is applied,
+ * so that an update that fails to convert leaves the RIB untouched.
+ */
+struct ParsedUpdate {
+  std::vector<std::tuple<folly::IPAddress, uint8_t, RouteNextHopEntry>> toAdd;
+  std::vector<std::pair<folly::IPAddress, uint8_t>> toDelete;
+};
+
+ParsedUpdate parseUpdate(
+    const std::vector<UnicastRoute>& toAdd,
+    const std::vector<IpPrefix>& toDelete,
+    AdminDistance adminDistanceFromClientID,
+    RoutingInformationBase::UpdateStatistics* stats) {
+  ParsedUpdate parsed;
+  parsed.toAdd.reserve(toAdd.size());
   for (const auto& route : toAdd) {
     auto network = facebook::network::toIPAddress(route.dest.ip);
     auto mask = static_cast<uint8_t>(route.dest.prefixLength);
 
     if (network.isV4()) {
-      ++stats.v4RoutesAdded;
+      ++stats->v4RoutesAdded;
     } else {
-      ++stats.v6RoutesAdded;
+      ++stats->v6RoutesAdded;
     }
 
-    updater.addRoute(
+    parsed.toAdd.emplace_back(
         network,
         mask,
-        clientID,
         RouteNextHopEntry::from(route, adminDistanceFromClientID));
   }
 
+  parsed.toDelete.reserve(toDelete.size());
   for (const auto& prefix : toDelete) {
     auto network = facebook::network::toIPAddress(prefix.ip);
     auto mask = static_cast<uint8_t>(prefix.prefixLength);
 
     if (network.isV4()) {
-      ++stats.v4RoutesDeleted;
+      ++stats->v4RoutesDeleted;
     } else {
-      ++stats.v6RoutesDeleted;
+      ++stats->v6RoutesDeleted;
     }
 
-    updater.delRoute(network, mask, clientID);
+    parsed.toDelete.emplace_back(network, mask);
   }
+  return parsed;
+}
+} // namespace
 
-  updater.updateDone();
+void RoutingInformationBase::commitUpdates(
+    std::vector<std::unique_ptr<PendingUpdate>> updates) {
+  auto commitStart = std::chrono::steady_clock::now();
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
 
-  fibUpdateCallback(
-      routerID,
-      it->second.v4NetworkToRoute,
-      it->second.v6NetworkToRoute,
-      cookie);
+  boost::container::flat_map<RouterID, std::vector<PendingUpdate*>>
+      updatesByVrf;
+  for (auto& update : updates) {
+    updatesByVrf[update->routerID].push_back(update.get());
+  }
 
-  return stats;
+  for (auto& [routerID, vrfUpdates] : updatesByVrf) {
+    auto it = lockedRouteTables->find(routerID);
+    if (it == lockedRouteTables->end()) {
+      for (auto* update : vrfUpdates) {
+        update->promise.setException(
+            FbossError("VRF ", routerID, " not configured"));
+      }
+      continue;
+    }
+
+    std::vector<PendingUpdate*> applied;
+    try {
+      RouteUpdater updater(
+          &(it->second.v4NetworkToRoute), &(it->second.v6NetworkToRoute));
+
+      for (auto* update : vrfUpdates) {
+        ParsedUpdate parsed;
+        try {
+          parsed = parseUpdate(
+              update->toAdd,
+              update->toDelete,
+              update->adminDistanceFromClientID,
+              &update->stats);
+        } catch (...) {
+          update->promise.setException(
+              folly::exception_wrapper(std::current_exception()));
+          continue;
+        }
+        // Past this point an update only fails along with its whole VRF
+        applied.push_back(update);
+
+        if (update->resetClientsRoutes) {
+          updater.removeAllRoutesForClient(update->clientID);
+        }
+        for (auto& [network, mask, entry] : parsed.toAdd) {
+          updater.addRoute(network, mask, update->clientID, std::move(entry));
+        }
+        for (const auto& [network, mask] : parsed.toDelete) {
+          updater.delRoute(network, mask, update->clientID);
+        }
+      }
+
+      updater.updateDone();
+
+      // Update the FIB once for all the updates to this VRF
+      std::vector<PendingUpdate*> fibUpdates;
+      for (auto* update : applied) {
+        auto sameCookie = std::find_if(
+            fibUpdates.begin(), fibUpdates.end(), [update](const auto* other) {
+              return other->cookie == update->cookie;
+            });
+        if (sameCookie == fibUpdates.end()) {
+          fibUpdates.push_back(update);
+        }
+      }
+      for (auto* update : fibUpdates) {
+        update->fibUpdateCallback(
+            routerID,
+            it->second.v4NetworkToRoute,
+            it->second.v6NetworkToRoute,
+            update->cookie);
+      }
+    } catch (...) {
+      auto error = folly::exception_wrapper(std::current_exception());
+      for (auto* update : applied) {
+        update->promise.setException(error);
+      }
+      continue;
+    }
+
+    auto commitEnd = std::chrono::steady_clock::now();
+    for (auto* update : applied) {
+      update->stats.duration =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              commitEnd - commitStart);
+      update->stats.queueDelay =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              commitStart - update->queued);
+      update->stats.batchSize = updates.size();
+      update->promise.setValue(update->stats);
+    }
+  }
 }
 
 folly::dynamic RoutingInformationBase::toFollyDynamic() const {
@@ -221,6 +362,20 @@ std::vector<RouterID> RoutingInformationBase::getVrfList() const {
   return res;
 }
 
+std::map<RouterID, std::pair<size_t, size_t>>
+RoutingInformationBase::getRouteTableSizes() const {
+  std::map<RouterID, std::pair<size_t, size_t>> sizes;
+  auto lockedRouteTables = synchronizedRouteTables_.rlock();
+  for (const auto& entry : *lockedRouteTables) {
+    sizes.emplace(
+        entry.first,
+        std::make_pair(
+            entry.second.v4NetworkToRoute.size(),
+            entry.second.v6NetworkToRoute.size()));
+  }
+  return sizes;
+}
+
 std::vector<RouteDetails> RoutingInformationBase::getRouteTableDetails(
     RouterID rid) const {
   std::vector<RouteDetails> routeDetails;
@@ -15,9 +15,14 @@
 #include "fboss/agent/types.h"
 
 #include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -36,7 +41,12 @@ class RoutingInformationBase {
     std::size_t v4RoutesDeleted{0};
     std::size_t v6RoutesAdded{0};
     std::size_t v6RoutesDeleted{0};
+    // From the start of the commit until the FIB was updated
     std::chrono::microseconds duration{0};
+    // Time spent waiting for earlier updates to be committed
+    std::chrono::microseconds queueDelay{0};
+    // Number of updates committed together with this one
+    std::size_t batchSize{0};
   };
 
   /*
@@ -46,6 +56,18 @@ class RoutingInformationBase {
    * 2. Triggers recursive (IP) resolution.
    * 3. Updates the FIB synchronously.
    *
+   * Updates are group committed on a dedicated thread: while one batch of
+   * updates is being committed, updates from other callers queue up, and
+   * are then committed together as the next batch. A batch resolves each
+   * affected VRF and updates its FIB once, so concurrent clients share the
+   * cost of resolution and of programming the switch. Updates to the same
+   * VRF are applied in the order they were queued, and every update gets its
+   * own statistics or its own error. An update that fails, e.g. on a bad
+   * next hop, is not applied at all.
+   *
+   * Updates passing the same cookie are expected to pass the same
+   * fibUpdateCallback, it is only called once per cookie and VRF in a batch.
+   *
    * If a UnicastRoute does not specify its admin distance, then we derive its
    * admin distance via its clientID.  This is accomplished by a mapping from
    * client IDs to admin distances provided in configuration. Unfortunately,
@@ -57,8 +79,23 @@ class RoutingInformationBase {
       RouterID routerID,
       ClientID clientID,
       AdminDistance adminDistanceFromClientID,
-      const std::vector<UnicastRoute>& toAdd,
-      const std::vector<IpPrefix>& toDelete,
+      std::vector<UnicastRoute> toAdd,
+      std::vector<IpPrefix> toDelete,
+      bool resetClientsRoutes,
+      folly::StringPiece updateType,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie);
+
+  /*
+   * Same as `update()`, but does not wait for the update to be committed.
+   * The returned future completes once the batch holding the update is.
+   */
+  folly::SemiFuture<UpdateStatistics> updateAsync(
+      RouterID routerID,
+      ClientID clientID,
+      AdminDistance adminDistanceFromClientID,
+      std::vector<UnicastRoute> toAdd,
+      std::vector<IpPrefix> toDelete,
       bool resetClientsRoutes,
       folly::StringPiece updateType,
       FibUpdateFunction fibUpdateCallback,
@@ -95,6 +132,12 @@ class RoutingInformationBase {
   std::vector<RouterID> getVrfList() const;
   std::vector<RouteDetails> getRouteTableDetails(RouterID rid) const;
 
+  /*
+   * Number of v4 and v6 routes of each VRF. Only holds the RIB for as long
+   * as it takes to read the sizes, so updates are not held up.
+   */
+  std::map<RouterID, std::pair<size_t, size_t>> getRouteTableSizes() const;
+
   bool operator==(const RoutingInformationBase& other) const;
   bool operator!=(const RoutingInformationBase& other) const {
     return !(*this == other);
@@ -126,12 +169,41 @@ class RoutingInformationBase {
   using RouterIDToRouteTable = boost::container::flat_map<RouterID, RouteTable>;
   using SynchronizedRouteTables = folly::Synchronized<RouterIDToRouteTable>;
 
+  struct PendingUpdate {
+    RouterID routerID;
+    ClientID clientID;
+    AdminDistance adminDistanceFromClientID;
+    std::vector<UnicastRoute> toAdd;
+    std::vector<IpPrefix> toDelete;
+    bool resetClientsRoutes;
+    std::string updateType;
+    FibUpdateFunction fibUpdateCallback;
+    void* cookie;
+    std::chrono::steady_clock::time_point queued;
+    UpdateStatistics stats;
+    folly::Promise<UpdateStatistics> promise;
+  };
+  struct UpdateQueue {
+    std::vector<std::unique_ptr<PendingUpdate>> updates;
+    // Whether a commit is scheduled or in progress on commitThread_
+    bool committing{false};
+  };
+
+  // Commit the updates queued so far as one batch, on commitThread_
+  void scheduleCommit();
+  void commitQueuedUpdates();
+  void commitUpdates(std::vector<std::unique_ptr<PendingUpdate>> updates);
+
   RouterIDToRouteTable constructRouteTables(
       const SynchronizedRouteTables::WLockedPtr& lockedRouteTables,
       const RouterIDAndNetworkToInterfaceRoutes&
           configRouterIDToInterfaceRoutes) const;
 
   SynchronizedRouteTables synchronizedRouteTables_;
+  folly::Synchronized<UpdateQueue> updateQueue_;
+  // Declared last, so that it is joined before anything it uses is destroyed
+  std::unique_ptr<folly::ScopedEventBaseThread> commitThread_{
+      std::make_unique<folly::ScopedEventBaseThread>("RibCommit")};
 };
 
 } // namespace facebook::fboss::rib
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+
+#include <folly/IPAddress.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using rib::RoutingInformationBase;
+
+namespace {
+const ClientID kClientA = ClientID(1001);
+const ClientID kClientB = ClientID(1002);
+const RouterID kRid0 = RouterID(0);
+
+UnicastRoute makeRoute(const std::string& prefix, const std::string& nhop) {
+  auto cidr = folly::IPAddress::createNetwork(prefix);
+  UnicastRoute route;
+  route.dest.ip = facebook::network::toBinaryAddress(cidr.first);
+  route.dest.prefixLength = cidr.second;
+  route.nextHopAddrs.push_back(
+      facebook::network::toBinaryAddress(folly::IPAddress(nhop)));
+  return route;
+}
+
+struct FibUpdates {
+  int calls{0};
+  size_t v4Routes{0};
+  folly::Baton<> entered;
+  folly::Baton<> release;
+  bool block{false};
+};
+
+void countFibUpdate(
+    RouterID /* vrf */,
+    const rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const rib::IPv6NetworkToRouteMap& /* v6NetworkToRoute */,
+    void* cookie) {
+  auto fibUpdates = static_cast<FibUpdates*>(cookie);
+  ++fibUpdates->calls;
+  fibUpdates->v4Routes = v4NetworkToRoute.size();
+  if (fibUpdates->block) {
+    fibUpdates->block = false;
+    fibUpdates->entered.post();
+    fibUpdates->release.wait();
+  }
+}
+} // namespace
+
+TEST(RoutingInformationBase, GroupCommit) {
+  RoutingInformationBase rib;
+  rib.createVrf(kRid0);
+  FibUpdates fibUpdates;
+  fibUpdates.block = true;
+
+  // The first update commits on its own and blocks in the FIB update
+  std::thread first([&]() {
+    auto stats = rib.update(
+        kRid0,
+        kClientA,
+        AdminDistance::EBGP,
+        {makeRoute("10.0.0.0/24", "1.1.1.1")},
+        {},
+        false,
+        "first",
+        &countFibUpdate,
+        &fibUpdates);
+    EXPECT_EQ(stats.v4RoutesAdded, 1);
+    EXPECT_EQ(stats.batchSize, 1);
+  });
+  fibUpdates.entered.wait();
+
+  // Meanwhile, these queue up behind it
+  std::vector<folly::SemiFuture<RoutingInformationBase::UpdateStatistics>>
+      futures;
+  futures.push_back(rib.updateAsync(
+      kRid0,
+      kClientA,
+      AdminDistance::EBGP,
+      {makeRoute("10.0.1.0/24", "1.1.1.1")},
+      {},
+      false,
+      "second",
+      &countFibUpdate,
+      &fibUpdates));
+  futures.push_back(rib.updateAsync(
+      kRid0,
+      kClientB,
+      AdminDistance::EBGP,
+      {makeRoute("10.0.2.0/24", "1.1.1.1"),
+       makeRoute("10.0.3.0/24", "1.1.1.1")},
+      {},
+      false,
+      "third",
+      &countFibUpdate,
+      &fibUpdates));
+  futures.push_back(rib.updateAsync(
+      RouterID(1),
+      kClientB,
+      AdminDistance::EBGP,
+      {makeRoute("10.0.4.0/24", "1.1.1.1")},
+      {},
+      false,
+      "unknown vrf",
+      &countFibUpdate,
+      &fibUpdates));
+  for (const auto& future : futures) {
+    EXPECT_FALSE(future.isReady());
+  }
+
+  fibUpdates.release.post();
+  first.join();
+
+  auto second = std::move(futures[0]).get();
+  EXPECT_EQ(second.v4RoutesAdded, 1);
+  EXPECT_EQ(second.batchSize, 3);
+  auto third = std::move(futures[1]).get();
+  EXPECT_EQ(third.v4RoutesAdded, 2);
+  EXPECT_EQ(third.batchSize, 3);
+  EXPECT_THROW(std::move(futures[2]).get(), FbossError);
+
+  // One FIB update for the first update, one for both of the queued ones
+  EXPECT_EQ(fibUpdates.calls, 2);
+  EXPECT_EQ(fibUpdates.v4Routes, 4);
+}
+
+TEST(RoutingInformationBase, FailedUpdateNotApplied) {
+  RoutingInformationBase rib;
+  rib.createVrf(kRid0);
+  FibUpdates fibUpdates;
+
+  auto badRoute = makeRoute("10.0.1.0/24", "1.1.1.1");
+  badRoute.dest.ip.addr = "bad";
+  EXPECT_THROW(
+      rib.update(
+          kRid0,
+          kClientA,
+          AdminDistance::EBGP,
+          {makeRoute("10.0.0.0/24", "1.1.1.1"), badRoute},
+          {},
+          false,
+          "bad",
+          &countFibUpdate,
+          &fibUpdates),
+      std::exception);
+  EXPECT_EQ(fibUpdates.calls, 0);
+
+  // The good route of the failed update was not applied either
+  rib.update(
+      kRid0,
+      kClientB,
+      AdminDistance::EBGP,
+      {makeRoute("10.0.2.0/24", "1.1.1.1")},
+      {},
+      false,
+      "good",
+      &countFibUpdate,
+      &fibUpdates);
+  EXPECT_EQ(fibUpdates.calls, 1);
+  EXPECT_EQ(fibUpdates.v4Routes, 1);
+}
@@ -97,19 +97,21 @@ LabelForwardingInformationBase::purgeEntriesForClient(
     ClientID client) {
   auto* writableLabelFib = modify(state);
 
-  auto iter = writableLabelFib->writableNodes().begin();
-  while (iter != writableLabelFib->writableNodes().end()) {
-    if (iter->second->getEntryForClient(client)) {
-      auto* entry = iter->second->modify(state);
-      entry->delEntryForClient(client);
-      if (entry->isEmpty()) {
-        XLOG(DBG1) << "Purging empty forwarding entry for label:"
-                   << entry->getID();
-        iter = writableLabelFib->writableNodes().erase(iter);
-        continue;
+  // Iterate over the table read-only, so that only the pages holding entries
+  // of the client get copied
+  std::vector<Label> emptyLabels;
+  for (const auto& entry : *writableLabelFib) {
+    if (entry->getEntryForClient(client)) {
+      auto* entryToUpdate = entry->modify(state);
+      entryToUpdate->delEntryForClient(client);
+      if (entryToUpdate->isEmpty()) {
+        emptyLabels.push_back(entryToUpdate->getID());
       }
     }
-    ++iter;
+  }
+  for (auto label : emptyLabels) {
+    XLOG(DBG1) << "Purging empty forwarding entry for label:" << label;
+    writableLabelFib->removeNode(label);
   }
 
   return writableLabelFib;
@@ -6,11 +6,16 @@
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/state/LabelForwardingEntry.h"
+#include "fboss/agent/state/LabelTable.h"
 #include "fboss/agent/state/NodeMap.h"
 
 namespace facebook::fboss {
 
-typedef NodeMapTraits<MplsLabel, LabelForwardingEntry> LabelForwardingRoute;
+struct LabelForwardingRoute
+    : public NodeMapTraits<MplsLabel, LabelForwardingEntry> {
+  // Labels are looked up and updated directly by index
+  using NodeContainer = LabelTable<MplsLabel, LabelForwardingEntry>;
+};
 
 class LabelForwardingInformationBase
     : public NodeMapT<LabelForwardingInformationBase, LabelForwardingRoute> {
@@ -0,0 +1,325 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/FbossError.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * LabelTable is a NodeMap container for nodes keyed by a 20 bit MPLS label.
+ *
+ * Labels are a small dense key space, so rather than keeping a sorted vector
+ * the table is indexed directly: the upper bits of a label select a page, the
+ * lower bits a slot in that page. Lookups are O(1), and adding or removing a
+ * label never moves other entries.
+ *
+ * Pages are shared between copies of the table and are copied on write, so
+ * cloning a LabelForwardingInformationBase copies only the page pointers, and
+ * each later update copies only the pages it touches. Iteration is in label
+ * order, like the flat_map it replaces, and NodeMapDelta skips over pages
+ * that two tables share without looking at their nodes.
+ */
+template <typename KeyT, typename NodeT>
+class LabelTable {
+ public:
+  static constexpr uint32_t kLabelBits = 20;
+  static constexpr uint32_t kPageBits = 8;
+  static constexpr uint32_t kPageSize = 1 << kPageBits;
+  static constexpr uint32_t kMaxPages = 1 << (kLabelBits - kPageBits);
+  static constexpr uint32_t kEnd = 1 << kLabelBits;
+
+  using key_type = KeyT;
+  using mapped_type = std::shared_ptr<NodeT>;
+  using value_type = std::pair<KeyT, std::shared_ptr<NodeT>>;
+  using size_type = size_t;
+
+  class const_iterator;
+  class iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, nextIndex(0));
+  }
+  const_iterator end() const {
+    return const_iterator(this, kEnd);
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator find(KeyT key) const {
+    auto index = static_cast<uint32_t>(key);
+    if (!contains(key)) {
+      return end();
+    }
+    return const_iterator(this, index);
+  }
+
+  /*
+   * Unlike the const version, the returned iterator may be used to replace
+   * the node of the entry, and copies the page of the entry if it is shared.
+   */
+  iterator find(KeyT key) {
+    auto index = static_cast<uint32_t>(key);
+    if (!contains(key)) {
+      return iterator(this, kEnd);
+    }
+    return iterator(this, index);
+  }
+
+  std::pair<iterator, bool> insert(value_type entry) {
+    if (!validKey(entry.first)) {
+      throw FbossError("label ", entry.first, " is out of range");
+    }
+    auto index = static_cast<uint32_t>(entry.first);
+    auto pageIndex = index >> kPageBits;
+    if (pageIndex >= pages_.size()) {
+      pages_.resize(pageIndex + 1);
+    }
+    auto& page = pages_[pageIndex];
+    if (!page) {
+      page = std::make_shared<Page>(pageIndex << kPageBits);
+    }
+    auto& slot = writableSlot(index);
+    if (slot.second) {
+      return std::make_pair(iterator(this, index), false);
+    }
+    slot.second = std::move(entry.second);
+    ++page->count;
+    ++size_;
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  /*
+   * Returns an iterator to the entry after the erased one.
+   */
+  const_iterator erase(const_iterator pos) {
+    auto index = pos.index_;
+    auto pageIndex = index >> kPageBits;
+    writableSlot(index).second.reset();
+    --size_;
+    if (--pages_[pageIndex]->count == 0) {
+      pages_[pageIndex].reset();
+      while (!pages_.empty() && !pages_.back()) {
+        pages_.pop_back();
+      }
+    }
+    return const_iterator(this, nextIndex(index + 1));
+  }
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = LabelTable::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() {}
+    // NodeMapDelta default constructs its iterators from nullptr
+    /* implicit */ const_iterator(std::nullptr_t) {}
+
+    reference operator*() const {
+      return table_->getSlot(index_);
+    }
+    pointer operator->() const {
+      return &table_->getSlot(index_);
+    }
+
+    const_iterator& operator++() {
+      index_ = table_->nextIndex(index_ + 1);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+    const_iterator& operator--() {
+      index_ = table_->prevIndex(index_);
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator tmp(*this);
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return index_ != other.index_;
+    }
+
+    /*
+     * Advances a and b, which point at the same node of two tables, past the
+     * nodes the tables share. When the node is in a page both tables share,
+     * so are all the nodes after it in the page.
+     */
+    friend void skipSharedNodes(const_iterator& a, const_iterator& b) {
+      a.skipShared(b);
+    }
+
+   private:
+    friend class LabelTable;
+    const_iterator(const LabelTable* table, uint32_t index)
+        : table_(table), index_(index) {}
+
+    void skipShared(const_iterator& other) {
+      auto pageIndex = index_ >> kPageBits;
+      if (index_ == other.index_ &&
+          table_->pages_[pageIndex] == other.table_->pages_[pageIndex]) {
+        auto nextPage = (pageIndex + 1) << kPageBits;
+        index_ = table_->nextIndex(nextPage);
+        other.index_ = other.table_->nextIndex(nextPage);
+      } else {
+        ++*this;
+        ++other;
+      }
+    }
+
+   protected:
+    const LabelTable* table_{nullptr};
+    uint32_t index_{kEnd};
+  };
+
+  class iterator : public const_iterator {
+   public:
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    reference operator*() const {
+      return writableTable_->writableSlot(this->index_);
+    }
+    pointer operator->() const {
+      return &writableTable_->writableSlot(this->index_);
+    }
+
+   private:
+    friend class LabelTable;
+    iterator(LabelTable* table, uint32_t index)
+        : const_iterator(table, index), writableTable_(table) {}
+
+    LabelTable* writableTable_;
+  };
+
+ private:
+  struct Page {
+    explicit Page(uint32_t firstLabel) {
+      for (uint32_t i = 0; i < kPageSize; ++i) {
+        slots[i].first = KeyT(firstLabel + i);
+      }
+    }
+
+    std::array<value_type, kPageSize> slots;
+    uint32_t count{0};
+  };
+
+  static bool validKey(KeyT key) {
+    return key >= 0 && static_cast<uint32_t>(key) < kEnd;
+  }
+
+  bool contains(KeyT key) const {
+    if (!validKey(key)) {
+      return false;
+    }
+    auto pageIndex = static_cast<uint32_t>(key) >> kPageBits;
+    return pageIndex < pages_.size() && pages_[pageIndex] &&
+        getSlot(static_cast<uint32_t>(key)).second;
+  }
+
+  /*
+   * The slot of index, which must be in an existing page
+   */
+  const value_type& getSlot(uint32_t index) const {
+    return pages_[index >> kPageBits]->slots[index & (kPageSize - 1)];
+  }
+
+  value_type& writableSlot(uint32_t index) {
+    auto& page = pages_[index >> kPageBits];
+    // Only unpublished tables are written to, so no other thread can be
+    // taking a reference to the page while we hold the only one
+    if (page.use_count() > 1) {
+      page = std::make_shared<Page>(*page);
+    }
+    return page->slots[index & (kPageSize - 1)];
+  }
+
+  /*
+   * Index of the first entry at or after index, or kEnd if there is none.
+   * Pages without entries are never allocated, so only occupied pages are
+   * scanned.
+   */
+  uint32_t nextIndex(uint32_t index) const {
+    for (auto pageIndex = index >> kPageBits; pageIndex < pages_.size();
+         ++pageIndex) {
+      const auto& page = pages_[pageIndex];
+      if (page) {
+        for (auto slot = index & (kPageSize - 1); slot < kPageSize; ++slot) {
+          if (page->slots[slot].second) {
+            return (pageIndex << kPageBits) | slot;
+          }
+        }
+      }
+      index = 0;
+    }
+    return kEnd;
+  }
+
+  /*
+   * Index of the last entry before index, which must exist.
+   */
+  uint32_t prevIndex(uint32_t index) const {
+    auto pageIndex = index >> kPageBits;
+    auto slot = index & (kPageSize - 1);
+    if (pageIndex >= pages_.size()) {
+      pageIndex = static_cast<uint32_t>(pages_.size());
+      slot = 0;
+    }
+    while (true) {
+      if (slot == 0) {
+        --pageIndex;
+        slot = kPageSize;
+      }
+      --slot;
+      const auto& page = pages_[pageIndex];
+      if (!page) {
+        slot = 0;
+      } else if (page->slots[slot].second) {
+        return (pageIndex << kPageBits) | slot;
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<Page>> pages_;
+  size_t size_{0};
+};
+
+} // namespace facebook::fboss
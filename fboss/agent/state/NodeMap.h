@@ -11,11 +11,31 @@
 
 #include <boost/container/flat_map.hpp>
 
+#include <type_traits>
+
 #include "fboss/agent/state/NodeBase.h"
 #include "fboss/agent/state/NodeMapIterator.h"
 
 namespace facebook::fboss {
 
+/*
+ * The container NodeMapT keeps its nodes in. Nodes are kept in a flat_map
+ * unless the traits name another container with the same interface.
+ */
+template <typename TraitsT, typename = void>
+struct NodeMapContainer {
+  using type = boost::container::flat_map<
+      typename TraitsT::KeyType,
+      std::shared_ptr<typename TraitsT::Node>>;
+};
+
+template <typename TraitsT>
+struct NodeMapContainer<
+    TraitsT,
+    std::void_t<typename TraitsT::NodeContainer>> {
+  using type = typename TraitsT::NodeContainer;
+};
+
 /*
  * NodeMapFields defines the fields contained inside a NodeMapT instantiation
  */
@@ -24,8 +44,7 @@ struct NodeMapFields {
   using KeyType = typename TraitsT::KeyType;
   using Node = typename TraitsT::Node;
   using ExtraFields = typename TraitsT::ExtraFields;
-  using NodeContainer =
-      boost::container::flat_map<KeyType, std::shared_ptr<Node>>;
+  using NodeContainer = typename NodeMapContainer<TraitsT>::type;
 
   NodeMapFields() {}
   NodeMapFields(NodeContainer nodes) : nodes(std::move(nodes)) {}
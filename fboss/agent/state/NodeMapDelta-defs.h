@@ -32,8 +32,7 @@ NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::Iterator(
   // Advance to the first difference
   while (oldIt_ != oldMap_->end() && newIt_ != newMap_->end() &&
          *oldIt_ == *newIt_) {
-    ++oldIt_;
-    ++newIt_;
+    oldIt_.skipShared(newIt_);
   }
   updateValue();
 }
@@ -103,8 +102,7 @@ void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::advance() {
   // Advance past any unchanged nodes.
   while (oldIt_ != oldMap_->end() && newIt_ != newMap_->end() &&
          *oldIt_ == *newIt_) {
-    ++oldIt_;
-    ++newIt_;
+    oldIt_.skipShared(newIt_);
   }
   updateValue();
 }
@@ -11,6 +11,17 @@
 
 #include <boost/container/flat_map.hpp>
 
+/*
+ * Advances two iterators that point at the same node of two containers past
+ * that node. Containers that can tell when a whole range of nodes is shared
+ * between them provide an overload that skips the range at once.
+ */
+template <typename Iterator>
+void skipSharedNodes(Iterator& a, Iterator& b) {
+  ++a;
+  ++b;
+}
+
 /*
  * NodeMapIterator is a very small wrapper around flat_map::const_iterator.
  *
@@ -52,6 +63,14 @@ class NodeMapIterator
     return it_ != other.it_;
   }
 
+  /*
+   * Advance this and other, which point at the same node of two maps, past
+   * the nodes the maps share.
+   */
+  void skipShared(NodeMapIterator& other) {
+    skipSharedNodes(it_, other.it_);
+  }
+
  private:
   typename NodeContainer::const_iterator it_;
 };
@@ -26,6 +26,7 @@
 #include "fboss/agent/state/RouteTableMap.h"
 #include "fboss/agent/state/RouteTableRib.h"
 #include "fboss/agent/state/SflowCollector.h"
+#include "fboss/agent/state/StateDeltaChangeLog.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
@@ -118,6 +119,21 @@ StateDelta::getLabelForwardingInformationBaseDelta() const {
       new_->getLabelForwardingInformationBase().get());
 }
 
+const StateDeltaChangeLog& StateDelta::getChangeLog() const {
+  std::call_once(changeLogOnce_, [this]() {
+    changeLog_ = std::make_unique<StateDeltaChangeLog>(*this);
+    changeLogBuilt_.store(true, std::memory_order_release);
+  });
+  return *changeLog_;
+}
+
+const StateDeltaChangeLog* StateDelta::getChangeLogIfBuilt() const {
+  if (!changeLogBuilt_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return changeLog_.get();
+}
+
 std::ostream& operator<<(std::ostream& out, const StateDelta& stateDelta) {
   // Leverage the folly::dynamic printing facilities
   folly::dynamic diff = folly::dynamic::object;
@@ -9,8 +9,10 @@
  */
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <ostream>
 
 #include "fboss/agent/state/AclMap.h"
@@ -35,6 +37,7 @@ namespace facebook::fboss {
 
 class SwitchState;
 class ControlPlane;
+class StateDeltaChangeLog;
 
 /*
  * StateDelta contains code for examining the differences between two
@@ -72,6 +75,16 @@ class StateDelta {
   getLabelForwardingInformationBaseDelta() const;
   DeltaValue<SwitchSettings> getSwitchSettingsDelta() const;
 
+  /*
+   * Route and neighbor changes in this delta. Built on first use and shared
+   * by all later callers, safe to call from multiple threads.
+   */
+  const StateDeltaChangeLog& getChangeLog() const;
+  /*
+   * The change log if it has been built already, nullptr otherwise.
+   */
+  const StateDeltaChangeLog* getChangeLogIfBuilt() const;
+
  private:
   // Forbidden copy constructor and assignment operator
   StateDelta(StateDelta const&) = delete;
@@ -79,6 +92,9 @@ class StateDelta {
 
   std::shared_ptr<SwitchState> old_;
   std::shared_ptr<SwitchState> new_;
+  mutable std::once_flag changeLogOnce_;
+  mutable std::unique_ptr<StateDeltaChangeLog> changeLog_;
+  mutable std::atomic<bool> changeLogBuilt_{false};
 };
 
 std::ostream& operator<<(std::ostream& out, const StateDelta& stateDelta);
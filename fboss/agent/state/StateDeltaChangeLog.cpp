@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/StateDeltaChangeLog.h"
+
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/ForwardingInformationBaseContainer.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/Vlan.h"
+
+namespace {
+using namespace facebook::fboss;
+
+template <typename DeltaT>
+auto getID(const DeltaT& delta) {
+  return delta.getNew() ? delta.getNew()->getID() : delta.getOld()->getID();
+}
+} // namespace
+
+namespace facebook::fboss {
+
+StateDeltaChangeLog::StateDeltaChangeLog(const StateDelta& delta) {
+  for (const auto& rtDelta : delta.getRouteTablesDelta()) {
+    RouteChanges changes{getID(rtDelta),
+                         NodeChangeList<RouteV4>(rtDelta.getRoutesV4Delta()),
+                         NodeChangeList<RouteV6>(rtDelta.getRoutesV6Delta())};
+    if (!changes.v4.empty() || !changes.v6.empty()) {
+      routeTableChanges_.push_back(std::move(changes));
+    }
+  }
+  for (const auto& fibDelta : delta.getFibsDelta()) {
+    RouteChanges changes{getID(fibDelta),
+                         NodeChangeList<RouteV4>(fibDelta.getV4FibDelta()),
+                         NodeChangeList<RouteV6>(fibDelta.getV6FibDelta())};
+    if (!changes.v4.empty() || !changes.v6.empty()) {
+      fibChanges_.push_back(std::move(changes));
+    }
+  }
+  for (const auto& vlanDelta : delta.getVlansDelta()) {
+    NeighborChanges changes{getID(vlanDelta),
+                            NodeChangeList<ArpEntry>(vlanDelta.getArpDelta()),
+                            NodeChangeList<NdpEntry>(vlanDelta.getNdpDelta())};
+    if (!changes.arp.empty() || !changes.ndp.empty()) {
+      neighborChanges_.push_back(std::move(changes));
+    }
+  }
+}
+
+size_t StateDeltaChangeLog::numRouteChanges() const {
+  size_t numChanges = 0;
+  for (const auto& changes : routeTableChanges_) {
+    numChanges += changes.v4.size() + changes.v6.size();
+  }
+  for (const auto& changes : fibChanges_) {
+    numChanges += changes.v4.size() + changes.v6.size();
+  }
+  return numChanges;
+}
+
+size_t StateDeltaChangeLog::numNeighborChanges() const {
+  size_t numChanges = 0;
+  for (const auto& changes : neighborChanges_) {
+    numChanges += changes.arp.size() + changes.ndp.size();
+  }
+  return numChanges;
+}
+
+} // namespace facebook::fboss
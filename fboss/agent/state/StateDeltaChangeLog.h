@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/state/ArpEntry.h"
+#include "fboss/agent/state/NdpEntry.h"
+#include "fboss/agent/state/NodeMapDelta.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace facebook::fboss {
+
+class StateDelta;
+
+/*
+ * Materialized list of the nodes that changed between two NodeMaps.
+ *
+ * Iterating it yields DeltaValue entries just like a NodeMapDelta, so the
+ * DeltaFunctions helpers work on either.
+ */
+template <typename NODE>
+class NodeChangeList {
+ public:
+  using Node = NODE;
+  using const_iterator = typename std::vector<DeltaValue<Node>>::const_iterator;
+
+  NodeChangeList() {}
+  template <typename Delta>
+  explicit NodeChangeList(const Delta& delta) {
+    for (const auto& entry : delta) {
+      changes_.emplace_back(entry.getOld(), entry.getNew());
+    }
+  }
+
+  const_iterator begin() const {
+    return changes_.begin();
+  }
+  const_iterator end() const {
+    return changes_.end();
+  }
+  size_t size() const {
+    return changes_.size();
+  }
+  bool empty() const {
+    return changes_.empty();
+  }
+
+ private:
+  std::vector<DeltaValue<Node>> changes_;
+};
+
+/*
+ * Routes changed in one VRF, either in its route table or in its FIB.
+ */
+struct RouteChanges {
+  RouterID routerId;
+  NodeChangeList<RouteV4> v4;
+  NodeChangeList<RouteV6> v6;
+
+  template <typename AddrT>
+  const NodeChangeList<Route<AddrT>>& getRoutes() const {
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      return v4;
+    } else {
+      return v6;
+    }
+  }
+};
+
+/*
+ * Neighbor entries changed in one VLAN
+ */
+struct NeighborChanges {
+  VlanID vlanId;
+  NodeChangeList<ArpEntry> arp;
+  NodeChangeList<NdpEntry> ndp;
+
+  template <typename AddrT>
+  const auto& getNeighbors() const {
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      return arp;
+    } else {
+      return ndp;
+    }
+  }
+};
+
+/*
+ * The route and neighbor changes of a StateDelta, computed once.
+ *
+ * Route tables and neighbor tables are by far the largest maps in the
+ * SwitchState, and most state observers look at them. Merge-walking them
+ * once here, instead of once per observer, keeps the cost of a large
+ * delta independent of the number of observers. Only VRFs and VLANs with
+ * changes are listed.
+ */
+class StateDeltaChangeLog {
+ public:
+  explicit StateDeltaChangeLog(const StateDelta& delta);
+
+  const std::vector<RouteChanges>& getRouteTableChanges() const {
+    return routeTableChanges_;
+  }
+  const std::vector<RouteChanges>& getFibChanges() const {
+    return fibChanges_;
+  }
+  const std::vector<NeighborChanges>& getNeighborChanges() const {
+    return neighborChanges_;
+  }
+
+  size_t numRouteChanges() const;
+  size_t numNeighborChanges() const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  StateDeltaChangeLog(StateDeltaChangeLog const&) = delete;
+  StateDeltaChangeLog& operator=(StateDeltaChangeLog const&) = delete;
+
+  std::vector<RouteChanges> routeTableChanges_;
+  std::vector<RouteChanges> fibChanges_;
+  std::vector<NeighborChanges> neighborChanges_;
+};
+
+} // namespace facebook::fboss
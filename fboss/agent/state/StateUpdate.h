@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 
 #include <folly/FBString.h>
@@ -29,11 +31,42 @@ class SwitchState;
  * single update notification to the HwSwitch and other update subscribers.
  * Therefore the applyUpdate() may be called with an unpublished SwitchState in
  * some cases.
+ *
+ * Pending updates are queued in one lane per Priority.  The update thread
+ * drains higher priority lanes first, so updates are only guaranteed to be
+ * applied in the order they were scheduled within the same priority.
  */
 class StateUpdate {
  public:
-  explicit StateUpdate(folly::StringPiece name, bool allowCoalesce = true)
-      : name_(name.str()), allowCoalesce_(allowCoalesce) {}
+  enum class Priority : uint8_t {
+    // Link protocol, neighbor and MAC learning updates, which bound
+    // convergence times and are cheap to apply
+    HIGH,
+    NORMAL,
+    // Bulk route programming and config updates
+    LOW,
+  };
+  static constexpr size_t kNumPriorities = 3;
+
+  static const char* getPriorityName(Priority priority) {
+    switch (priority) {
+      case Priority::HIGH:
+        return "high";
+      case Priority::NORMAL:
+        return "normal";
+      case Priority::LOW:
+        return "low";
+    }
+    return "unknown";
+  }
+
+  explicit StateUpdate(
+      folly::StringPiece name,
+      bool allowCoalesce = true,
+      Priority priority = Priority::NORMAL)
+      : name_(name.str()),
+        allowCoalesce_(allowCoalesce),
+        priority_(priority) {}
   virtual ~StateUpdate() {}
 
   const std::string& getName() const {
@@ -44,6 +77,10 @@ class StateUpdate {
     return allowCoalesce_;
   }
 
+  Priority getPriority() const {
+    return priority_;
+  }
+
   /*
    * Apply the update, and return a new SwitchState.
    *
@@ -84,6 +121,9 @@ class StateUpdate {
 
   std::string name_;
   bool allowCoalesce_;
+  Priority priority_;
+  // When the update was queued, set by SwSwitch
+  std::chrono::steady_clock::time_point queuedAt_;
 
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
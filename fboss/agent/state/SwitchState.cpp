@@ -104,6 +104,40 @@ folly::dynamic SwitchStateFields::toFollyDynamic() const {
   return switchState;
 }
 
+folly::dynamic SwitchStateFields::changedFieldsToFollyDynamic(
+    const SwitchStateFields& old) const {
+  folly::dynamic switchState = folly::dynamic::object;
+  auto serializeIfChanged = [&](const char* key,
+                                const auto& field,
+                                const auto& oldField) {
+    if (field != oldField) {
+      switchState[key] = field->toFollyDynamic();
+    }
+  };
+  serializeIfChanged(kInterfaces, interfaces, old.interfaces);
+  serializeIfChanged(kPorts, ports, old.ports);
+  serializeIfChanged(kVlans, vlans, old.vlans);
+  serializeIfChanged(kRouteTables, routeTables, old.routeTables);
+  serializeIfChanged(kAcls, acls, old.acls);
+  serializeIfChanged(kSflowCollectors, sFlowCollectors, old.sFlowCollectors);
+  if (defaultVlan != old.defaultVlan) {
+    switchState[kDefaultVlan] = static_cast<uint32_t>(defaultVlan);
+  }
+  serializeIfChanged(kControlPlane, controlPlane, old.controlPlane);
+  serializeIfChanged(kLoadBalancers, loadBalancers, old.loadBalancers);
+  serializeIfChanged(kMirrors, mirrors, old.mirrors);
+  serializeIfChanged(kAggregatePorts, aggPorts, old.aggPorts);
+  serializeIfChanged(kLabelForwardingInformationBase, labelFib, old.labelFib);
+  serializeIfChanged(kSwitchSettings, switchSettings, old.switchSettings);
+  if (defaultDataPlaneQosPolicy != old.defaultDataPlaneQosPolicy) {
+    switchState[kDefaultDataplaneQosPolicy] = defaultDataPlaneQosPolicy
+        ? defaultDataPlaneQosPolicy->toFollyDynamic()
+        : folly::dynamic(nullptr);
+  }
+  serializeIfChanged(kQosPolicies, qosPolicies, old.qosPolicies);
+  return switchState;
+}
+
 SwitchStateFields SwitchStateFields::fromFollyDynamic(
     const folly::dynamic& swJson) {
   SwitchStateFields switchState;
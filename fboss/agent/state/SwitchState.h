@@ -67,6 +67,14 @@ struct SwitchStateFields {
    * Serialize to folly::dynamic
    */
   folly::dynamic toFollyDynamic() const;
+  /*
+   * Serialize only the fields that differ from old, in the format of
+   * toFollyDynamic(). An optional field that old has and we don't maps to
+   * null. Fields are compared by pointer, so this is cheap for states derived
+   * from one another.
+   */
+  folly::dynamic changedFieldsToFollyDynamic(
+      const SwitchStateFields& old) const;
   /*
    * Reconstruct object from folly::dynamic
    */
@@ -177,6 +185,10 @@ class SwitchState : public NodeBaseT<SwitchState, SwitchStateFields> {
     return getFields()->toFollyDynamic();
   }
 
+  folly::dynamic changedFieldsToFollyDynamic(const SwitchState& old) const {
+    return getFields()->changedFieldsToFollyDynamic(*old.getFields());
+  }
+
   static void modify(std::shared_ptr<SwitchState>* state);
 
   template <typename EntryClassT, typename NTableT>
@@ -631,3 +631,46 @@ TEST(Acl, TrafficCounterCompatibility) {
   EXPECT_EQ(aclAction.getTrafficCounter()->types.size(), 1);
   EXPECT_EQ(aclAction.getTrafficCounter()->types[0], cfg::CounterType::PACKETS);
 }
+
+TEST(Acl, ApplyConfigFingerprints) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  cfg::SwitchConfig config;
+  config.acls.resize(1);
+  config.acls[0].name = "acl0";
+  config.acls[0].actionType = cfg::AclActionType::DENY;
+  config.acls[0].srcPort_ref() = 5;
+
+  ThriftConfigFingerprints fingerprints;
+  stateV0->publish();
+  auto stateV1 = applyThriftConfig(
+      stateV0, &config, platform.get(), nullptr, &fingerprints);
+  ASSERT_NE(nullptr, stateV1);
+  ASSERT_NE(fingerprints.end(), fingerprints.find("acls"));
+  EXPECT_EQ(stateV1->getAcls(), fingerprints["acls"].node);
+
+  // Same config against the state it produced: nothing to do
+  stateV1->publish();
+  EXPECT_EQ(
+      nullptr,
+      applyThriftConfig(
+          stateV1, &config, platform.get(), nullptr, &fingerprints));
+
+  // ACLs changed behind the applier's back must be recomputed
+  auto stateV2 = stateV1->clone();
+  stateV2->resetAcls(make_shared<AclMap>());
+  stateV2->publish();
+  auto stateV3 = applyThriftConfig(
+      stateV2, &config, platform.get(), nullptr, &fingerprints);
+  ASSERT_NE(nullptr, stateV3);
+  ASSERT_NE(nullptr, stateV3->getAcl("acl0"));
+
+  // Config change must be picked up
+  config.acls[0].srcPort_ref() = 6;
+  stateV3->publish();
+  auto stateV4 = applyThriftConfig(
+      stateV3, &config, platform.get(), nullptr, &fingerprints);
+  ASSERT_NE(nullptr, stateV4);
+  EXPECT_EQ(6, stateV4->getAcl("acl0")->getSrcPort());
+}
@@ -8,6 +8,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace ::testing;
 using namespace facebook::fboss;
 
@@ -426,3 +428,88 @@ TEST(LabelFIBTests, oneLabelManyClients) {
   // 7) next hop for 5002 label is now the one informed by bgp
   EXPECT_EQ(entryToAdd5002Bgp->getLabelNextHop(), entry5002->getLabelNextHop());
 }
+
+TEST(LabelFIBTests, iterateInLabelOrder) {
+  auto lFib = std::make_shared<LabelForwardingInformationBase>();
+  std::vector<LabelForwardingEntry::Label> labels{
+      300000, 5, 1000, 256, 255, 0};
+  for (auto label : labels) {
+    lFib->addNode(std::make_shared<LabelForwardingEntry>(
+        label,
+        ClientID::OPENR,
+        util::getSwapLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED)));
+  }
+  EXPECT_EQ(lFib->size(), labels.size());
+
+  std::sort(labels.begin(), labels.end());
+  std::vector<LabelForwardingEntry::Label> iterated;
+  for (const auto& entry : *lFib) {
+    iterated.push_back(entry->getID());
+  }
+  EXPECT_EQ(iterated, labels);
+
+  iterated.clear();
+  for (auto iter = lFib->rbegin(); iter != lFib->rend(); ++iter) {
+    iterated.push_back((*iter)->getID());
+  }
+  std::reverse(iterated.begin(), iterated.end());
+  EXPECT_EQ(iterated, labels);
+}
+
+TEST(LabelFIBTests, outOfRangeLabel) {
+  auto lFib = std::make_shared<LabelForwardingInformationBase>();
+  EXPECT_EQ(nullptr, lFib->getLabelForwardingEntryIf(1 << 20));
+  EXPECT_THROW(
+      lFib->addNode(std::make_shared<LabelForwardingEntry>(
+          1 << 20,
+          ClientID::OPENR,
+          util::getSwapLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED))),
+      FbossError);
+}
+
+TEST(LabelFIBTests, deltaAcrossPages) {
+  auto oldFib = std::make_shared<LabelForwardingInformationBase>();
+  for (int label = 1000; label < 5000; ++label) {
+    oldFib->addNode(std::make_shared<LabelForwardingEntry>(
+        label,
+        ClientID::OPENR,
+        util::getSwapLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED)));
+  }
+  oldFib->publish();
+
+  // Touch one label in each of three pages
+  auto newFib = oldFib->clone();
+  auto changed = newFib->getLabelForwardingEntry(1500)->clone();
+  changed->update(
+      ClientID::BGPD,
+      util::getPushLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED));
+  newFib->updateNode(changed);
+  newFib->removeNode(3000);
+  newFib->addNode(std::make_shared<LabelForwardingEntry>(
+      6000,
+      ClientID::OPENR,
+      util::getSwapLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED)));
+  newFib->publish();
+
+  // Untouched pages are still shared
+  EXPECT_EQ(
+      oldFib->getLabelForwardingEntry(1499),
+      newFib->getLabelForwardingEntry(1499));
+
+  using EntryPtr = std::shared_ptr<LabelForwardingEntry>;
+  std::vector<int> changedLabels, removedLabels, addedLabels;
+  DeltaFunctions::forEachChanged(
+      NodeMapDelta<LabelForwardingInformationBase>(oldFib.get(), newFib.get()),
+      [&](const EntryPtr& oldEntry, const EntryPtr& /*newEntry*/) {
+        changedLabels.push_back(oldEntry->getID());
+      },
+      [&](const EntryPtr& newEntry) {
+        addedLabels.push_back(newEntry->getID());
+      },
+      [&](const EntryPtr& oldEntry) {
+        removedLabels.push_back(oldEntry->getID());
+      });
+  EXPECT_EQ(changedLabels, std::vector<int>{1500});
+  EXPECT_EQ(removedLabels, std::vector<int>{3000});
+  EXPECT_EQ(addedLabels, std::vector<int>{6000});
+}
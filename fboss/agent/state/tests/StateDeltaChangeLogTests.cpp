@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/state/StateDeltaChangeLog.h"
+
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/DeltaFunctions.h"
+#include "fboss/agent/state/RouteUpdater.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+
+namespace {
+const ClientID kClientA(1001);
+const RouterID kRid0(0);
+
+std::shared_ptr<SwitchState> addRoutes(
+    const std::shared_ptr<SwitchState>& state) {
+  RouteUpdater updater(state->getRouteTables());
+  RouteNextHopSet nhops = makeNextHops({"10.0.0.22"});
+  updater.addRoute(
+      kRid0,
+      IPAddressV4("20.1.1.0"),
+      24,
+      kClientA,
+      RouteNextHopEntry(nhops, AdminDistance::STATIC_ROUTE));
+  updater.addRoute(
+      kRid0,
+      IPAddressV6("2001::"),
+      48,
+      kClientA,
+      RouteNextHopEntry(
+          RouteForwardAction::DROP, AdminDistance::STATIC_ROUTE));
+  auto newTables = updater.updateDone();
+  EXPECT_NE(nullptr, newTables);
+  newTables->publish();
+  auto newState = state->clone();
+  newState->resetRouteTables(newTables);
+  return newState;
+}
+
+std::shared_ptr<SwitchState> addArpEntry(
+    const std::shared_ptr<SwitchState>& state) {
+  auto newState = state->clone();
+  auto vlan = newState->getVlans()->getVlan(VlanID(1)).get();
+  auto arpTable = vlan->getArpTable()->modify(&vlan, &newState);
+  arpTable->addEntry(
+      IPAddressV4("10.0.0.22"),
+      MacAddress("02:00:00:00:00:22"),
+      PortDescriptor(PortID(1)),
+      InterfaceID(1));
+  return newState;
+}
+} // namespace
+
+TEST(StateDeltaChangeLog, RoutesAndNeighbors) {
+  auto stateV0 = testStateA();
+  stateV0->publish();
+  auto stateV1 = addArpEntry(addRoutes(stateV0));
+  stateV1->publish();
+
+  StateDelta delta(stateV0, stateV1);
+  EXPECT_EQ(delta.getChangeLogIfBuilt(), nullptr);
+  const auto& changeLog = delta.getChangeLog();
+  // Built once, then shared
+  EXPECT_EQ(&changeLog, &delta.getChangeLog());
+  EXPECT_EQ(&changeLog, delta.getChangeLogIfBuilt());
+
+  ASSERT_EQ(changeLog.getRouteTableChanges().size(), 1);
+  const auto& routeChanges = changeLog.getRouteTableChanges()[0];
+  EXPECT_EQ(routeChanges.routerId, kRid0);
+  ASSERT_EQ(routeChanges.v4.size(), 1);
+  ASSERT_EQ(routeChanges.v6.size(), 1);
+  auto v4Route = routeChanges.getRoutes<IPAddressV4>().begin()->getNew();
+  EXPECT_EQ(v4Route->prefix().str(), "20.1.1.0/24");
+  EXPECT_TRUE(changeLog.getFibChanges().empty());
+  EXPECT_EQ(changeLog.numRouteChanges(), 2);
+
+  ASSERT_EQ(changeLog.getNeighborChanges().size(), 1);
+  const auto& neighborChanges = changeLog.getNeighborChanges()[0];
+  EXPECT_EQ(neighborChanges.vlanId, VlanID(1));
+  EXPECT_TRUE(neighborChanges.ndp.empty());
+  EXPECT_EQ(changeLog.numNeighborChanges(), 1);
+
+  // DeltaFunctions work on the change log like on a NodeMapDelta
+  int added = 0;
+  DeltaFunctions::forEachAdded(
+      neighborChanges.getNeighbors<IPAddressV4>(),
+      [&](const std::shared_ptr<ArpEntry>& entry) {
+        EXPECT_EQ(entry->getIP(), IPAddressV4("10.0.0.22"));
+        ++added;
+      });
+  EXPECT_EQ(added, 1);
+  EXPECT_FALSE(DeltaFunctions::isEmpty(neighborChanges.arp));
+}
+
+TEST(StateDeltaChangeLog, NoChanges) {
+  auto stateV0 = testStateA();
+  stateV0->publish();
+  auto stateV1 = stateV0->clone();
+  stateV1->publish();
+
+  StateDelta delta(stateV0, stateV1);
+  const auto& changeLog = delta.getChangeLog();
+  EXPECT_TRUE(changeLog.getRouteTableChanges().empty());
+  EXPECT_TRUE(changeLog.getFibChanges().empty());
+  EXPECT_TRUE(changeLog.getNeighborChanges().empty());
+}
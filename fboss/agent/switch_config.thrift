@@ -1091,6 +1091,34 @@ struct SwitchSettings {
   1: L2LearningMode l2LearningMode = L2LearningMode.HARDWARE
 }
 
+enum IcmpErrorType {
+  TIME_EXCEEDED = 0,
+  PACKET_TOO_BIG = 1,
+}
+
+/*
+ * Token bucket for ICMP errors generated by the agent. A rate of 0 means
+ * unlimited. If burstSize is 0 the bucket holds one second worth of tokens.
+ */
+struct IcmpErrorRateLimit {
+  1: i32 packetsPerSecond = 0
+  2: i32 burstSize = 0
+}
+
+/*
+ * Rate limits for ICMP errors (time exceeded, packet too big) that the
+ * agent generates in software for trapped packets. An error is only sent if
+ * both the bucket of the ingress interface and the bucket of the source
+ * address of the offending packet have a token left. The override maps
+ * replace the default limit for the given error type.
+ */
+struct IcmpErrorRateLimitConfig {
+  1: IcmpErrorRateLimit perInterface
+  2: IcmpErrorRateLimit perSource
+  3: map<IcmpErrorType, IcmpErrorRateLimit> perInterfaceOverrides = {}
+  4: map<IcmpErrorType, IcmpErrorRateLimit> perSourceOverrides = {}
+}
+
 /**
  * The configuration for a switch.
  *
@@ -1191,4 +1219,7 @@ struct SwitchConfig {
   40: map<PortQueueConfigName, list<PortQueue>> portQueueConfigs = {}
 
   41: SwitchSettings switchSettings
+
+  // Rate limits for ICMP errors generated by the agent, unlimited if unset
+  42: optional IcmpErrorRateLimitConfig icmpErrorRateLimits
 }
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/IcmpErrorRateLimiter.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+
+namespace {
+const VlanID kVlan1(1);
+const VlanID kVlan2(2);
+const IPAddress kSrc1("2401:db00::1");
+const IPAddress kSrc2("10.0.0.2");
+
+cfg::IcmpErrorRateLimit makeLimit(int32_t rate, int32_t burst) {
+  cfg::IcmpErrorRateLimit limit;
+  limit.packetsPerSecond = rate;
+  limit.burstSize = burst;
+  return limit;
+}
+
+int numAllowed(
+    IcmpErrorRateLimiter& limiter,
+    int attempts,
+    cfg::IcmpErrorType type,
+    VlanID vlan,
+    const IPAddress& src,
+    double now) {
+  int allowed = 0;
+  for (int i = 0; i < attempts; ++i) {
+    if (limiter.allow(type, vlan, src, now)) {
+      ++allowed;
+    }
+  }
+  return allowed;
+}
+} // namespace
+
+TEST(IcmpErrorRateLimiter, UnlimitedByDefault) {
+  IcmpErrorRateLimiter limiter;
+  EXPECT_EQ(
+      1000,
+      numAllowed(
+          limiter, 1000, cfg::IcmpErrorType::TIME_EXCEEDED, kVlan1, kSrc1, 1));
+  EXPECT_EQ(0, limiter.numSourceBuckets());
+}
+
+TEST(IcmpErrorRateLimiter, PerInterface) {
+  IcmpErrorRateLimiter limiter;
+  cfg::IcmpErrorRateLimitConfig config;
+  config.perInterface = makeLimit(10, 5);
+  limiter.updateConfig(&config);
+
+  auto type = cfg::IcmpErrorType::TIME_EXCEEDED;
+  // Burst is shared by all sources on the interface
+  EXPECT_EQ(3, numAllowed(limiter, 3, type, kVlan1, kSrc1, 100));
+  EXPECT_EQ(2, numAllowed(limiter, 10, type, kVlan1, kSrc2, 100));
+  // Other interfaces have their own bucket
+  EXPECT_EQ(5, numAllowed(limiter, 10, type, kVlan2, kSrc1, 100));
+  // Refills at the configured rate
+  EXPECT_EQ(1, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100.1));
+  EXPECT_EQ(5, numAllowed(limiter, 10, type, kVlan1, kSrc1, 200));
+}
+
+TEST(IcmpErrorRateLimiter, PerSource) {
+  IcmpErrorRateLimiter limiter;
+  cfg::IcmpErrorRateLimitConfig config;
+  config.perInterface = makeLimit(100, 4);
+  config.perSource = makeLimit(1, 2);
+  limiter.updateConfig(&config);
+
+  auto type = cfg::IcmpErrorType::TIME_EXCEEDED;
+  EXPECT_EQ(2, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100));
+  // Errors suppressed for kSrc1 did not use up the interface bucket
+  EXPECT_EQ(2, numAllowed(limiter, 10, type, kVlan1, kSrc2, 100));
+  EXPECT_EQ(2, limiter.numSourceBuckets());
+}
+
+TEST(IcmpErrorRateLimiter, TypeOverrides) {
+  IcmpErrorRateLimiter limiter;
+  cfg::IcmpErrorRateLimitConfig config;
+  config.perInterface = makeLimit(1, 1);
+  config.perInterfaceOverrides[cfg::IcmpErrorType::PACKET_TOO_BIG] =
+      makeLimit(0, 0);
+  limiter.updateConfig(&config);
+
+  EXPECT_EQ(
+      1,
+      numAllowed(
+          limiter, 10, cfg::IcmpErrorType::TIME_EXCEEDED, kVlan1, kSrc1, 100));
+  EXPECT_EQ(
+      10,
+      numAllowed(
+          limiter, 10, cfg::IcmpErrorType::PACKET_TOO_BIG, kVlan1, kSrc1, 100));
+}
+
+TEST(IcmpErrorRateLimiter, ConfigChange) {
+  IcmpErrorRateLimiter limiter;
+  cfg::IcmpErrorRateLimitConfig config;
+  config.perInterface = makeLimit(1, 1);
+  limiter.updateConfig(&config);
+
+  auto type = cfg::IcmpErrorType::TIME_EXCEEDED;
+  EXPECT_EQ(1, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100));
+  // Same config keeps the buckets
+  limiter.updateConfig(&config);
+  EXPECT_EQ(0, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100));
+  // New limits start with full buckets
+  config.perInterface = makeLimit(2, 2);
+  limiter.updateConfig(&config);
+  EXPECT_EQ(2, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100));
+  // Removing the config removes the limits
+  limiter.updateConfig(nullptr);
+  EXPECT_EQ(10, numAllowed(limiter, 10, type, kVlan1, kSrc1, 100));
+}
+
+TEST(IcmpErrorRateLimiter, SourceBucketsBounded) {
+  IcmpErrorRateLimiter limiter;
+  cfg::IcmpErrorRateLimitConfig config;
+  config.perSource = makeLimit(1, 1);
+  limiter.updateConfig(&config);
+
+  auto type = cfg::IcmpErrorType::TIME_EXCEEDED;
+  auto fillSourceBuckets = [&](uint32_t num, double now) {
+    for (uint32_t i = 0; i < num; ++i) {
+      EXPECT_TRUE(limiter.allow(
+          type, kVlan1, IPAddress::fromLongHBO(0x0a000000 + i), now));
+    }
+  };
+  auto kMax = IcmpErrorRateLimiter::kMaxSourceBuckets;
+  fillSourceBuckets(kMax, 100);
+  EXPECT_EQ(kMax, limiter.numSourceBuckets());
+  // All buckets are in use, so they are all reset
+  EXPECT_TRUE(limiter.allow(type, kVlan1, kSrc1, 100));
+  EXPECT_EQ(1, limiter.numSourceBuckets());
+
+  fillSourceBuckets(kMax - 1, 100);
+  EXPECT_EQ(kMax, limiter.numSourceBuckets());
+  // Buckets that filled up again are pruned
+  EXPECT_TRUE(limiter.allow(type, kVlan1, IPAddress("2401:db00::2"), 200));
+  EXPECT_EQ(1, limiter.numSourceBuckets());
+}
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/state/LabelForwardingInformationBase.h"
+#include "fboss/agent/state/NodeMapDelta-defs.h"
+#include "fboss/agent/test/LabelForwardingUtils.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr int kNumLabels = 100000;
+constexpr int kLabelsPerUpdate = 100;
+
+std::shared_ptr<LabelForwardingEntry> makeEntry(int label) {
+  return std::make_shared<LabelForwardingEntry>(
+      label,
+      ClientID::OPENR,
+      util::getSwapLabelNextHopEntry(AdminDistance::DIRECTLY_CONNECTED));
+}
+
+std::shared_ptr<LabelForwardingInformationBase> makeLabelFib() {
+  auto labelFib = std::make_shared<LabelForwardingInformationBase>();
+  for (int label = 0; label < kNumLabels; ++label) {
+    labelFib->addNode(makeEntry(label));
+  }
+  labelFib->publish();
+  return labelFib;
+}
+} // namespace
+
+/*
+ * LSP churn: each update withdraws and re-adds a few random labels on a
+ * clone of the label FIB, then walks the delta like a HwSwitch would.
+ */
+BENCHMARK(LabelFibChurn, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto labelFib = makeLabelFib();
+  std::vector<std::vector<int>> updates(iters);
+  for (auto& labels : updates) {
+    for (int i = 0; i < kLabelsPerUpdate; ++i) {
+      labels.push_back(folly::Random::rand32(kNumLabels));
+    }
+  }
+  suspender.dismiss();
+
+  size_t numChanges = 0;
+  for (const auto& labels : updates) {
+    auto newFib = labelFib->clone();
+    for (auto label : labels) {
+      newFib->removeNodeIf(label);
+      newFib->addNode(makeEntry(label));
+    }
+    newFib->publish();
+    NodeMapDelta<LabelForwardingInformationBase> delta(
+        labelFib.get(), newFib.get());
+    for (const auto& change : delta) {
+      numChanges += change.getNew() ? 1 : 0;
+    }
+    labelFib = std::move(newFib);
+  }
+  folly::doNotOptimizeAway(numChanges);
+}
+
+BENCHMARK(LabelFibLookup, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto labelFib = makeLabelFib();
+  suspender.dismiss();
+
+  size_t found = 0;
+  for (unsigned int i = 0; i < iters; ++i) {
+    auto label = folly::Random::rand32(kNumLabels);
+    found += labelFib->getLabelForwardingEntryIf(label) ? 1 : 0;
+  }
+  folly::doNotOptimizeAway(found);
+}
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
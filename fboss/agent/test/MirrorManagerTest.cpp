@@ -12,6 +12,10 @@
 #include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
+DECLARE_int32(state_update_recorder_size);
+
 using folly::IPAddress;
 using folly::IPAddressV4;
 using folly::IPAddressV6;
@@ -250,6 +254,17 @@ class MirrorManagerTest : public ::testing::Test {
     runInUpdateEventBaseAndWait([]() {});
   }
 
+  // Number of mirror resolutions scheduled among the recorded state updates
+  size_t numMirrorResolutions() const {
+    const auto* recorder = sw_->getStateUpdateRecorder();
+    CHECK(recorder);
+    auto records = recorder->getRecords(FLAGS_state_update_recorder_size);
+    return std::count_if(
+        records.begin(), records.end(), [](const auto& record) {
+          return record.name == "Updating mirrors";
+        });
+  }
+
   std::unique_ptr<HwTestHandle> handle_;
   SwSwitch* sw_;
 };
@@ -919,6 +934,73 @@ TYPED_TEST(MirrorManagerTest, EmptyDelta) {
   });
 }
 
+TYPED_TEST(MirrorManagerTest, SkipResolutionOnUnrelatedChanges) {
+  const auto params = MirrorManagerTestParams<TypeParam>::getParams();
+
+  this->updateState(
+      "SkipResolutionOnUnrelatedChanges",
+      [=](const std::shared_ptr<SwitchState>& state) {
+        auto updatedState =
+            this->addErspanMirror(state, kMirrorName, params.mirrorDestination);
+        updatedState = this->addNeighbor(
+            updatedState,
+            params.interfaces[0],
+            params.neighborIPs[0],
+            params.neighborMACs[0],
+            params.neighborPorts[0]);
+        RouteNextHopSet nextHops = {params.nextHop(0)};
+        return this->addRoute(updatedState, params.longerPrefix, nextHops);
+      });
+
+  std::shared_ptr<Mirror> resolvedMirror;
+  size_t numResolutions = 0;
+  this->verifyStateUpdate([&]() {
+    resolvedMirror =
+        this->sw_->getState()->getMirrors()->getMirrorIf(kMirrorName);
+    ASSERT_NE(resolvedMirror, nullptr);
+    EXPECT_TRUE(resolvedMirror->isResolved());
+    numResolutions = this->numMirrorResolutions();
+    EXPECT_GT(numResolutions, 0);
+  });
+
+  // Neither a less specific route nor an unused neighbor can change the
+  // resolution, so the mirror is left alone.
+  this->updateState(
+      "SkipResolutionOnUnrelatedChanges",
+      [=](const std::shared_ptr<SwitchState>& state) {
+        RouteNextHopSet nextHops = {params.nextHop(1)};
+        auto updatedState =
+            this->addRoute(state, params.shorterPrefix, nextHops);
+        return this->addNeighbor(
+            updatedState,
+            params.interfaces[1],
+            params.neighborIPs[1],
+            params.neighborMACs[1],
+            params.neighborPorts[1]);
+      });
+
+  this->verifyStateUpdate([&]() {
+    auto mirror = this->sw_->getState()->getMirrors()->getMirrorIf(kMirrorName);
+    EXPECT_EQ(mirror, resolvedMirror);
+    // Not even a resolution finding nothing changed was scheduled
+    EXPECT_EQ(this->numMirrorResolutions(), numResolutions);
+  });
+
+  // The neighbor the mirror resolved through goes away
+  this->updateState(
+      "SkipResolutionOnUnrelatedChanges",
+      [=](const std::shared_ptr<SwitchState>& state) {
+        return this->delNeighbor(
+            state, params.interfaces[0], params.neighborIPs[0]);
+      });
+
+  this->verifyStateUpdate([&]() {
+    auto mirror = this->sw_->getState()->getMirrors()->getMirrorIf(kMirrorName);
+    ASSERT_NE(mirror, nullptr);
+    EXPECT_FALSE(mirror->isResolved());
+  });
+}
+
 // test for gre src ip resolved
 TYPED_TEST(MirrorManagerTest, GreMirrorWithSrcIp) {
   const auto params = MirrorManagerTestParams<TypeParam>::getParams();
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "fboss/agent/StateChangePublisher.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(state_change_subscriber_queue_size);
+DECLARE_int32(state_change_coalesce_ms);
+
+using namespace facebook::fboss;
+
+namespace {
+
+std::shared_ptr<SwitchState> setPortUp(
+    std::shared_ptr<SwitchState> state,
+    int portId,
+    bool up) {
+  state->publish();
+  auto newState = state;
+  auto port = newState->getPorts()->getPort(PortID(portId))->modify(&newState);
+  port->setOperState(up);
+  return newState;
+}
+
+class StateChangePublisherTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    FLAGS_state_change_coalesce_ms = 0;
+    handle = createTestHandle();
+    publisher = std::make_unique<StateChangePublisher>(handle->getSw());
+    state = testStateA();
+  }
+
+  void subscribe(std::set<StateChangeKind> kinds) {
+    publisher->subscribe(
+        &evb,
+        std::move(kinds),
+        [this](StateChangeBatch batch, std::function<void(bool)> done) {
+          batches.push_back(std::move(batch));
+          outstanding = std::move(done);
+        });
+  }
+
+  void updatePort(int portId, bool up) {
+    auto newState = setPortUp(state, portId, up);
+    publisher->stateUpdated(StateDelta(state, newState));
+    state = newState;
+  }
+
+  void ack(bool ok = true) {
+    ASSERT_TRUE(outstanding);
+    auto done = std::move(outstanding);
+    outstanding = nullptr;
+    done(ok);
+    evb.loop();
+  }
+
+  gflags::FlagSaver flagSaver;
+  std::unique_ptr<HwTestHandle> handle;
+  std::unique_ptr<StateChangePublisher> publisher;
+  std::shared_ptr<SwitchState> state;
+  folly::EventBase evb;
+  std::vector<StateChangeBatch> batches;
+  std::function<void(bool)> outstanding;
+};
+} // namespace
+
+TEST_F(StateChangePublisherTest, CoalesceWhileBatchOutstanding) {
+  subscribe({StateChangeKind::PORT});
+  updatePort(1, true);
+  evb.loop();
+  ASSERT_EQ(batches.size(), 1);
+  ASSERT_EQ(batches[0].changes.size(), 1);
+  EXPECT_EQ(batches[0].changes[0].kind, StateChangeKind::PORT);
+  EXPECT_EQ(batches[0].changes[0].key, "1");
+  EXPECT_TRUE(*batches[0].changes[0].up_ref());
+
+  // Nothing is sent until the outstanding batch completes
+  updatePort(1, false);
+  updatePort(1, true);
+  updatePort(2, true);
+  evb.loop();
+  EXPECT_EQ(batches.size(), 1);
+
+  // Port 1 flapped, but only its latest state is sent
+  ack();
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_FALSE(batches[1].resync);
+  ASSERT_EQ(batches[1].changes.size(), 2);
+  for (const auto& change : batches[1].changes) {
+    EXPECT_FALSE(change.removed);
+    EXPECT_TRUE(*change.up_ref());
+  }
+
+  // Nothing left to send
+  ack();
+  EXPECT_EQ(batches.size(), 2);
+}
+
+TEST_F(StateChangePublisherTest, ResyncOnOverflow) {
+  FLAGS_state_change_subscriber_queue_size = 1;
+  subscribe({StateChangeKind::PORT});
+  updatePort(1, true);
+  evb.loop();
+  ASSERT_EQ(batches.size(), 1);
+
+  updatePort(2, true);
+  updatePort(3, true);
+  ack();
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_TRUE(batches[1].resync);
+  EXPECT_TRUE(batches[1].changes.empty());
+
+  // Back to regular batches once resynced
+  updatePort(4, true);
+  ack();
+  ASSERT_EQ(batches.size(), 3);
+  EXPECT_FALSE(batches[2].resync);
+  EXPECT_EQ(batches[2].changes.size(), 1);
+}
+
+TEST_F(StateChangePublisherTest, FilterByKind) {
+  subscribe({StateChangeKind::NEIGHBOR, StateChangeKind::ROUTE});
+  updatePort(1, true);
+  evb.loop();
+  EXPECT_TRUE(batches.empty());
+}
+
+TEST_F(StateChangePublisherTest, DropBrokenSubscriber) {
+  subscribe({StateChangeKind::PORT});
+  EXPECT_EQ(publisher->numSubscribers(), 1);
+  updatePort(1, true);
+  evb.loop();
+  ack(false);
+  updatePort(2, true);
+  evb.loop();
+  EXPECT_EQ(batches.size(), 1);
+  EXPECT_EQ(publisher->numSubscribers(), 0);
+}
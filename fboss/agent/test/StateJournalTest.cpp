@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/StateJournal.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/QosPolicy.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+DECLARE_int32(state_journal_compaction_percent);
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+using folly::MacAddress;
+
+namespace {
+std::shared_ptr<SwitchState> addArpEntry(
+    const std::shared_ptr<SwitchState>& state,
+    int host) {
+  auto newState = state->clone();
+  auto vlan = newState->getVlans()->getVlan(VlanID(1)).get();
+  auto arpTable = vlan->getArpTable()->modify(&vlan, &newState);
+  arpTable->addEntry(
+      IPAddressV4(folly::to<std::string>("10.0.0.", host)),
+      MacAddress::fromHBO(host),
+      PortDescriptor(PortID(1)),
+      InterfaceID(1));
+  newState->publish();
+  return newState;
+}
+
+std::shared_ptr<SwitchState> setDefaultQosPolicy(
+    const std::shared_ptr<SwitchState>& state,
+    std::shared_ptr<QosPolicy> qosPolicy) {
+  auto newState = state->clone();
+  newState->setDefaultDataPlaneQosPolicy(std::move(qosPolicy));
+  newState->publish();
+  return newState;
+}
+} // namespace
+
+class StateJournalTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    state_ = testStateA();
+    state_->publish();
+  }
+
+  folly::test::TemporaryDirectory dir_;
+  std::shared_ptr<SwitchState> state_;
+};
+
+TEST_F(StateJournalTest, replayDeltas) {
+  StateJournal journal(dir_.path().string(), state_);
+  auto state = addArpEntry(state_, 10);
+  journal.append(state);
+  state = setDefaultQosPolicy(
+      state, std::make_shared<QosPolicy>("qp", DscpMap()));
+  journal.append(state);
+  state = addArpEntry(state, 11);
+  journal.append(state);
+  // Removed optional fields are journaled too
+  state = setDefaultQosPolicy(state, nullptr);
+
+  auto journalRef = journal.flush(state);
+  ASSERT_TRUE(journalRef);
+  EXPECT_EQ(
+      StateJournal::replay(dir_.path().string(), *journalRef),
+      state->toFollyDynamic());
+}
+
+TEST_F(StateJournalTest, replayAfterCompaction) {
+  gflags::FlagSaver flagSaver;
+  // Compact after every delta or two
+  FLAGS_state_journal_compaction_percent = 1;
+
+  StateJournal journal(dir_.path().string(), state_);
+  auto state = state_;
+  for (int host = 10; host < 20; ++host) {
+    state = addArpEntry(state, host);
+    journal.append(state);
+  }
+  auto journalRef = journal.flush(state);
+  ASSERT_TRUE(journalRef);
+  EXPECT_EQ(
+      StateJournal::replay(dir_.path().string(), *journalRef),
+      state->toFollyDynamic());
+}
+
+TEST_F(StateJournalTest, sizeBounded) {
+  StateJournal journal(dir_.path().string(), state_);
+  auto state = state_;
+  for (int host = 10; host < 210; ++host) {
+    state = addArpEntry(state, host);
+    journal.append(state);
+  }
+  ASSERT_TRUE(journal.flush(state));
+
+  // Each delta holds all vlans, so 200 of them would be many times the size
+  // of a snapshot. With compaction, the journal is at most a snapshot, deltas
+  // adding up to less than its size, and one more delta.
+  folly::test::TemporaryDirectory snapshotDir;
+  StateJournal snapshot(snapshotDir.path().string(), state);
+  ASSERT_TRUE(snapshot.flush(state));
+  std::string journalContents, snapshotContents;
+  ASSERT_TRUE(folly::readFile(
+      (dir_.path().string() + "/switch_state_journal").c_str(),
+      journalContents));
+  ASSERT_TRUE(folly::readFile(
+      (snapshotDir.path().string() + "/switch_state_journal").c_str(),
+      snapshotContents));
+  EXPECT_LE(journalContents.size(), 3 * snapshotContents.size());
+}
+
+TEST_F(StateJournalTest, tornTail) {
+  StateJournal journal(dir_.path().string(), state_);
+  auto state = addArpEntry(state_, 10);
+  auto journalRef = journal.flush(state);
+  ASSERT_TRUE(journalRef);
+
+  // Garbage after the flushed records is ignored
+  auto path = dir_.path().string() + "/switch_state_journal";
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(path.c_str(), contents));
+  contents.append(64, 'x');
+  ASSERT_TRUE(folly::writeFile(contents, path.c_str()));
+  EXPECT_EQ(
+      StateJournal::replay(dir_.path().string(), *journalRef),
+      state->toFollyDynamic());
+
+  // But a journal that ends before the flushed state is rejected
+  contents.resize(contents.size() / 2);
+  ASSERT_TRUE(folly::writeFile(contents, path.c_str()));
+  EXPECT_THROW(
+      StateJournal::replay(dir_.path().string(), *journalRef), FbossError);
+}
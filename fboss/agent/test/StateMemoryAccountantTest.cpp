@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/StateMemoryAccountant.h"
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+using folly::MacAddress;
+using std::chrono::seconds;
+
+namespace {
+std::shared_ptr<SwitchState> addArpEntry(
+    const std::shared_ptr<SwitchState>& state,
+    int host) {
+  auto newState = state->clone();
+  auto vlan = newState->getVlans()->getVlan(VlanID(1)).get();
+  auto arpTable = vlan->getArpTable()->modify(&vlan, &newState);
+  arpTable->addEntry(
+      IPAddressV4(folly::to<std::string>("10.0.0.", host)),
+      MacAddress::fromHBO(host),
+      PortDescriptor(PortID(1)),
+      InterfaceID(1));
+  newState->publish();
+  return newState;
+}
+
+void noopFibUpdate(
+    RouterID /* vrf */,
+    const rib::IPv4NetworkToRouteMap& /* v4NetworkToRoute */,
+    const rib::IPv6NetworkToRouteMap& /* v6NetworkToRoute */,
+    void* /* cookie */) {}
+} // namespace
+
+class StateMemoryAccountantTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    handle_ = createTestHandle();
+    state_ = testStateA();
+    state_->publish();
+  }
+
+  std::unique_ptr<StateMemoryAccountant> createAccountant() {
+    return std::make_unique<StateMemoryAccountant>(
+        handle_->getSw(), seconds(1));
+  }
+
+  std::unique_ptr<HwTestHandle> handle_;
+  std::shared_ptr<SwitchState> state_;
+};
+
+TEST_F(StateMemoryAccountantTest, sharedWithPreviousState) {
+  auto accountant = createAccountant();
+  accountant->account(state_, nullptr);
+  auto first = accountant->getReport();
+  EXPECT_EQ(first.generation, state_->getGeneration());
+  auto ports = first.usage.at("ports");
+  EXPECT_EQ(ports.nodes, state_->getPorts()->size() + 1);
+  EXPECT_EQ(ports.sharedBytes, 0);
+
+  auto state = addArpEntry(state_, 10);
+  accountant->account(state, nullptr);
+  auto second = accountant->getReport();
+  // Unchanged maps are shared entirely
+  EXPECT_EQ(second.usage.at("ports").bytes, ports.bytes);
+  EXPECT_EQ(second.usage.at("ports").sharedBytes, ports.bytes);
+  // The new entry and the arp table holding it are not
+  auto arpTables = second.usage.at("arp_tables");
+  EXPECT_EQ(arpTables.nodes, first.usage.at("arp_tables").nodes + 1);
+  EXPECT_GT(arpTables.bytes, arpTables.sharedBytes);
+}
+
+TEST_F(StateMemoryAccountantTest, incrementalMatchesFullWalk) {
+  auto incremental = createAccountant();
+  auto state = state_;
+  incremental->account(state, nullptr);
+  for (int host = 10; host < 20; ++host) {
+    state = addArpEntry(state, host);
+    incremental->account(state, nullptr);
+  }
+
+  auto full = createAccountant();
+  full->account(state, nullptr);
+  auto expected = full->getReport().usage;
+  auto actual = incremental->getReport().usage;
+  ASSERT_EQ(actual.size(), expected.size());
+  for (const auto& entry : expected) {
+    EXPECT_EQ(actual.at(entry.first).nodes, entry.second.nodes) << entry.first;
+    EXPECT_EQ(actual.at(entry.first).bytes, entry.second.bytes) << entry.first;
+  }
+}
+
+TEST_F(StateMemoryAccountantTest, retainedGenerations) {
+  auto accountant = createAccountant();
+  auto retained = addArpEntry(state_, 10);
+  accountant->account(retained, nullptr);
+  accountant->account(addArpEntry(retained, 11), nullptr);
+  EXPECT_EQ(accountant->getReport().retainedGenerations, 1);
+
+  retained.reset();
+  accountant->account(addArpEntry(state_, 12), nullptr);
+  EXPECT_EQ(accountant->getReport().retainedGenerations, 0);
+}
+
+TEST_F(StateMemoryAccountantTest, rib) {
+  rib::RoutingInformationBase rib;
+  rib.createVrf(RouterID(0));
+  UnicastRoute route;
+  route.dest.ip = facebook::network::toBinaryAddress(IPAddressV4("10.1.0.0"));
+  route.dest.prefixLength = 16;
+  route.nextHopAddrs.push_back(
+      facebook::network::toBinaryAddress(IPAddressV4("10.0.0.1")));
+  rib.update(
+      RouterID(0),
+      ClientID(1001),
+      AdminDistance::EBGP,
+      {route},
+      {},
+      false,
+      "test",
+      &noopFibUpdate,
+      nullptr);
+
+  auto accountant = createAccountant();
+  accountant->account(state_, &rib);
+  auto report = accountant->getReport();
+  auto ribV4 = report.usage.at("rib_v4");
+  EXPECT_EQ(ribV4.nodes, 1);
+  EXPECT_EQ(ribV4.bytes, sizeof(rib::IPv4NetworkToRouteMap::TreeNode));
+  EXPECT_EQ(ribV4.sharedBytes, 0);
+  EXPECT_EQ(report.usage.at("rib_v6").nodes, 0);
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/StateUpdateRecorder.h"
+
+#include <folly/Conv.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace facebook::fboss;
+using std::chrono::microseconds;
+
+namespace {
+StateUpdateRecorder::BatchTiming batchTiming(int64_t hwUsecs) {
+  StateUpdateRecorder::BatchTiming timing;
+  timing.hwProgramming = microseconds(hwUsecs);
+  timing.observers = microseconds(2 * hwUsecs);
+  timing.deltaSize = hwUsecs;
+  return timing;
+}
+} // namespace
+
+TEST(StateUpdateRecorderTest, recordsNewestFirst) {
+  StateUpdateRecorder recorder(4);
+  auto foo = recorder.getNameId("foo");
+  auto bar = recorder.getNameId("bar");
+  EXPECT_EQ(foo, recorder.getNameId("foo"));
+
+  recorder.record(
+      {{foo, microseconds(1), microseconds(10)},
+       {bar, microseconds(2), microseconds(20)}},
+      batchTiming(100));
+  recorder.record({{foo, microseconds(3), microseconds(30)}}, batchTiming(200));
+
+  auto records = recorder.getRecords(10);
+  ASSERT_EQ(records.size(), 3);
+  EXPECT_EQ(records[0].name, "foo");
+  EXPECT_EQ(records[0].queueWait, microseconds(3));
+  EXPECT_EQ(records[0].apply, microseconds(30));
+  EXPECT_EQ(records[0].hwProgramming, microseconds(200));
+  EXPECT_EQ(records[0].batchSize, 1);
+  EXPECT_EQ(records[1].name, "bar");
+  EXPECT_EQ(records[1].observers, microseconds(200));
+  EXPECT_EQ(records[1].deltaSize, 100);
+  EXPECT_EQ(records[1].batchSize, 2);
+  EXPECT_EQ(records[2].name, "foo");
+
+  EXPECT_EQ(recorder.getRecords(1).size(), 1);
+}
+
+TEST(StateUpdateRecorderTest, keepsLastRecords) {
+  StateUpdateRecorder recorder(4);
+  auto foo = recorder.getNameId("foo");
+  for (int i = 0; i < 10; ++i) {
+    recorder.record({{foo, microseconds(i), microseconds(i)}}, batchTiming(i));
+  }
+  auto records = recorder.getRecords(10);
+  ASSERT_EQ(records.size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(records[i].queueWait, microseconds(9 - i));
+  }
+}
+
+TEST(StateUpdateRecorderTest, tooManyNames) {
+  StateUpdateRecorder recorder(4);
+  StateUpdateRecorder::NameId last = 0;
+  for (size_t i = 0; i <= StateUpdateRecorder::kMaxNames; ++i) {
+    last = recorder.getNameId(folly::to<std::string>("update", i));
+  }
+  recorder.record({{last, microseconds(1), microseconds(1)}}, batchTiming(1));
+  auto records = recorder.getRecords(1);
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].name, StateUpdateRecorder::kOtherName.str());
+}
+
+TEST(StateUpdateRecorderTest, readWhileRecording) {
+  StateUpdateRecorder recorder(8);
+  auto foo = recorder.getNameId("foo");
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    for (int i = 0; i < 10000; ++i) {
+      // Every field of a record holds the same value
+      recorder.record({{foo, microseconds(i), microseconds(i)}}, [i]() {
+        StateUpdateRecorder::BatchTiming timing;
+        timing.hwProgramming = microseconds(i);
+        timing.observers = microseconds(i);
+        timing.deltaSize = i;
+        return timing;
+      }());
+    }
+    done = true;
+  });
+  while (!done) {
+    for (const auto& record : recorder.getRecords(8)) {
+      EXPECT_EQ(record.queueWait, record.apply);
+      EXPECT_EQ(record.queueWait, record.hwProgramming);
+      EXPECT_EQ(record.queueWait, record.observers);
+      EXPECT_EQ(
+          record.queueWait.count(), static_cast<int64_t>(record.deltaSize));
+    }
+  }
+  writer.join();
+}
@@ -11,9 +11,11 @@
 #include <gtest/gtest.h>
 
 #include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/Main.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/PortStats.h"
+#include "fboss/agent/StateObserver.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
@@ -27,8 +29,15 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+DECLARE_bool(state_update_pipeline);
 
 using namespace facebook::fboss;
 using folly::IPAddressV4;
@@ -36,8 +45,68 @@ using folly::IPAddressV6;
 using folly::MacAddress;
 using std::string;
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 
+namespace {
+class OrderedObserver : public AutoRegisterStateObserver {
+ public:
+  OrderedObserver(
+      SwSwitch* sw,
+      const std::string& name,
+      bool concurrent,
+      OrderedObserver* dependency,
+      std::atomic<int>* sequence,
+      bool blocking = false)
+      : AutoRegisterStateObserver(sw, name),
+        concurrent_(concurrent),
+        dependency_(dependency),
+        dependencyName_(dependency ? dependency->name_ : ""),
+        name_(name),
+        sequence_(sequence),
+        blocking_(blocking) {}
+
+  void stateUpdated(const StateDelta& /*delta*/) override {
+    notifiedThread = std::this_thread::get_id();
+    entered.post();
+    if (blocking_) {
+      // Hold the delta until the test releases us
+      release.wait();
+    }
+    if (dependency_) {
+      // The dependency must be done with the delta before we see it
+      dependencyDone = dependency_->done.ready();
+    }
+    notifiedAt = (*sequence_)++;
+    done.post();
+  }
+  bool canRunConcurrently() const override {
+    return concurrent_;
+  }
+  std::vector<std::string> getStateObserverDependencies() const override {
+    if (!dependency_) {
+      return {};
+    }
+    return {dependencyName_};
+  }
+
+  folly::Baton<> entered;
+  folly::Baton<> release;
+  folly::Baton<> done;
+  std::atomic<bool> dependencyDone{false};
+  std::atomic<int> notifiedAt{-1};
+  std::thread::id notifiedThread;
+
+ private:
+  const bool concurrent_;
+  const OrderedObserver* dependency_;
+  const std::string dependencyName_;
+  const std::string name_;
+  std::atomic<int>* sequence_;
+  const bool blocking_;
+};
+} // namespace
+
 class SwSwitchTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -185,3 +254,225 @@ TEST_F(SwSwitchTest, TestStateNonCoalescing) {
   // 0 neighbor entries expected, i.e. entries must be purged
   verifyReachableCnt(0);
 }
+
+namespace {
+// How often each of the coalesced updates was applied, and whether any of
+// them was handed an unpublished state
+struct CoalescedArpUpdates {
+  std::array<int, 3> applied{};
+  bool sawUnpublished{false};
+};
+
+/*
+ * Add 10.0.0.10, 10.0.0.11 and 10.0.0.12 in one batch, with the update
+ * adding 10.0.0.11 failing after it modified the state it was given.
+ */
+CoalescedArpUpdates applyCoalescedArpUpdates(SwSwitch* sw) {
+  CoalescedArpUpdates result;
+  // Hold the update thread so the following updates get coalesced
+  folly::Baton<> queued;
+  sw->updateStateNoCoalescing(
+      "Wait for queued updates",
+      [&](const std::shared_ptr<SwitchState>& /*state*/)
+          -> std::shared_ptr<SwitchState> {
+        queued.wait();
+        return nullptr;
+      });
+  auto addArpEntry = [&result](int host, bool fail) {
+    return [&result, host, fail](const std::shared_ptr<SwitchState>& state) {
+      ++result.applied[host - 10];
+      result.sawUnpublished |= !state->isPublished();
+      auto newState = state->clone();
+      auto vlan = newState->getVlans()->getVlan(VlanID(1)).get();
+      auto arpTable = vlan->getArpTable()->modify(&vlan, &newState);
+      arpTable->addEntry(
+          IPAddressV4(folly::to<std::string>("10.0.0.", host)),
+          MacAddress("02:00:00:00:00:01"),
+          PortDescriptor(PortID(1)),
+          InterfaceID(1));
+      if (fail) {
+        throw FbossError("failed after adding 10.0.0.", host);
+      }
+      return newState;
+    };
+  };
+  sw->updateState("Add 10.0.0.10", addArpEntry(10, false));
+  sw->updateState("Add 10.0.0.11 and fail", addArpEntry(11, true));
+  sw->updateState("Add 10.0.0.12", addArpEntry(12, false));
+  queued.post();
+  waitForStateUpdates(sw);
+
+  // The partial change from the failed update was dropped, while the
+  // updates around it in the batch were kept
+  auto arpTable =
+      sw->getAppliedState()->getVlans()->getVlan(VlanID(1))->getArpTable();
+  EXPECT_NE(nullptr, arpTable->getEntryIf(IPAddressV4("10.0.0.10")));
+  EXPECT_EQ(nullptr, arpTable->getEntryIf(IPAddressV4("10.0.0.11")));
+  EXPECT_NE(nullptr, arpTable->getEntryIf(IPAddressV4("10.0.0.12")));
+  EXPECT_TRUE(sw->getAppliedState()->isPublished());
+  return result;
+}
+} // namespace
+
+TEST_F(SwSwitchTest, CoalescedUpdateFailure) {
+  // Every update is handed a published state, so a failure needs no
+  // rollback and no update is applied twice
+  auto result = applyCoalescedArpUpdates(sw);
+  EXPECT_EQ(result.applied, (std::array<int, 3>{1, 1, 1}));
+  EXPECT_FALSE(result.sawUnpublished);
+}
+
+TEST_F(SwSwitchTest, HigherPriorityUpdatesRunFirst) {
+  // Hold the update thread so the following updates queue up
+  folly::Baton<> queued;
+  sw->updateStateNoCoalescing(
+      "Wait for queued updates",
+      [&](const std::shared_ptr<SwitchState>& /*state*/)
+          -> std::shared_ptr<SwitchState> {
+        queued.wait();
+        return nullptr;
+      });
+  std::vector<std::string> applied;
+  auto recordUpdate = [&applied](const std::string& name) {
+    return [&applied, name](const std::shared_ptr<SwitchState>& /*state*/)
+               -> std::shared_ptr<SwitchState> {
+      applied.push_back(name);
+      return nullptr;
+    };
+  };
+  sw->updateState("low", recordUpdate("low"), StateUpdate::Priority::LOW);
+  sw->updateState("normal", recordUpdate("normal"));
+  sw->updateState("high", recordUpdate("high"), StateUpdate::Priority::HIGH);
+  queued.post();
+  waitForStateUpdates(sw);
+  EXPECT_EQ(applied, (std::vector<std::string>{"high", "normal", "low"}));
+}
+
+TEST_F(SwSwitchTest, NeighborHitsFromOneScan) {
+  const IPAddressV4 kHitIp("10.0.0.2");
+  const IPAddressV4 kIdleIp("10.0.0.3");
+  EXPECT_HW_CALL(sw, getAndClearNeighborHits(RouterID(0)))
+      .WillOnce(Return(std::vector<folly::IPAddress>{kHitIp}));
+  EXPECT_HW_CALL(sw, getAndClearNeighborHit(_, _)).Times(0);
+
+  auto interval = std::chrono::hours(1);
+  EXPECT_TRUE(
+      sw->getAndClearNeighborHitFromScan(RouterID(0), kHitIp, interval));
+  EXPECT_FALSE(
+      sw->getAndClearNeighborHitFromScan(RouterID(0), kIdleIp, interval));
+  // The hit was consumed
+  EXPECT_FALSE(
+      sw->getAndClearNeighborHitFromScan(RouterID(0), kHitIp, interval));
+}
+
+TEST_F(SwSwitchTest, StateObserverDependencies) {
+  std::atomic<int> sequence{0};
+  OrderedObserver first(sw, "first", true, nullptr, &sequence, true);
+  OrderedObserver second(sw, "second", false, &first, &sequence);
+  OrderedObserver third(sw, "third", true, &second, &sequence);
+
+  sw->updateState(
+      "Bring Ports Up", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+
+  // Nothing that depends on first may see the delta while first holds it
+  first.entered.wait();
+  EXPECT_FALSE(second.entered.ready());
+  EXPECT_FALSE(third.entered.ready());
+  first.release.post();
+  waitForStateUpdates(sw);
+
+  EXPECT_TRUE(second.dependencyDone);
+  EXPECT_TRUE(third.dependencyDone);
+  EXPECT_EQ(first.notifiedAt, 0);
+  EXPECT_EQ(second.notifiedAt, 1);
+  EXPECT_EQ(third.notifiedAt, 2);
+
+  // Only observers that can run concurrently leave the update thread
+  std::thread::id updateThread;
+  sw->getUpdateEvb()->runInEventBaseThreadAndWait(
+      [&updateThread]() { updateThread = std::this_thread::get_id(); });
+  EXPECT_EQ(second.notifiedThread, updateThread);
+  EXPECT_NE(first.notifiedThread, updateThread);
+  EXPECT_NE(third.notifiedThread, updateThread);
+}
+
+class SwSwitchPipelineTest : public SwSwitchTest {
+ public:
+  void SetUp() override {
+    FLAGS_state_update_pipeline = true;
+    SwSwitchTest::SetUp();
+  }
+
+ private:
+  gflags::FlagSaver flagSaver_;
+};
+
+TEST_F(SwSwitchPipelineTest, NextBatchComputedWhileHwProgramming) {
+  folly::Baton<> programming;
+  folly::Baton<> programmed;
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillOnce(Invoke([&](const StateDelta& delta) {
+        programming.post();
+        programmed.wait();
+        return delta.newState();
+      }))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+
+  sw->updateState(
+      "Bring Ports Up", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+  programming.wait();
+
+  // While hw is programming the first delta, the next batch is computed on
+  // top of it
+  folly::Baton<> computed;
+  std::shared_ptr<SwitchState> computedFrom;
+  sw->updateState(
+      "Next batch",
+      [&](const std::shared_ptr<SwitchState>& state)
+          -> std::shared_ptr<SwitchState> {
+        computedFrom = state;
+        computed.post();
+        return nullptr;
+      });
+  computed.wait();
+  EXPECT_EQ(computedFrom, sw->getDesiredState());
+  EXPECT_NE(sw->getAppliedState(), sw->getDesiredState());
+  EXPECT_TRUE(computedFrom->getPort(PortID(1))->isUp());
+
+  programmed.post();
+  waitForStateUpdates(sw);
+  EXPECT_EQ(sw->getAppliedState(), computedFrom);
+  EXPECT_EQ(sw->getAppliedState(), sw->getDesiredState());
+}
+
+TEST_F(SwSwitchPipelineTest, HwRejectsUpdateThenAccepts) {
+  auto origState = sw->getAppliedState();
+  EXPECT_HW_CALL(sw, stateChanged(_)).WillRepeatedly(Return(origState));
+  sw->updateState(
+      "Reject update", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+  waitForStateUpdates(sw);
+  EXPECT_EQ(sw->getAppliedState(), origState);
+  EXPECT_NE(sw->getAppliedState(), sw->getDesiredState());
+
+  // The next update programs what was rejected along with its own change
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+  sw->updateState(
+      "Accept update", [](const std::shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        newState->setArpTimeout(std::chrono::seconds(42));
+        return newState;
+      });
+  waitForStateUpdates(sw);
+  EXPECT_EQ(sw->getAppliedState(), sw->getDesiredState());
+  EXPECT_TRUE(sw->getAppliedState()->getPort(PortID(1))->isUp());
+  EXPECT_EQ(sw->getAppliedState()->getArpTimeout(), std::chrono::seconds(42));
+}
@@ -203,10 +203,10 @@ MockPlatform* getMockPlatform(std::unique_ptr<SwSwitch>& sw) {
 }
 
 std::shared_ptr<SwitchState> waitForStateUpdates(SwSwitch* sw) {
-  // All StateUpdates scheduled from this thread will be applied in order,
-  // so we can simply perform a blocking no-op update.  When it is done
-  // we can be sure that all previously scheduled updates have also been
-  // applied.
+  // All StateUpdates of the same priority scheduled from this thread will be
+  // applied in order, so we can simply perform a blocking no-op update in
+  // each priority lane.  When they are done we can be sure that all
+  // previously scheduled updates have also been applied.
   std::shared_ptr<SwitchState> snapshot{nullptr};
   auto snapshotUpdate = [&snapshot](const shared_ptr<SwitchState>& state)
       -> std::shared_ptr<SwitchState> {
@@ -214,7 +214,12 @@ std::shared_ptr<SwitchState> waitForStateUpdates(SwSwitch* sw) {
     snapshot = state;
     return nullptr;
   };
-  sw->updateStateBlocking("waitForStateUpdates", snapshotUpdate);
+  for (auto priority :
+       {StateUpdate::Priority::HIGH,
+        StateUpdate::Priority::NORMAL,
+        StateUpdate::Priority::LOW}) {
+    sw->updateStateBlocking("waitForStateUpdates", snapshotUpdate, priority);
+  }
   return snapshot;
 }
 
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "fboss/agent/TxPacketBufferPool.h"
+#include "fboss/agent/hw/mock/MockTxPacket.h"
+
+#include <gflags/gflags.h>
+
+#include <thread>
+#include <vector>
+
+DECLARE_int32(tx_packet_pool_size);
+
+using namespace facebook::fboss;
+
+namespace {
+// Empty this thread's free lists so tests start out cold
+void drainPool() {
+  auto& pool = TxPacketBufferPool::get();
+  std::vector<std::unique_ptr<folly::IOBuf>> bufs;
+  for (auto size : TxPacketBufferPool::kSizeClasses) {
+    uint64_t misses;
+    do {
+      misses = pool.getMisses();
+      bufs.push_back(pool.allocate(size));
+    } while (pool.getMisses() == misses);
+  }
+  gflags::FlagSaver flagSaver;
+  FLAGS_tx_packet_pool_size = 0;
+  bufs.clear();
+}
+} // namespace
+
+TEST(TxPacketBufferPool, ReuseFreedBuffer) {
+  drainPool();
+  auto& pool = TxPacketBufferPool::get();
+  auto hits = pool.getHits();
+  auto misses = pool.getMisses();
+
+  auto buf = pool.allocate(100);
+  EXPECT_EQ(buf->capacity(), 128);
+  EXPECT_EQ(buf->length(), 0);
+  EXPECT_EQ(pool.getMisses(), misses + 1);
+  auto data = buf->data();
+
+  // Buffers only return to the pool once every IOBuf sharing them is gone
+  auto clone = buf->clone();
+  buf.reset();
+  auto otherBuf = pool.allocate(100);
+  EXPECT_NE(otherBuf->data(), data);
+  EXPECT_EQ(pool.getMisses(), misses + 2);
+
+  // Same size class, served from the free list
+  clone.reset();
+  buf = pool.allocate(120);
+  EXPECT_EQ(buf->data(), data);
+  EXPECT_EQ(pool.getHits(), hits + 1);
+
+  // Different size class
+  auto bigBuf = pool.allocate(1500);
+  EXPECT_EQ(bigBuf->capacity(), 2048);
+  EXPECT_EQ(pool.getMisses(), misses + 3);
+}
+
+TEST(TxPacketBufferPool, NotPooled) {
+  auto& pool = TxPacketBufferPool::get();
+  auto misses = pool.getMisses();
+  auto buf = pool.allocate(TxPacketBufferPool::kSizeClasses.back() + 1);
+  EXPECT_GE(buf->capacity(), TxPacketBufferPool::kSizeClasses.back() + 1);
+  EXPECT_EQ(pool.getMisses(), misses + 1);
+}
+
+TEST(TxPacketBufferPool, MockTxPacket) {
+  drainPool();
+  auto& pool = TxPacketBufferPool::get();
+  auto hits = pool.getHits();
+  { MockTxPacket pkt(64); }
+  MockTxPacket pkt(64);
+  EXPECT_EQ(pkt.buf()->length(), 64);
+  EXPECT_EQ(pool.getHits(), hits + 1);
+}
+
+TEST(TxPacketBufferPool, FreeOnOtherThread) {
+  drainPool();
+  auto& pool = TxPacketBufferPool::get();
+  auto buf = pool.allocate(500);
+  std::thread([buf = std::move(buf)]() mutable { buf.reset(); }).join();
+
+  // The buffer went to the other thread's free list
+  auto misses = pool.getMisses();
+  pool.allocate(500);
+  EXPECT_EQ(pool.getMisses(), misses + 1);
+}
@@ -2,241 +2,274 @@
 #include "TimeSeriesWithMinMax.h"
 
 #include <algorithm>
+#include <cassert>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace facebook::fboss {
+
+template <class ValueType>
+TimeSeriesWithMinMax<ValueType>::TimeSeriesWithMinMax(
+    Duration interval,
+    Duration bucketInterval,
+    size_t numShards)
+    : interval_(interval),
+      bucketInterval_(bucketInterval),
+      numBuckets_(interval.count() / bucketInterval.count()),
+      numShards_(numShards),
+      shards_(std::make_unique<Shard[]>(numShards)) {
+  assert(interval.count() >= bucketInterval.count());
+  assert(bucketInterval.count() > 0);
+  assert(interval.count() > 0);
+  assert(numShards > 0);
+  for (size_t i = 0; i < numShards_; ++i) {
+    shards_[i].tree.resize(2 * numBuckets_);
+  }
+}
+
 /*
- * Add value into bucket. This will place the value in the most
- * recent bucket if it is within the bucket's time frame, else
- * it will create a new bucket at the end of the vector, and place
- * the value inside it.
+ * Add value into the bucket for the current time. This will
+ * advance the writer's ring if the current time is past its
+ * most recent bucket, clearing the buckets that fall out of
+ * the time window.
  */
 template <class ValueType>
 void TimeSeriesWithMinMax<ValueType>::addValue(const ValueType& value) {
-  auto t = std::chrono::system_clock::now();
-  auto locked_buf = buf_.wlock();
-  auto last_bucket = locked_buf->size() == 0
-      ? nullptr
-      : &locked_buf->at(locked_buf->size() - 1);
-  if (last_bucket != nullptr && last_bucket->isTimeInBucket(t)) {
-    last_bucket->addValue(value);
-  } else {
-    Bucket b(t, bucketInterval_);
-    b.addValue(value);
-    locked_buf->push_back(std::move(b));
-  }
+  addValueToShard(writerShard(), value, bucketOf(Clock::now()));
 }
 
 /*
- * If the time is specified for the addition, then more
- * caution is required to maintain the integrity of the
- * structure.
+ * Values may be added at any time within the time window, a
+ * value older than that is dropped.
  */
 template <class ValueType>
 void TimeSeriesWithMinMax<ValueType>::addValue(
     const ValueType& value,
     typename TimeSeriesWithMinMax<ValueType>::Time t) {
-  auto locked_buf = buf_.wlock();
-
   /*
    * If the time is out of the buffer, return.
    */
-  if (t < std::chrono::system_clock::now() - interval_) {
+  if (t < Clock::now() - interval_) {
     return;
   }
+  addValueToShard(writerShard(), value, bucketOf(t));
+}
 
-  /*
-   * If the buffer is empty, add the first bucket to the
-   * end of the buffer.
-   */
-  if (locked_buf->size() == 0) {
-    Bucket b(t, bucketInterval_);
-    b.addValue(value);
-    locked_buf->push_back(std::move(b));
+template <class ValueType>
+void TimeSeriesWithMinMax<ValueType>::addValueToShard(
+    Shard& shard,
+    const ValueType& value,
+    int64_t bucket) {
+  const int64_t numBuckets = numBuckets_;
+  std::lock_guard<folly::SpinLock> g(shard.lock);
+  if (!shard.lastBucket || bucket > *shard.lastBucket) {
+    if (!shard.lastBucket || bucket - *shard.lastBucket >= numBuckets) {
+      clearShard(shard);
+    } else {
+      for (auto b = *shard.lastBucket + 1; b <= bucket; ++b) {
+        updateSlot(shard, b % numBuckets, MinMax());
+      }
+    }
+    shard.lastBucket = bucket;
+  } else if (bucket <= *shard.lastBucket - numBuckets) {
+    // Already dropped out of this ring
     return;
   }
+  auto slot = bucket % numBuckets;
+  auto minMax = shard.tree[numBuckets_ + slot];
+  minMax.merge(MinMax{value, value, true});
+  updateSlot(shard, slot, minMax);
+}
 
-  /*
-   * Handle the case of the time being less than the earliest
-   * time in the buffer.
-   */
-  if (t < locked_buf->at(0).getInstantiatedTime()) {
-    Bucket b(t, bucketInterval_);
-    b.addValue(value);
-    locked_buf->insert(locked_buf->begin(), std::move(b));
-    return;
+template <class ValueType>
+void TimeSeriesWithMinMax<ValueType>::updateSlot(
+    Shard& shard,
+    size_t slot,
+    const MinMax& minMax) {
+  auto i = numBuckets_ + slot;
+  shard.tree[i] = minMax;
+  for (i /= 2; i > 0; i /= 2) {
+    shard.tree[i] = shard.tree[2 * i];
+    shard.tree[i].merge(shard.tree[2 * i + 1]);
   }
+}
 
-  /*
-   * Handle the case of the time being greater than the newest
-   * time in the buffer.
-   */
-  if (t > locked_buf->at(locked_buf->size() - 1).getInstantiatedTime() +
-          bucketInterval_) {
-    Bucket b(t, bucketInterval_);
-    b.addValue(value);
-    locked_buf->push_back(std::move(b));
-    return;
+template <class ValueType>
+void TimeSeriesWithMinMax<ValueType>::clearShard(Shard& shard) {
+  std::fill(shard.tree.begin(), shard.tree.end(), MinMax());
+  shard.lastBucket.reset();
+}
+
+template <class ValueType>
+typename TimeSeriesWithMinMax<ValueType>::MinMax
+TimeSeriesWithMinMax<ValueType>::query(int64_t firstBucket, int64_t lastBucket)
+    const {
+  MinMax result;
+  for (size_t i = 0; i < numShards_; ++i) {
+    result.merge(queryShard(shards_[i], firstBucket, lastBucket));
+  }
+  return result;
+}
+
+template <class ValueType>
+typename TimeSeriesWithMinMax<ValueType>::MinMax
+TimeSeriesWithMinMax<ValueType>::queryShard(
+    const Shard& shard,
+    int64_t firstBucket,
+    int64_t lastBucket) const {
+  const int64_t numBuckets = numBuckets_;
+  std::lock_guard<folly::SpinLock> g(shard.lock);
+  if (!shard.lastBucket) {
+    return MinMax();
+  }
+  firstBucket = std::max(firstBucket, *shard.lastBucket - numBuckets + 1);
+  lastBucket = std::min(lastBucket, *shard.lastBucket);
+  if (firstBucket > lastBucket) {
+    return MinMax();
+  }
+  size_t firstSlot = firstBucket % numBuckets;
+  size_t lastSlot = lastBucket % numBuckets;
+  if (firstSlot <= lastSlot) {
+    return querySlots(shard, firstSlot, lastSlot + 1);
   }
+  // Range wraps around the end of the ring
+  auto result = querySlots(shard, firstSlot, numBuckets_);
+  result.merge(querySlots(shard, 0, lastSlot + 1));
+  return result;
+}
 
-  /*
-   * Handle the case when we have to add a bucket in the middle
-   * of the buffer.
-   */
-  for (int i = 0; i < locked_buf->size(); i++) {
-    auto b = &locked_buf->at(i);
-    if (b->isTimeInBucket(t)) {
-      b->addValue(value);
-      return;
-    } else if (i + 1 < locked_buf->size()) {
-      if (t < locked_buf->at(i + 1).getInstantiatedTime() &&
-          t > b->getInstantiatedTime()) {
-        Bucket b(t, bucketInterval_);
-        b.addValue(value);
-        locked_buf->insert(locked_buf->begin() + i, std::move(b));
-        return;
-      }
+template <class ValueType>
+typename TimeSeriesWithMinMax<ValueType>::MinMax
+TimeSeriesWithMinMax<ValueType>::querySlots(
+    const Shard& shard,
+    size_t begin,
+    size_t end) const {
+  MinMax result;
+  for (auto l = begin + numBuckets_, r = end + numBuckets_; l < r;
+       l /= 2, r /= 2) {
+    if (l & 1) {
+      result.merge(shard.tree[l++]);
+    }
+    if (r & 1) {
+      result.merge(shard.tree[--r]);
     }
   }
+  return result;
 }
 
 /*
- * Maintains the buffer. Enforces that all buckets within the
- * buffer are within the appropriate time frame, and that the
- * size of the buffer is not longer than expected.
+ * Merge the buckets which started within [start, end), and are
+ * still within the time window.
  */
-template <class T>
-void TimeSeriesWithMinMax<T>::maintainBuffer(Time /*now*/) {
-  auto locked_buf = buf_.wlock();
-  // remove buckets that are out of date
-  locked_buf->erase(
-      std::remove_if(
-          locked_buf->begin(),
-          locked_buf->end(),
-          [&](Bucket b) {
-            return std::chrono::system_clock::now() - interval_ >=
-                b.getInstantiatedTime();
-          }),
-      locked_buf->end());
+template <class ValueType>
+typename TimeSeriesWithMinMax<ValueType>::MinMax
+TimeSeriesWithMinMax<ValueType>::queryRange(Time start, Time end) const {
+  auto width =
+      std::chrono::duration_cast<Clock::duration>(bucketInterval_).count();
+  auto ceilDiv = [width](int64_t ticks) {
+    return ticks / width + (ticks % width > 0 ? 1 : 0);
+  };
+  int64_t now = bucketOf(Clock::now());
+  auto firstBucket = std::max(
+      ceilDiv(start.time_since_epoch().count()),
+      now - static_cast<int64_t>(numBuckets_) + 1);
+  auto lastBucket = ceilDiv(end.time_since_epoch().count()) - 1;
+  return query(firstBucket, lastBucket);
+}
+
+template <class ValueType>
+int64_t TimeSeriesWithMinMax<ValueType>::bucketOf(Time t) const {
+  return t.time_since_epoch().count() /
+      std::chrono::duration_cast<Clock::duration>(bucketInterval_).count();
+}
+
+/*
+ * Writers stick to the shard picked by their thread id.
+ */
+template <class ValueType>
+typename TimeSeriesWithMinMax<ValueType>::Shard&
+TimeSeriesWithMinMax<ValueType>::writerShard() {
+  if (numShards_ == 1) {
+    return shards_[0];
+  }
+  static thread_local size_t threadHash =
+      std::hash<std::thread::id>()(std::this_thread::get_id());
+  return shards_[threadHash % numShards_];
 }
 
 /*
  * Return the maximum value in the buffer.
  */
 template <class ValueType>
-ValueType TimeSeriesWithMinMax<ValueType>::getMax() {
-  maintainBuffer(std::chrono::system_clock::now());
-  auto locked_buf = buf_.rlock();
-  if (locked_buf->size() == 0) {
+ValueType TimeSeriesWithMinMax<ValueType>::getMax() const {
+  auto minMax = getMinMax();
+  if (!minMax) {
     throw std::runtime_error("Empty Buffer!");
   }
-  ValueType max = std::numeric_limits<ValueType>::lowest();
-  for (auto b : *locked_buf) {
-    max = std::max(max, b.getMax());
-  }
-  return max;
+  return minMax->second;
 }
 
 template <class ValueType>
 ValueType TimeSeriesWithMinMax<ValueType>::getMax(
     typename TimeSeriesWithMinMax<ValueType>::Time start,
-    typename TimeSeriesWithMinMax<ValueType>::Time end) {
-  maintainBuffer(std::chrono::system_clock::now());
-  auto locked_buf = buf_.rlock();
-
-  if (locked_buf->size() == 0) {
-    throw std::runtime_error("Empty Buffer!");
-  }
-
-  ValueType max = std::numeric_limits<ValueType>::lowest();
-  bool isValid = false;
-  for (auto b : *locked_buf) {
-    auto t = b.getInstantiatedTime();
-    if (t >= start && t < end) {
-      isValid = true;
-      max = std::max(b.getMax(), max);
+    typename TimeSeriesWithMinMax<ValueType>::Time end) const {
+  auto minMax = queryRange(start, end);
+  if (!minMax.valid) {
+    if (!getMinMax()) {
+      throw std::runtime_error("Empty Buffer!");
     }
-  }
-  if (!isValid) {
     throw std::runtime_error("Bad range specified");
   }
-  return max;
+  return minMax.max;
 }
 
 /*
  * Return the minimum value in the buffer.
  */
 template <class ValueType>
-ValueType TimeSeriesWithMinMax<ValueType>::getMin() {
-  maintainBuffer(std::chrono::system_clock::now());
-  auto locked_buf = buf_.rlock();
-  if (locked_buf->size() == 0) {
+ValueType TimeSeriesWithMinMax<ValueType>::getMin() const {
+  auto minMax = getMinMax();
+  if (!minMax) {
     throw std::runtime_error("Empty Buffer!");
   }
-  ValueType min = std::numeric_limits<ValueType>::max();
-  for (auto b : *locked_buf) {
-    min = std::min(min, b.getMin());
-  }
-  return min;
+  return minMax->first;
 }
 
 template <class ValueType>
 ValueType TimeSeriesWithMinMax<ValueType>::getMin(
     typename TimeSeriesWithMinMax<ValueType>::Time start,
-    typename TimeSeriesWithMinMax<ValueType>::Time end) {
-  maintainBuffer(std::chrono::system_clock::now());
-  auto locked_buf = buf_.rlock();
-
-  if (locked_buf->size() == 0) {
-    throw std::runtime_error("Empty Buffer!");
-  }
-
-  ValueType min = std::numeric_limits<ValueType>::max();
-  bool isValid = false;
-  for (auto b : *locked_buf) {
-    auto t = b.getInstantiatedTime();
-    if (t >= start && t < end) {
-      isValid = true;
-      min = std::min(b.getMin(), min);
+    typename TimeSeriesWithMinMax<ValueType>::Time end) const {
+  auto minMax = queryRange(start, end);
+  if (!minMax.valid) {
+    if (!getMinMax()) {
+      throw std::runtime_error("Empty Buffer!");
     }
-  }
-  if (!isValid) {
     throw std::runtime_error("Bad range specified");
   }
-  return min;
-}
-
-/*
- * Create a Bucket object. This will create a bucket granular
- * to the bucket interval.
- */
-template <class ValueType>
-TimeSeriesWithMinMax<ValueType>::Bucket::Bucket(Time now, Duration width)
-    : width_(width) {
-  auto epoch = std::chrono::duration_cast<Duration>(now.time_since_epoch());
-  auto leftover = epoch % width;
-  startTime_ = now - leftover;
+  return minMax.min;
 }
 
-/*
- * This function does not check that the value is
- * within the time expected for the buffer. For correct
- * usage, the user must check this for themselves.
- */
 template <class ValueType>
-void TimeSeriesWithMinMax<ValueType>::Bucket::addValue(const ValueType& value) {
-  max_ = std::max(value, max_);
-  min_ = std::min(value, min_);
-}
-
-template <class ValueType>
-bool TimeSeriesWithMinMax<ValueType>::Bucket::isTimeInBucket(Time time) {
-  return time >= startTime_ && time <= startTime_ + width_;
+std::optional<std::pair<ValueType, ValueType>>
+TimeSeriesWithMinMax<ValueType>::getMinMax() const {
+  int64_t now = bucketOf(Clock::now());
+  auto minMax = query(now - static_cast<int64_t>(numBuckets_) + 1, now);
+  if (!minMax.valid) {
+    return std::nullopt;
+  }
+  return std::make_pair(minMax.min, minMax.max);
 }
 
 template <class ValueType>
-typename TimeSeriesWithMinMax<ValueType>::Time
-TimeSeriesWithMinMax<ValueType>::Bucket::getInstantiatedTime() const {
-  return startTime_;
+void TimeSeriesWithMinMax<ValueType>::MinMax::merge(const MinMax& other) {
+  if (!other.valid) {
+    return;
+  }
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+  valid = true;
 }
 
 } // namespace facebook::fboss
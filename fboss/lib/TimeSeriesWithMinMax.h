@@ -2,22 +2,31 @@
 
 #pragma once
 
-#include <boost/circular_buffer.hpp>
-#include <folly/Synchronized.h>
+#include <folly/SpinLock.h>
+#include <folly/lang/Align.h>
 #include <chrono>
 #include <limits>
-#include <numeric>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 /*
  * The purpose of this class is to provide a small footprint
  * structure that can record the max and min values over a
  * timed interval. This class uses a bucketing method, where
- * the structure is a buffer of buckets, where each bucket holds
- * the max and min values for an interval in the bucket. The structure
- * allows for configuration of the length of time to record over,
- * and the granularity of the data recorded. This structure's functions
- * are all thread safe, and are intended to be used for data logging.
+ * the structure is a fixed size ring of buckets, where each bucket
+ * holds the max and min values for an interval in the bucket. The
+ * structure allows for configuration of the length of time to record
+ * over, and the granularity of the data recorded. This structure's
+ * functions are all thread safe, and are intended to be used for data
+ * logging.
+ *
+ * Writers are spread over a configurable number of shards, each with its
+ * own lock and ring, so that concurrent writers do not contend with each
+ * other. Each ring keeps a segment tree over its buckets, making min/max
+ * queries over any time range O(shards * log(buckets)).
  */
 template <class ValueType>
 class TimeSeriesWithMinMax {
@@ -25,26 +34,21 @@ class TimeSeriesWithMinMax {
   /*
    * Unit definitions for readable interface.
    */
-  using Time = std::chrono::time_point<std::chrono::system_clock>;
+  using Clock = std::chrono::steady_clock;
+  using Time = std::chrono::time_point<Clock>;
   using Duration = std::chrono::seconds;
 
   /*
    * Instantiate a time series.
    * interval : Length of time to record max over.
    * bucketInterval : The granularity of the data.
-   * The class relies on the buffer's buckets being sorted
-   * by time covered.
+   * numShards : Number of independently locked writer shards. Only worth
+   *   raising above 1 if values are added from several threads at once.
    */
   explicit TimeSeriesWithMinMax(
       Duration interval = Duration(60),
-      Duration bucketInterval = Duration(1))
-      : interval_(interval), bucketInterval_(bucketInterval) {
-    assert(interval.count() >= bucketInterval.count());
-    assert(bucketInterval.count() > 0);
-    assert(interval.count() > 0);
-    buf_ = boost::circular_buffer<Bucket>(
-        interval.count() / bucketInterval_.count());
-  }
+      Duration bucketInterval = Duration(1),
+      size_t numShards = 1);
 
   /*
    * Add a value into the buffer, at the current time.
@@ -59,78 +63,82 @@ class TimeSeriesWithMinMax {
   /*
    * Get the current maximum value of the buffer.
    */
-  ValueType getMax();
+  ValueType getMax() const;
 
   /*
    * Get the maximum value over an interval
    */
-  ValueType getMax(Time start, Time end);
+  ValueType getMax(Time start, Time end) const;
 
   /*
    * Get the current minimum value of the buffer.
    */
-  ValueType getMin();
+  ValueType getMin() const;
 
   /*
    * Get the minimum value over an interval
    */
-  ValueType getMin(Time start, Time end);
+  ValueType getMin(Time start, Time end) const;
+
+  /*
+   * Get the current minimum and maximum values of the buffer, or
+   * std::nullopt if the buffer is empty.
+   */
+  std::optional<std::pair<ValueType, ValueType>> getMinMax() const;
 
  private:
   /*
-   * Internal bucket class to keep granularity of data.
+   * Min and max of a bucket, or of a range of buckets.
+   */
+  struct MinMax {
+    ValueType min = std::numeric_limits<ValueType>::max();
+    ValueType max = std::numeric_limits<ValueType>::lowest();
+    bool valid = false;
+
+    void merge(const MinMax& other);
+  };
+
+  /*
+   * Ring of buckets written by a subset of the writers. Bucket b, counted
+   * from the clock's epoch, lives in slot b % numBuckets. Only buckets in
+   * (lastBucket - numBuckets, lastBucket] are held, older slots are
+   * cleared as lastBucket advances.
+   *
+   * tree[numBuckets + slot] is the bucket in that slot, and tree[i] for
+   * i < numBuckets merges tree[2i] and tree[2i + 1].
    */
-  class Bucket {
-   public:
-    /*
-     * Construct a Bucket object.
-     */
-    Bucket(Time now, Duration width);
-
-    /*
-     * Add a value into a bucket.
-     */
-    void addValue(const ValueType& value);
-
-    /*
-     * Field querying methods.
-     */
-    bool isTimeInBucket(Time time);
-
-    Time getInstantiatedTime() const;
-
-    ValueType getMax() const {
-      return max_;
-    }
-
-    ValueType getMin() const {
-      return min_;
-    }
-
-   private:
-    ValueType max_ = std::numeric_limits<ValueType>::lowest();
-    ValueType min_ = std::numeric_limits<ValueType>::max();
-    Time startTime_;
-    Duration width_;
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    mutable folly::SpinLock lock;
+    std::vector<MinMax> tree;
+    std::optional<int64_t> lastBucket;
   };
 
+  int64_t bucketOf(Time t) const;
+  void addValueToShard(Shard& shard, const ValueType& value, int64_t bucket);
+  void updateSlot(Shard& shard, size_t slot, const MinMax& minMax);
+  void clearShard(Shard& shard);
+  /*
+   * Merge the buckets in [firstBucket, lastBucket] of all shards.
+   */
+  MinMax query(int64_t firstBucket, int64_t lastBucket) const;
+  MinMax queryShard(const Shard& shard, int64_t firstBucket, int64_t lastBucket)
+      const;
   /*
-   * Internal method to restrict buffer length, and remove buckets
-   * from outside of the time window.
+   * Merge ring slots [begin, end) of a shard.
    */
-  void maintainBuffer(Time now);
+  MinMax querySlots(const Shard& shard, size_t begin, size_t end) const;
+  MinMax queryRange(Time start, Time end) const;
+  Shard& writerShard();
 
   /*
    * Local copies of constructor arguments.
    */
   Duration interval_;
   Duration bucketInterval_;
+  size_t numBuckets_;
+  size_t numShards_;
 
-  /*
-   * Vector structure to hold buckets of data. Using folly
-   * Synchronized provides the thread-safety needed.
-   */
-  folly::Synchronized<boost::circular_buffer<Bucket>> buf_;
+  std::unique_ptr<Shard[]> shards_;
 };
 
 } // namespace facebook::fboss
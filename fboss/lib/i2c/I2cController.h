@@ -31,6 +31,9 @@ class I2cController {
     i2cControllerPlatformStats_.writeTotal_ = 0;
     i2cControllerPlatformStats_.writeFailed_ = 0;
     i2cControllerPlatformStats_.writeBytes_ = 0;
+    i2cControllerPlatformStats_.muxSwitches_ = 0;
+    i2cControllerPlatformStats_.busyUsec_ = 0;
+    i2cControllerPlatformStats_.readsMerged_ = 0;
   }
   // Total number of reads
   void incrReadTotal(uint32_t count = 1) {
@@ -56,6 +59,18 @@ class I2cController {
   void incrWriteBytes(uint32_t count = 1) {
     i2cControllerPlatformStats_.writeBytes_ += count;
   }
+  // Number of mux switches
+  void incrMuxSwitches(uint32_t count = 1) {
+    i2cControllerPlatformStats_.muxSwitches_ += count;
+  }
+  // Time spent in module transactions
+  void incrBusyUsec(uint64_t usec) {
+    i2cControllerPlatformStats_.busyUsec_ += usec;
+  }
+  // Number of reads merged into an adjacent read
+  void incrReadsMerged(uint32_t count = 1) {
+    i2cControllerPlatformStats_.readsMerged_ += count;
+  }
 
   /* Get the I2c transaction stats from the i2c controller
    */
@@ -11,4 +11,10 @@ struct I2cControllerStats {
   5: i64 writeTotal_ = STAT_UNINITIALIZED
   6: i64 writeFailed_ = STAT_UNINITIALIZED
   7: i64 writeBytes_ = STAT_UNINITIALIZED
+  // Number of writes to muxes to switch to another module
+  8: i64 muxSwitches_ = STAT_UNINITIALIZED
+  // Time spent in module transactions, to track bus utilization
+  9: i64 busyUsec_ = STAT_UNINITIALIZED
+  // Number of module reads served by merging them into an adjacent read
+  10: i64 readsMerged_ = STAT_UNINITIALIZED
 }
@@ -6,6 +6,7 @@
 #include "common/init/Init.h"
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 using namespace facebook::fboss;
@@ -37,6 +38,37 @@ BENCHMARK(VectorComparison, n) {
   }
 }
 
+/*
+ * n values split over numThreads concurrent writers, each followed by a
+ * read of the whole window.
+ */
+void multiWriterInsertion(size_t n, size_t numThreads, size_t numShards) {
+  TimeSeriesWithMinMax<int64_t> buf(
+      TimeSeriesWithMinMax<int64_t>::Duration(60),
+      TimeSeriesWithMinMax<int64_t>::Duration(1),
+      numShards);
+  std::vector<std::thread> writers;
+  for (size_t t = 0; t < numThreads; t++) {
+    writers.emplace_back([&buf, n, numThreads]() {
+      for (size_t i = 0; i < n / numThreads; i++) {
+        buf.addValue(i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  doNotOptimizeAway(buf.getMax());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(multiWriterInsertion, 1_thread_1_shard, 1, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM(multiWriterInsertion, 4_threads_1_shard, 4, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM(multiWriterInsertion, 4_threads_4_shards, 4, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM(multiWriterInsertion, 8_threads_1_shard, 8, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM(multiWriterInsertion, 8_threads_8_shards, 8, 8)
+
 int main(int argc, char** argv) {
   facebook::initFacebook(&argc, &argv);
   runBenchmarks();
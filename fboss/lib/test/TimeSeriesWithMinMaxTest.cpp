@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 using namespace facebook::fboss;
 
@@ -22,25 +23,25 @@ TEST(TimeSeriesWithMinMax, BasicTest) {
   /* sleep override */
   sleep_for(seconds(3));
   buffer.addValue(2);
-  buffer.addValue(5, std::chrono::system_clock::now() - seconds(5));
+  buffer.addValue(5, TimeSeriesWithMinMax<int>::Clock::now() - seconds(5));
   EXPECT_EQ(buffer.getMax(), 2);
   EXPECT_EQ(buffer.getMin(), 2);
-  buffer.addValue(3, std::chrono::system_clock::now() - seconds(2));
+  buffer.addValue(3, TimeSeriesWithMinMax<int>::Clock::now() - seconds(2));
   EXPECT_EQ(buffer.getMax(), 3);
   EXPECT_EQ(buffer.getMin(), 2);
-  buffer.addValue(4, std::chrono::system_clock::now());
+  buffer.addValue(4, TimeSeriesWithMinMax<int>::Clock::now());
   EXPECT_EQ(buffer.getMax(), 4);
   EXPECT_EQ(buffer.getMin(), 2);
 
   EXPECT_EQ(
       buffer.getMax(
-          std::chrono::system_clock::now() - seconds(3),
-          std::chrono::system_clock::now() - seconds(2)),
+          TimeSeriesWithMinMax<int>::Clock::now() - seconds(3),
+          TimeSeriesWithMinMax<int>::Clock::now() - seconds(2)),
       3);
   EXPECT_EQ(
       buffer.getMin(
-          std::chrono::system_clock::now() - seconds(3),
-          std::chrono::system_clock::now() - seconds(2)),
+          TimeSeriesWithMinMax<int>::Clock::now() - seconds(3),
+          TimeSeriesWithMinMax<int>::Clock::now() - seconds(2)),
       3);
 
   /* sleep override */
@@ -69,3 +70,44 @@ TEST(TimeSeriesWithMinMax, BasicTest) {
   } catch (std::runtime_error& e) {
   }
 }
+
+TEST(TimeSeriesWithMinMax, RangeQuery) {
+  TimeSeriesWithMinMax<int> buffer(seconds(5), seconds(1));
+  auto now = TimeSeriesWithMinMax<int>::Clock::now();
+  for (int i = 0; i < 5; i++) {
+    buffer.addValue(10 + i, now - seconds(4 - i));
+  }
+  // Buckets which started within the range, whichever ring slots they use
+  EXPECT_EQ(buffer.getMin(now - seconds(4), now - seconds(2)), 11);
+  EXPECT_EQ(buffer.getMax(now - seconds(4), now - seconds(2)), 12);
+  EXPECT_EQ(buffer.getMin(now - seconds(2), now + seconds(1)), 13);
+  EXPECT_EQ(buffer.getMax(now - seconds(2), now + seconds(1)), 14);
+  EXPECT_THROW(
+      buffer.getMax(now + seconds(1), now + seconds(2)), std::runtime_error);
+  // All five values are within the last five seconds
+  auto minMax = buffer.getMinMax();
+  ASSERT_TRUE(minMax.has_value());
+  EXPECT_EQ(minMax->first, 10);
+  EXPECT_EQ(minMax->second, 14);
+}
+
+TEST(TimeSeriesWithMinMax, MultipleWriters) {
+  constexpr int kThreads = 4;
+  constexpr int kValuesPerThread = 10000;
+  TimeSeriesWithMinMax<int64_t> buffer(seconds(60), seconds(1), kThreads);
+  EXPECT_FALSE(buffer.getMinMax().has_value());
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; t++) {
+    writers.emplace_back([&buffer, t]() {
+      for (int i = 0; i < kValuesPerThread; i++) {
+        buffer.addValue(t * kValuesPerThread + i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  EXPECT_EQ(buffer.getMin(), 0);
+  EXPECT_EQ(buffer.getMax(), kThreads * kValuesPerThread - 1);
+}
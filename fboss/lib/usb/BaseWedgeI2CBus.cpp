@@ -10,10 +10,15 @@
 
 #include "fboss/lib/usb/BaseWedgeI2CBus.h"
 
+#include <folly/ScopeGuard.h>
 #include <glog/logging.h>
 
+#include "fboss/lib/usb/I2cReadScheduler.h"
 #include "fboss/lib/usb/UsbError.h"
 
+#include <array>
+#include <cstring>
+
 using folly::MutableByteRange;
 using std::lock_guard;
 
@@ -83,13 +88,12 @@ void BaseWedgeI2CBus::moduleRead(
     int offset,
     int len,
     uint8_t* buf) {
-  selectQsfp(module);
-  CHECK_NE(selectedPort_, NO_PORT);
-
-  read(address, offset, len, buf);
-
-  // TODO: remove this after we ensure exclusive access to cp2112 chip
-  unselectQsfp();
+  std::vector<TransceiverI2CRead> reads;
+  reads.emplace_back(module, address, offset, len, buf);
+  moduleReadBatch(reads);
+  if (reads.front().error) {
+    std::rethrow_exception(reads.front().error);
+  }
 }
 
 void BaseWedgeI2CBus::moduleWrite(
@@ -98,12 +102,62 @@ void BaseWedgeI2CBus::moduleWrite(
     int offset,
     int len,
     const uint8_t* buf) {
+  auto start = std::chrono::steady_clock::now();
+  SCOPE_EXIT {
+    recordBusyTime(start);
+  };
   selectQsfp(module);
   CHECK_NE(selectedPort_, NO_PORT);
 
   write(address, offset, len, buf);
 
   // TODO: remove this after we ensure exclusive access to cp2112 chip
+  if (!sweeping_) {
+    unselectQsfp();
+  }
+}
+
+void BaseWedgeI2CBus::moduleReadBatch(std::vector<TransceiverI2CRead>& reads) {
+  auto start = std::chrono::steady_clock::now();
+  SCOPE_EXIT {
+    recordBusyTime(start);
+  };
+  auto runs = I2cReadScheduler::schedule(
+      reads, [this](unsigned int module) { return getMuxPathKey(module); });
+
+  std::array<uint8_t, I2cReadScheduler::kMaxRunEnd> runBuf;
+  for (const auto& run : runs) {
+    try {
+      selectQsfp(run.module);
+      CHECK_NE(selectedPort_, NO_PORT);
+      read(run.i2cAddress, run.offset, run.len, runBuf.data());
+      for (auto idx : run.reads) {
+        auto& request = reads[idx];
+        memcpy(
+            request.buf,
+            runBuf.data() + request.offset - run.offset,
+            request.len);
+      }
+    } catch (const I2cError&) {
+      for (auto idx : run.reads) {
+        reads[idx].error = std::current_exception();
+      }
+    }
+    dev_->incrReadsMerged(run.reads.size() - 1);
+  }
+
+  // Same as for writes, do not leave a module selected outside of a sweep
+  if (!sweeping_) {
+    unselectQsfp();
+  }
+}
+
+void BaseWedgeI2CBus::beginModuleSweep() {
+  sweeping_ = true;
+}
+
+void BaseWedgeI2CBus::endModuleSweep() {
+  sweeping_ = false;
   unselectQsfp();
 }
 
@@ -125,26 +179,31 @@ bool BaseWedgeI2CBus::isPresent(unsigned int module) {
 
 void BaseWedgeI2CBus::scanPresence(
     std::map<int32_t, ModulePresence>& presences) {
+  // Read the first byte of every module in one batch, so that the sweep
+  // goes through the modules in mux order
+  std::vector<uint8_t> bufs(presences.size());
+  std::vector<TransceiverI2CRead> reads;
   for (auto& presence : presences) {
-    uint8_t buf = 0;
-    try {
-      moduleRead(
-          presence.first + 1,
-          TransceiverI2CApi::ADDR_QSFP,
-          0,
-          sizeof(buf),
-          &buf);
-    } catch (const I2cError& ex) {
-      /*
-       * This can either mean that we failed to open the USB device
-       * because it was already in use, or that the I2C read failed.
-       * At some point we might want to return more a more accurate
-       * status value to higher-level functions.
-       */
-      presence.second = ModulePresence::ABSENT;
-      continue;
-    }
-    presence.second = ModulePresence::PRESENT;
+    reads.emplace_back(
+        presence.first + 1,
+        TransceiverI2CApi::ADDR_QSFP,
+        0,
+        1,
+        &bufs[reads.size()]);
+  }
+  moduleReadBatch(reads);
+
+  auto request = reads.begin();
+  for (auto& presence : presences) {
+    /*
+     * An error can either mean that we failed to open the USB device
+     * because it was already in use, or that the I2C read failed.
+     * At some point we might want to return more a more accurate
+     * status value to higher-level functions.
+     */
+    presence.second =
+        request->error ? ModulePresence::ABSENT : ModulePresence::PRESENT;
+    ++request;
   }
 }
 
@@ -152,6 +211,7 @@ void BaseWedgeI2CBus::selectQsfp(unsigned int port) {
   VLOG(4) << "selecting QSFP " << port;
   CHECK_GT(port, 0);
   if (port != selectedPort_) {
+    dev_->incrMuxSwitches();
     selectQsfpImpl(port);
   }
 }
@@ -159,8 +219,16 @@ void BaseWedgeI2CBus::selectQsfp(unsigned int port) {
 void BaseWedgeI2CBus::unselectQsfp() {
   VLOG(4) << "unselecting all QSFPs";
   if (selectedPort_ != NO_PORT) {
+    dev_->incrMuxSwitches();
     selectQsfpImpl(NO_PORT);
   }
 }
 
+void BaseWedgeI2CBus::recordBusyTime(
+    std::chrono::steady_clock::time_point start) {
+  dev_->incrBusyUsec(std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count());
+}
+
 } // namespace facebook::fboss
@@ -13,6 +13,7 @@
 #include "fboss/lib/usb/TransceiverI2CApi.h"
 
 #include <folly/Range.h>
+#include <chrono>
 #include <mutex>
 
 namespace facebook::fboss {
@@ -28,6 +29,10 @@ class BaseWedgeI2CBus : public TransceiverI2CApi {
   ~BaseWedgeI2CBus() override {}
   void open() override;
   void close() override;
+  /*
+   * Same as a batch of one read. Outside of a sweep the module is unselected
+   * again afterwards, as it is after writes.
+   */
   void moduleRead(
       unsigned int module,
       uint8_t i2cAddress,
@@ -40,6 +45,18 @@ class BaseWedgeI2CBus : public TransceiverI2CApi {
       int offset,
       int len,
       const uint8_t* buf) override;
+  /*
+   * Reads are ordered by mux path and merged where possible (see
+   * I2cReadScheduler). The mux selection is kept between the reads of the
+   * batch and only cleared at the end, or at the end of the sweep.
+   */
+  void moduleReadBatch(std::vector<TransceiverI2CRead>& reads) override;
+  /*
+   * The bus has to be kept open for the whole sweep, reopening it resets the
+   * mux selection.
+   */
+  void beginModuleSweep() override;
+  void endModuleSweep() override;
   void read(uint8_t i2cAddress, int offset, int len, uint8_t* buf);
   void write(uint8_t i2cAddress, int offset, int len, const uint8_t* buf);
 
@@ -72,6 +89,7 @@ class BaseWedgeI2CBus : public TransceiverI2CApi {
 
   std::unique_ptr<CP2112Intf> dev_;
   unsigned int selectedPort_{NO_PORT};
+  bool sweeping_{false};
 
  private:
   /*
@@ -81,6 +99,8 @@ class BaseWedgeI2CBus : public TransceiverI2CApi {
   void selectQsfp(unsigned int module);
   void unselectQsfp();
 
+  void recordBusyTime(std::chrono::steady_clock::time_point start);
+
   // Forbidden copy constructor and assignment operator
   BaseWedgeI2CBus(BaseWedgeI2CBus const&) = delete;
   BaseWedgeI2CBus& operator=(BaseWedgeI2CBus const&) = delete;
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/lib/usb/I2cReadScheduler.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace facebook::fboss {
+
+std::vector<I2cReadRun> I2cReadScheduler::schedule(
+    const std::vector<TransceiverI2CRead>& reads,
+    const MuxPathKeyFn& muxPathKey) {
+  // Mux path lookups can be costly, do them once per module
+  std::map<unsigned int, uint64_t> moduleKeys;
+  for (const auto& read : reads) {
+    if (moduleKeys.find(read.module) == moduleKeys.end()) {
+      moduleKeys.emplace(read.module, muxPathKey(read.module));
+    }
+  }
+
+  std::vector<size_t> order(reads.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  auto sortKey = [&](size_t idx) {
+    const auto& read = reads[idx];
+    return std::make_tuple(
+        moduleKeys[read.module], read.module, read.i2cAddress, read.offset);
+  };
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return sortKey(a) < sortKey(b);
+  });
+
+  std::vector<I2cReadRun> runs;
+  for (auto idx : order) {
+    const auto& read = reads[idx];
+    if (!runs.empty()) {
+      auto& run = runs.back();
+      auto end = std::max(run.offset + run.len, read.offset + read.len);
+      if (run.module == read.module && run.i2cAddress == read.i2cAddress &&
+          read.offset <= run.offset + run.len && end <= kMaxRunEnd) {
+        run.len = end - run.offset;
+        run.reads.push_back(idx);
+        continue;
+      }
+    }
+    I2cReadRun run;
+    run.module = read.module;
+    run.i2cAddress = read.i2cAddress;
+    run.offset = read.offset;
+    run.len = read.len;
+    run.reads.push_back(idx);
+    runs.push_back(std::move(run));
+  }
+  return runs;
+}
+
+} // namespace facebook::fboss
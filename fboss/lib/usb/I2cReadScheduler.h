@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * A single transaction that serves one or more reads of a batch. The
+ * transaction reads [offset, offset + len) from the module, and every read
+ * listed in reads is a sub-range of that.
+ */
+struct I2cReadRun {
+  unsigned int module{0};
+  uint8_t i2cAddress{0};
+  int offset{0};
+  int len{0};
+  std::vector<size_t> reads;
+};
+
+/*
+ * Orders a batch of module reads for a bus with muxes in front of the
+ * modules.
+ *
+ * Reads are sorted by the mux path of their module, then by module, address
+ * and offset, so that a sweep over all modules switches every mux as few
+ * times as possible. Reads from the same module and address that overlap or
+ * are adjacent are merged into a single transaction, as long as it stays
+ * within one page of the module's memory map.
+ */
+class I2cReadScheduler {
+ public:
+  using MuxPathKeyFn = std::function<uint64_t(unsigned int module)>;
+
+  // Offsets are a single byte on the wire
+  static constexpr int kMaxRunEnd = 256;
+
+  static std::vector<I2cReadRun> schedule(
+      const std::vector<TransceiverI2CRead>& reads,
+      const MuxPathKeyFn& muxPathKey);
+};
+
+} // namespace facebook::fboss
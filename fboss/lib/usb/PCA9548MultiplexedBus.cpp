@@ -34,6 +34,18 @@ void PCA9548MultiplexedBus::verifyBus(bool) {
   return;
 }
 
+uint64_t PCA9548MultiplexedBus::getMuxPathKey(unsigned int module) {
+  if (module == NO_PORT) {
+    return 0;
+  }
+  CHECK_LE(module, numPorts_);
+  // A single layer of muxes: the (mux address, channel selector) pair in
+  // the top 16 bits, like PCA9548MuxedBus does for the root layer.
+  uint64_t address = multiplexerStartAddr_ + ((module - 1) / 8) * 2;
+  uint64_t selector = qsfpAddressMap_[(module - 1) % 8];
+  return ((address << 8) | selector) << 48;
+}
+
 void PCA9548MultiplexedBus::selectQsfpImpl(unsigned int port) {
   // If any of these writes throws, we'll be in an invalid state.
 
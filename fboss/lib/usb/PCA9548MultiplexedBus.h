@@ -37,6 +37,8 @@ class PCA9548MultiplexedBus : public BaseWedgeI2CBus {
         numPorts_(numPorts),
         qsfpAddressMap_(qsfpAddressMap) {}
 
+  uint64_t getMuxPathKey(unsigned int module) override;
+
  protected:
   void initBus() override;
   void verifyBus(bool autoReset = true) override;
@@ -108,6 +108,23 @@ class PCA9548MuxedBus : public BaseWedgeI2CBus {
     selectedPort_ = NO_PORT;
   }
 
+  uint64_t getMuxPathKey(unsigned int module) override {
+    // One 16 bit (mux address, channel) pair per layer, root first
+    createTopology();
+    auto path = calculatePath(module);
+    if (path.empty()) {
+      return 0;
+    }
+    CHECK_LE(path.size(), sizeof(uint64_t) / sizeof(uint16_t));
+    uint64_t key = 0;
+    for (auto muxChannel : path) {
+      key = (key << 16) | (muxChannel->mux->mux()->address() << 8) |
+          muxChannel->channel;
+    }
+    // Align paths of different depths on the root
+    return key << (16 * (sizeof(uint64_t) / sizeof(uint16_t) - path.size()));
+  }
+
  protected:
   using PortLeaves = std::array<MuxChannel, NUM_PORTS>;
 
@@ -128,9 +145,20 @@ class PCA9548MuxedBus : public BaseWedgeI2CBus {
   }
 
   void initBus() override {
+    createTopology();
+    ensureNothingSelected();
+  }
+
+  /*
+   * Create the muxes and wire the ports up to them, once. This does not
+   * touch the bus, so the topology can be looked at before it is opened.
+   */
+  void createTopology() {
+    if (!roots_.empty()) {
+      return;
+    }
     roots_ = createMuxes();
     wireUpPorts(leaves_);
-    ensureNothingSelected();
   }
 
   void selectQsfpImpl(unsigned int port) override {
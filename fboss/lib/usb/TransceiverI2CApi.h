@@ -13,9 +13,11 @@
 #include "fboss/lib/i2c/gen-cpp2/i2c_controller_stats_types.h"
 
 #include <cstdint>
+#include <exception>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace facebook::fboss {
 enum class ModulePresence { PRESENT, ABSENT, UNKNOWN };
@@ -32,6 +34,31 @@ class I2cError : public std::exception {
   std::string what_;
 };
 
+/*
+ * One read in a batch of module reads. If the read fails, error is set and
+ * the content of buf is undefined.
+ */
+struct TransceiverI2CRead {
+  TransceiverI2CRead(
+      unsigned int module_,
+      uint8_t i2cAddress_,
+      int offset_,
+      int len_,
+      uint8_t* buf_)
+      : module(module_),
+        i2cAddress(i2cAddress_),
+        offset(offset_),
+        len(len_),
+        buf(buf_) {}
+
+  unsigned int module;
+  uint8_t i2cAddress;
+  int offset;
+  int len;
+  uint8_t* buf;
+  std::exception_ptr error;
+};
+
 /*
  * Abstract away some of the details of handling the I2C bus to query
  * QSFP and SFP transceiver modules.
@@ -57,6 +84,42 @@ class TransceiverI2CApi {
       int len,
       const uint8_t* buf) = 0;
 
+  /*
+   * Perform a batch of reads. Buses are free to reorder and merge the reads,
+   * so the batch must not depend on state changed by other reads in it
+   * (e.g. the page selected in a module). A read failing with an I2cError
+   * does not stop the rest of the batch.
+   */
+  virtual void moduleReadBatch(std::vector<TransceiverI2CRead>& reads) {
+    for (auto& read : reads) {
+      try {
+        moduleRead(
+            read.module, read.i2cAddress, read.offset, read.len, read.buf);
+      } catch (const I2cError&) {
+        read.error = std::current_exception();
+      }
+    }
+  }
+
+  /*
+   * Sort key for the path of muxes in front of a module. Modules behind the
+   * same muxes have adjacent keys, so accessing modules in key order
+   * switches muxes as little as possible. Does not access the bus, so it
+   * may be called without opening it.
+   */
+  virtual uint64_t getMuxPathKey(unsigned int module) {
+    return module;
+  }
+
+  /*
+   * Accesses between beginModuleSweep() and endModuleSweep(), e.g. refreshing
+   * every module in mux path order, may keep the bus open and the last module
+   * accessed selected, so that moving on to the next module only switches the
+   * muxes that differ.
+   */
+  virtual void beginModuleSweep() {}
+  virtual void endModuleSweep() {}
+
   virtual void verifyBus(bool autoReset) = 0;
 
   virtual bool isPresent(unsigned int module) = 0;
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/usb/CP2112.h"
+#include "fboss/lib/usb/PCA9548MuxedBus.h"
+
+#include <folly/container/Enumerate.h>
+#include <gmock/gmock.h>
+
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+class MockCP2112 : public CP2112Intf {
+ public:
+  MOCK_METHOD1(open, void(bool));
+  MOCK_METHOD0(close, void());
+  MOCK_METHOD0(resetDevice, void());
+
+  MOCK_METHOD3(
+      read,
+      void(uint8_t, folly::MutableByteRange, std::chrono::milliseconds));
+  using CP2112Intf::read;
+
+  MOCK_METHOD3(
+      write,
+      void(uint8_t, folly::ByteRange, std::chrono::milliseconds));
+  using CP2112Intf::write;
+
+  std::chrono::milliseconds getDefaultTimeout() const override {
+    return std::chrono::milliseconds(500);
+  }
+};
+
+/*
+ * CP2112 stand-in that records the traffic on the bus instead of mocking
+ * it. Every byte read from a module holds its own offset, so tests can
+ * check what ends up in the caller's buffers.
+ */
+class FakeCP2112 : public CP2112Intf {
+ public:
+  void open(bool /* setSmbusConfig */) override {}
+  void close() override {}
+  void resetDevice() override {}
+
+  void read(
+      uint8_t address,
+      folly::MutableByteRange buf,
+      std::chrono::milliseconds /* timeout */) override {
+    if (failReads_) {
+      incrReadFailed();
+      throw I2cError("injected read failure");
+    }
+    reads_.emplace_back(address >> 1, buf.size());
+    for (size_t i = 0; i < buf.size(); ++i) {
+      buf[i] = static_cast<uint8_t>(offset_ + i);
+    }
+    incrReadTotal();
+    incrReadBytes(buf.size());
+  }
+  using CP2112Intf::read;
+
+  void write(
+      uint8_t address,
+      folly::ByteRange buf,
+      std::chrono::milliseconds /* timeout */) override {
+    if ((address >> 1) == TransceiverI2CApi::ADDR_QSFP) {
+      // Writing just the offset, in preparation for a read
+      offset_ = buf[0];
+    } else {
+      ++muxWrites_;
+    }
+    incrWriteTotal();
+    incrWriteBytes(buf.size());
+  }
+  using CP2112Intf::write;
+
+  std::chrono::milliseconds getDefaultTimeout() const override {
+    return std::chrono::milliseconds(500);
+  }
+
+  // (device address, length) of every read
+  const std::vector<std::pair<uint8_t, size_t>>& getReads() const {
+    return reads_;
+  }
+  int getMuxWrites() const {
+    return muxWrites_;
+  }
+  void setFailReads(bool failReads) {
+    failReads_ = failReads;
+  }
+  void clearHistory() {
+    reads_.clear();
+    muxWrites_ = 0;
+  }
+
+ private:
+  std::vector<std::pair<uint8_t, size_t>> reads_;
+  int muxWrites_{0};
+  uint8_t offset_{0};
+  bool failReads_{false};
+};
+
+int constexpr pow(int base, int exponent) {
+  return exponent == 0 ? 1 : base * pow(base, exponent - 1);
+}
+
+/*
+ * This class is a helper to generate a fully populated mux bus w/
+ * NUM_LAYERS layers of muxes and MUXES_PER_LAYER muxes on each layer.
+ */
+template <int LAYERS, int MUXES_PER_LAYER, typename DevT = MockCP2112>
+class FakeMuxBus
+    : public PCA9548MuxedBus<pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)> {
+ public:
+  FakeMuxBus()
+      : PCA9548MuxedBus<pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)>(
+            std::make_unique<DevT>()) {}
+  MuxLayer createMuxes() override {
+    MuxLayer roots;
+    for (int i = 0; i < MUXES_PER_LAYER; ++i) {
+      roots.push_back(std::make_unique<QsfpMux>(this->dev_.get(), i));
+    }
+
+    populateMuxes(roots, 1);
+
+    return roots;
+  }
+
+  void wireUpPorts(typename PCA9548MuxedBus<
+                   pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)>::PortLeaves&
+                       leaves) override {
+    for (const auto&& mux : folly::enumerate(leafMuxes_)) {
+      auto start = mux.index * PCA9548::WIDTH;
+      this->connectPortsToMux(leaves, *mux, start);
+    }
+  }
+
+  MuxLayer& roots() {
+    return this->roots_;
+  }
+
+  void selectQsfp(unsigned int module) {
+    this->selectQsfpImpl(module);
+  }
+
+  DevT* fakeDev() {
+    return static_cast<DevT*>(this->dev_.get());
+  }
+
+ private:
+  void populateMuxes(MuxLayer& parentLayer, uint8_t currLayer) {
+    for (int i = 0; i < parentLayer.size(); ++i) {
+      auto& mux = parentLayer[i];
+
+      if (currLayer == LAYERS) {
+        leafMuxes_.push_back(mux.get());
+        continue;
+      }
+
+      for (uint8_t channel = 0; channel < PCA9548::WIDTH; ++channel) {
+        for (int k = 0; k < MUXES_PER_LAYER; ++k) {
+          auto addr = currLayer * 10 + k;
+          mux->registerChildMux(this->dev_.get(), channel, addr);
+        }
+        auto& nextLayer = mux->children(channel);
+        populateMuxes(nextLayer, currLayer + 1);
+      }
+    }
+  }
+
+  // helper just to wire up ports w/out walking tree again
+  std::vector<QsfpMux*> leafMuxes_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/I2cReadScheduler.h"
+#include "fboss/lib/usb/tests/FakeMuxBus.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kAddr = TransceiverI2CApi::ADDR_QSFP;
+
+uint64_t moduleOrder(unsigned int module) {
+  return module;
+}
+} // namespace
+
+TEST(I2cReadSchedulerTests, MergeAdjacentReads) {
+  std::array<uint8_t, 256> buf;
+  std::vector<TransceiverI2CRead> reads;
+  reads.emplace_back(1, kAddr, 128, 128, buf.data() + 128);
+  reads.emplace_back(1, kAddr, 0, 128, buf.data());
+  // Overlaps the first read
+  reads.emplace_back(1, kAddr, 2, 4, buf.data());
+  // Different address on the same module
+  reads.emplace_back(1, kAddr + 1, 128, 16, buf.data());
+
+  auto runs = I2cReadScheduler::schedule(reads, moduleOrder);
+  ASSERT_EQ(2, runs.size());
+  EXPECT_EQ(kAddr, runs[0].i2cAddress);
+  EXPECT_EQ(0, runs[0].offset);
+  EXPECT_EQ(256, runs[0].len);
+  EXPECT_EQ(std::vector<size_t>({1, 2, 0}), runs[0].reads);
+  EXPECT_EQ(kAddr + 1, runs[1].i2cAddress);
+  EXPECT_EQ(std::vector<size_t>({3}), runs[1].reads);
+}
+
+TEST(I2cReadSchedulerTests, NoMergeAcrossGaps) {
+  std::array<uint8_t, 16> buf;
+  std::vector<TransceiverI2CRead> reads;
+  reads.emplace_back(1, kAddr, 0, 4, buf.data());
+  reads.emplace_back(1, kAddr, 8, 4, buf.data());
+  reads.emplace_back(2, kAddr, 4, 4, buf.data());
+
+  auto runs = I2cReadScheduler::schedule(reads, moduleOrder);
+  EXPECT_EQ(3, runs.size());
+}
+
+TEST(I2cReadSchedulerTests, OrderByMuxPath) {
+  std::array<uint8_t, 4> buf;
+  std::vector<TransceiverI2CRead> reads;
+  for (unsigned int module = 1; module <= 4; ++module) {
+    reads.emplace_back(module, kAddr, 0, 1, buf.data() + module - 1);
+  }
+  // Odd and even modules sit behind different muxes
+  auto runs = I2cReadScheduler::schedule(
+      reads, [](unsigned int module) { return module % 2; });
+  ASSERT_EQ(4, runs.size());
+  EXPECT_EQ(2, runs[0].module);
+  EXPECT_EQ(4, runs[1].module);
+  EXPECT_EQ(1, runs[2].module);
+  EXPECT_EQ(3, runs[3].module);
+}
+
+TEST(I2cReadSchedulerTests, BatchOnMuxedBus) {
+  FakeMuxBus<2, 2, FakeCP2112> bus;
+  bus.open();
+  auto dev = bus.fakeDev();
+
+  // Sweep across all 256 modules, in an order that hops across muxes
+  std::vector<std::array<uint8_t, 4>> bufs(256);
+  std::vector<TransceiverI2CRead> reads;
+  for (unsigned int i = 0; i < 256; ++i) {
+    unsigned int module = (i % 2) ? 129 + i / 2 : 1 + i / 2;
+    auto buf = bufs[module - 1].data();
+    reads.emplace_back(module, kAddr, 0, 2, buf);
+    reads.emplace_back(module, kAddr, 2, 2, buf + 2);
+  }
+  dev->clearHistory();
+  bus.moduleReadBatch(reads);
+
+  // One merged read per module
+  EXPECT_EQ(256, dev->getReads().size());
+  for (const auto& read : reads) {
+    EXPECT_FALSE(read.error);
+  }
+  for (const auto& buf : bufs) {
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(3, buf[3]);
+  }
+  const auto& stats = dev->getI2cControllerPlatformStats();
+  EXPECT_EQ(256, stats.readsMerged_);
+  // In mux order, most modules only need a single write to their leaf mux.
+  // Hopping between the two root muxes for every module would take at least
+  // two writes per module.
+  EXPECT_LT(dev->getMuxWrites(), 256 + 64);
+}
+
+TEST(I2cReadSchedulerTests, ScanPresenceErrors) {
+  FakeMuxBus<1, 1, FakeCP2112> bus;
+  bus.open();
+  std::map<int32_t, ModulePresence> presences;
+  for (int32_t i = 0; i < 8; ++i) {
+    presences[i] = ModulePresence::UNKNOWN;
+  }
+
+  bus.scanPresence(presences);
+  for (const auto& presence : presences) {
+    EXPECT_EQ(ModulePresence::PRESENT, presence.second);
+  }
+
+  bus.fakeDev()->setFailReads(true);
+  bus.scanPresence(presences);
+  for (const auto& presence : presences) {
+    EXPECT_EQ(ModulePresence::ABSENT, presence.second);
+  }
+}
+
+TEST(I2cReadSchedulerTests, SweepKeepsMuxSelected) {
+  FakeMuxBus<2, 2, FakeCP2112> bus;
+  bus.open();
+  auto dev = bus.fakeDev();
+  std::array<uint8_t, 2> buf;
+
+  // Outside of a sweep every read selects and unselects the whole path
+  dev->clearHistory();
+  bus.moduleRead(1, kAddr, 0, 2, buf.data());
+  bus.moduleRead(2, kAddr, 0, 2, buf.data());
+  auto unsweptWrites = dev->getMuxWrites();
+
+  // Within a sweep only the leaf mux changes between neighbouring modules,
+  // and the path is unselected once at the end
+  dev->clearHistory();
+  bus.beginModuleSweep();
+  bus.moduleRead(1, kAddr, 0, 2, buf.data());
+  bus.moduleRead(2, kAddr, 0, 2, buf.data());
+  EXPECT_TRUE(bus.roots()[0]->mux()->isSelected(0));
+  bus.endModuleSweep();
+  EXPECT_EQ(0, bus.roots()[0]->mux()->selected());
+  EXPECT_LT(dev->getMuxWrites(), unsweptWrites);
+  EXPECT_EQ(2, dev->getReads().size());
+  EXPECT_EQ(1, buf[1]);
+}
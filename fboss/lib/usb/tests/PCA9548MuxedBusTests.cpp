@@ -8,10 +8,8 @@
  *
  */
 
-#include "fboss/lib/usb/CP2112.h"
-#include "fboss/lib/usb/PCA9548MuxedBus.h"
+#include "fboss/lib/usb/tests/FakeMuxBus.h"
 
-#include <folly/container/Enumerate.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -19,99 +17,6 @@ using namespace facebook::fboss;
 using ::testing::_;
 using ::testing::InSequence;
 
-class MockCP2112 : public CP2112Intf {
- public:
-  MOCK_METHOD1(open, void(bool));
-  MOCK_METHOD0(close, void());
-  MOCK_METHOD0(resetDevice, void());
-
-  MOCK_METHOD3(
-      read,
-      void(uint8_t, folly::MutableByteRange, std::chrono::milliseconds));
-  using CP2112Intf::read;
-
-  MOCK_METHOD3(
-      write,
-      void(uint8_t, folly::ByteRange, std::chrono::milliseconds));
-  using CP2112Intf::write;
-
-  std::chrono::milliseconds getDefaultTimeout() const override {
-    return std::chrono::milliseconds(500);
-  }
-};
-
-int constexpr pow(int base, int exponent) {
-  return exponent == 0 ? 1 : base * pow(base, exponent - 1);
-}
-
-/*
- * This class is a helper to generate a fully populated mux bus w/
- * NUM_LAYERS layers of muxes and MUXES_PER_LAYER muxes on each layer.
- */
-template <int LAYERS, int MUXES_PER_LAYER>
-class FakeMuxBus
-    : public PCA9548MuxedBus<pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)> {
- public:
-  FakeMuxBus()
-      : PCA9548MuxedBus<pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)>(
-            std::make_unique<MockCP2112>()) {}
-  MuxLayer createMuxes() override {
-    MuxLayer roots;
-    for (int i = 0; i < MUXES_PER_LAYER; ++i) {
-      roots.push_back(std::make_unique<QsfpMux>(this->dev_.get(), i));
-    }
-
-    populateMuxes(roots, 1);
-
-    return roots;
-  }
-
-  void wireUpPorts(typename PCA9548MuxedBus<
-                   pow(MUXES_PER_LAYER* PCA9548::WIDTH, LAYERS)>::PortLeaves&
-                       leaves) override {
-    for (const auto&& mux : folly::enumerate(leafMuxes_)) {
-      auto start = mux.index * PCA9548::WIDTH;
-      this->connectPortsToMux(leaves, *mux, start);
-    }
-  }
-
-  MuxLayer& roots() {
-    return this->roots_;
-  }
-
-  void selectQsfp(unsigned int module) {
-    this->selectQsfpImpl(module);
-  }
-
-  MockCP2112* fakeDev() {
-    return static_cast<MockCP2112*>(this->dev_.get());
-  }
-
- private:
-  void populateMuxes(MuxLayer& parentLayer, uint8_t currLayer) {
-    for (int i = 0; i < parentLayer.size(); ++i) {
-      auto& mux = parentLayer[i];
-
-      if (currLayer == LAYERS) {
-        leafMuxes_.push_back(mux.get());
-        continue;
-      }
-
-      for (uint8_t channel = 0; channel < PCA9548::WIDTH; ++channel) {
-        for (int k = 0; k < MUXES_PER_LAYER; ++k) {
-          auto addr = currLayer * 10 + k;
-          mux->registerChildMux(this->dev_.get(), channel, addr);
-        }
-        auto& nextLayer = mux->children(channel);
-        populateMuxes(nextLayer, currLayer + 1);
-      }
-    }
-  }
-
-  // helper just to wire up ports w/out walking tree again
-  std::vector<QsfpMux*> leafMuxes_;
-};
-
 TEST(PCA9548MuxedBusTests, SingleMux) {
   FakeMuxBus<1, 1> bus;
   bus.open();
@@ -300,3 +205,15 @@ TEST(PCA9548MuxedBusTests, MultiLayerMultiMux) {
     EXPECT_EQ(root2->children(7)[1]->mux()->selected(), 0);
   }
 }
+
+TEST(PCA9548MuxedBusTests, MuxPathKeyWithoutOpening) {
+  FakeMuxBus<2, 2> bus;
+  EXPECT_CALL(*bus.fakeDev(), write(_, _, _)).Times(0);
+
+  // Modules behind the same leaf mux only differ in the leaf channel
+  EXPECT_EQ(bus.getMuxPathKey(1) >> 40, bus.getMuxPathKey(8) >> 40);
+  EXPECT_NE(bus.getMuxPathKey(8) >> 40, bus.getMuxPathKey(9) >> 40);
+  EXPECT_LT(bus.getMuxPathKey(1), bus.getMuxPathKey(8));
+  // Nothing is selected yet
+  EXPECT_EQ(bus.roots()[0]->mux()->selected(), 0);
+}
@@ -53,4 +53,21 @@ void QsfpServiceHandler::syncPorts(
   manager_->syncPorts(info, std::move(ports));
 }
 
+void QsfpServiceHandler::syncPortsDelta(
+    TransceiverInfoDelta& delta,
+    std::unique_ptr<std::map<int32_t, PortStatus>> ports,
+    int64_t sinceGeneration) {
+  auto log = LOG_THRIFT_CALL(INFO);
+  std::map<int32_t, TransceiverInfo> syncedInfo;
+  manager_->syncPorts(syncedInfo, std::move(ports));
+
+  // The delta covers all transceivers, not only the synced ones, so clients
+  // only need to remember a single generation.
+  std::map<int32_t, TransceiverInfo> info;
+  manager_->getTransceiversInfo(
+      info, std::make_unique<std::vector<int32_t>>());
+  infoTracker_.update(info);
+  delta = infoTracker_.getDelta(sinceGeneration);
+}
+
 }} // facebook::fboss
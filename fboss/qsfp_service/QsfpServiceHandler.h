@@ -7,6 +7,7 @@
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/QsfpService.h"
 #include "fboss/qsfp_service/TransceiverManager.h"
+#include "fboss/qsfp_service/lib/TransceiverInfoDelta.h"
 
 namespace facebook { namespace fboss {
 
@@ -39,6 +40,15 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
     std::map<int32_t, TransceiverInfo>& info,
     std::unique_ptr<std::map<int32_t, PortStatus>> ports) override;
 
+  /*
+   * Store port status information and return the transceivers that changed
+   * after sinceGeneration.
+   */
+  void syncPortsDelta(
+    TransceiverInfoDelta& delta,
+    std::unique_ptr<std::map<int32_t, PortStatus>> ports,
+    int64_t sinceGeneration) override;
+
   /*
    * Customise the transceiver based on the speed at which it has
    * been configured to operate at
@@ -58,5 +68,6 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
   QsfpServiceHandler& operator=(QsfpServiceHandler const &) = delete;
 
   std::unique_ptr<TransceiverManager> manager_{nullptr};
+  TransceiverInfoTracker infoTracker_;
 };
 }} // facebook::fboss
@@ -37,4 +37,13 @@ service QsfpService extends fb303.FacebookService {
   map<i32, transceiver.TransceiverInfo> syncPorts(1: map<i32, ctrl.PortStatus> ports)
     throws (1: fboss.FbossBaseError error)
 
+  /*
+   * Same as syncPorts, but returns only the transceivers that changed after
+   * sinceGeneration, across all ports. Pass 0 to get all transceivers.
+   */
+  transceiver.TransceiverInfoDelta syncPortsDelta(
+      1: map<i32, ctrl.PortStatus> ports,
+      2: i64 sinceGeneration)
+    throws (1: fboss.FbossBaseError error)
+
 }
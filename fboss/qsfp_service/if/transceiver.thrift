@@ -168,6 +168,22 @@ struct TransceiverInfo {
   14: optional TransceiverStats stats,
 }
 
+/*
+ * Transceivers that changed after a given generation. Transceivers that
+ * did not change are left out.
+ */
+struct TransceiverInfoDelta {
+  // Generation of the latest change. Pass it as sinceGeneration in the next
+  // request to only get what changed after this reply.
+  1: i64 generation,
+  // Transceivers whose static fields (everything except sensor, channels
+  // and stats) changed, with all fields set.
+  2: map<i32, TransceiverInfo> changed,
+  // Transceivers where only sensor data changed. Only sensor, channels and
+  // stats are set, the static fields are left at their defaults.
+  3: map<i32, TransceiverInfo> sensorUpdates,
+}
+
 typedef binary (cpp2.type = "folly::IOBuf") IOBuf
 
 struct RawDOMData {
@@ -12,6 +12,7 @@
 #include "fboss/qsfp_service/lib/QsfpClient.h"
 
 #include <folly/logging/xlog.h>
+#include <thrift/lib/cpp/TApplicationException.h>
 #include <chrono>
 
 namespace facebook { namespace fboss {
@@ -124,6 +125,7 @@ folly::Future<folly::Unit> QsfpCache::confirmAlive() {
       XLOG(DBG1) << "qsfp_service restarted. aliveSince: " << remoteAliveSince_
                  << " -> " << aliveSince;
       std::tie(remoteAliveSince_,  remoteGen_) = std::make_tuple(aliveSince, 0);
+      remoteTcvrGen_ = 0;
     }
   };
 
@@ -134,19 +136,31 @@ folly::Future<folly::Unit> QsfpCache::confirmAlive() {
 folly::Future<folly::Unit> QsfpCache::doSync(PortMapThrift&& toSync) {
   CHECK(evb_->isInEventBaseThread());
 
-  auto syncPorts = [ports = std::move(toSync)](
+  auto syncPorts = [this, ports = std::move(toSync), sinceGen = remoteTcvrGen_](
                        std::unique_ptr<QsfpServiceAsyncClient> client) mutable {
     XLOG(DBG1) << "Will try to sync " << ports.size()
                << " ports to qsfp_service";
     auto options = QsfpClient::getRpcOptions();
-    return client->future_syncPorts(options, std::move(ports));
+    if (!useDelta_) {
+      return client->future_syncPorts(options, std::move(ports))
+          .thenValue([this](TcvrMapThrift&& tcvrs) {
+            XLOG(DBG1) << "Got " << tcvrs.size()
+                       << " transceivers from qsfp_service";
+            this->updateCache(tcvrs);
+          });
+    }
+    return client->future_syncPortsDelta(options, std::move(ports), sinceGen)
+        .thenValue([this](TransceiverInfoDelta&& delta) {
+          XLOG(DBG1) << "Got " << delta.changed.size() << " changed and "
+                     << delta.sensorUpdates.size()
+                     << " sensor updated transceivers from qsfp_service";
+          this->updateCache(delta);
+        });
   };
 
   auto onSuccess = [this,
                     gen = incrementGen(),
-                    oldAliveSince = remoteAliveSince_](auto&& tcvrs) {
-    XLOG(DBG1) << "Got " << tcvrs.size() << " transceivers from qsfp_service";
-    this->updateCache(tcvrs);
+                    oldAliveSince = remoteAliveSince_](auto&&) {
     if (remoteAliveSince_ == oldAliveSince || oldAliveSince < 0) {
       // no restart occurred in middle of request, store gen
       remoteGen_ = gen;
@@ -163,6 +177,20 @@ folly::Future<folly::Unit> QsfpCache::doSync(PortMapThrift&& toSync) {
       .thenValue([evb = evb_](auto&&) { return QsfpClient::createClient(evb); })
       .thenValue(syncPorts)
       .thenValue(onSuccess)
+      .thenError(
+          folly::tag_t<apache::thrift::TApplicationException>{},
+          [this](const apache::thrift::TApplicationException& e) {
+            if (useDelta_ &&
+                e.getType() ==
+                    apache::thrift::TApplicationException::UNKNOWN_METHOD) {
+              XLOG(WARNING) << "qsfp_service does not support syncPortsDelta,"
+                            << " falling back to syncPorts";
+              useDelta_ = false;
+            } else {
+              XLOG(ERR) << "Exception talking to qsfp_service: " << e.what();
+            }
+            this->maybeSync();
+          })
       .thenError(
           folly::tag_t<std::exception>{},
           [this](const std::exception& e) {
@@ -184,6 +212,31 @@ void QsfpCache::updateCache(const TcvrMapThrift& tcvrs) {
   });
 }
 
+void QsfpCache::updateCache(const TransceiverInfoDelta& delta) {
+  bool missingTcvrs = false;
+  tcvrs_.withWLock([&delta, &missingTcvrs](auto& lockedTcvrs) {
+    for (const auto& item : delta.changed) {
+      lockedTcvrs[TransceiverID(item.first)] = item.second;
+    }
+    for (const auto& item : delta.sensorUpdates) {
+      auto it = lockedTcvrs.find(TransceiverID(item.first));
+      if (it == lockedTcvrs.end()) {
+        missingTcvrs = true;
+        continue;
+      }
+      transceiver_info_delta::mergeSensorFields(it->second, item.second);
+    }
+  });
+  if (missingTcvrs) {
+    // Sensor data for a transceiver we never got in full, we lost track of
+    // what we have. Ask for everything next time.
+    XLOG(WARNING) << "Got sensor data for unknown transceivers, will resync";
+    remoteTcvrGen_ = 0;
+  } else {
+    remoteTcvrGen_ = delta.generation;
+  }
+}
+
 std::optional<TransceiverInfo> QsfpCache::getIf(TransceiverID tcvrId) {
   if (!initialized_.load(std::memory_order_acquire)) {
     throw std::runtime_error("Cache not yet initialized...");
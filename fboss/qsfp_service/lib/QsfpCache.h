@@ -27,6 +27,7 @@
 #include "fboss/agent/types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/lib/TransceiverInfoDelta.h"
 
 /*
  * This class is a helper for clients that want to exchange port state w/ qsfp
@@ -55,6 +56,13 @@
  * qsfp_service. This request has all ports s.t the generation number
  * for the latest change to that port is > remoteGen_.
  *
+ * Transceiver info is exchanged as deltas (syncPortsDelta): qsfp_service
+ * stamps transceivers with the generation of their last change, and we
+ * pass the last generation we got back in remoteTcvrGen_. We get full info
+ * for transceivers whose static fields changed and only sensor data for the
+ * others. If qsfp_service does not know syncPortsDelta we fall back to
+ * syncPorts for good.
+ *
  * Detecting restarts
  * ------------------
  * We also need to handle potential restarts of the qsfp_service. In
@@ -135,6 +143,7 @@ class QsfpCache : private folly::AsyncTimeout {
    * cache.
    */
   void updateCache(const TcvrMapThrift& tcvrs);
+  void updateCache(const TransceiverInfoDelta& delta);
 
   // gets a new unique generation number
   uint32_t incrementGen();
@@ -159,6 +168,12 @@ class QsfpCache : private folly::AsyncTimeout {
   // last aliveSince from qsfp_service
   int64_t remoteAliveSince_{-1};
 
+  // transceiver info generation that we have synced from qsfp_service
+  int64_t remoteTcvrGen_{0};
+
+  // whether qsfp_service supports syncPortsDelta
+  bool useDelta_{true};
+
   std::atomic_bool initialized_{false};
 };
 
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/lib/TransceiverInfoDelta.h"
+
+#include <chrono>
+
+namespace facebook { namespace fboss {
+
+namespace transceiver_info_delta {
+
+namespace {
+TransceiverInfo withoutSensorFields(const TransceiverInfo& info) {
+  auto copy = info;
+  copy.sensor_ref().reset();
+  copy.channels.clear();
+  copy.stats_ref().reset();
+  return copy;
+}
+} // namespace
+
+bool staticFieldsEqual(const TransceiverInfo& a, const TransceiverInfo& b) {
+  return withoutSensorFields(a) == withoutSensorFields(b);
+}
+
+TransceiverInfo getSensorFields(const TransceiverInfo& info) {
+  TransceiverInfo sensorFields;
+  mergeSensorFields(sensorFields, info);
+  return sensorFields;
+}
+
+void mergeSensorFields(TransceiverInfo& cached, const TransceiverInfo& update) {
+  if (update.sensor_ref()) {
+    cached.sensor_ref() = *update.sensor_ref();
+  } else {
+    cached.sensor_ref().reset();
+  }
+  cached.channels = update.channels;
+  if (update.stats_ref()) {
+    cached.stats_ref() = *update.stats_ref();
+  } else {
+    cached.stats_ref().reset();
+  }
+}
+
+} // namespace transceiver_info_delta
+
+TransceiverInfoTracker::TransceiverInfoTracker() {
+  // Start from the wall clock, so generations keep increasing across
+  // restarts and a client can never mistake an old generation for a new one
+  state_.wlock()->generation =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+}
+
+void TransceiverInfoTracker::update(
+    const std::map<int32_t, TransceiverInfo>& infos) {
+  auto state = state_.wlock();
+  for (const auto& item : infos) {
+    auto it = state->entries.find(item.first);
+    if (it == state->entries.end()) {
+      auto gen = ++state->generation;
+      state->entries.emplace(item.first, Entry{item.second, gen, gen});
+      continue;
+    }
+    auto& entry = it->second;
+    if (entry.info == item.second) {
+      continue;
+    }
+    entry.generation = ++state->generation;
+    if (!transceiver_info_delta::staticFieldsEqual(entry.info, item.second)) {
+      entry.staticGeneration = entry.generation;
+    }
+    entry.info = item.second;
+  }
+}
+
+TransceiverInfoDelta TransceiverInfoTracker::getDelta(
+    int64_t sinceGeneration) const {
+  auto state = state_.rlock();
+  if (sinceGeneration > state->generation) {
+    sinceGeneration = 0;
+  }
+
+  TransceiverInfoDelta delta;
+  delta.generation = state->generation;
+  for (const auto& item : state->entries) {
+    const auto& entry = item.second;
+    if (entry.staticGeneration > sinceGeneration) {
+      delta.changed[item.first] = entry.info;
+    } else if (entry.generation > sinceGeneration) {
+      delta.sensorUpdates[item.first] =
+          transceiver_info_delta::getSensorFields(entry.info);
+    }
+  }
+  return delta;
+}
+
+}} // facebook::fboss
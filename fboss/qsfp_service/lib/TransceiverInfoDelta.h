@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <map>
+
+#include <folly/Synchronized.h>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+/*
+ * Helpers to exchange TransceiverInfo as deltas between qsfp_service and
+ * its clients.
+ *
+ * Most of a TransceiverInfo (vendor, cable, thresholds, settings) only
+ * changes when a module is swapped, while sensor readings change all the
+ * time. qsfp_service stamps every transceiver with the generation of its
+ * last change and clients ask for changes after the last generation they
+ * saw. Transceivers with static changes are sent in full, the others only
+ * with their sensor data.
+ */
+
+namespace facebook { namespace fboss {
+
+namespace transceiver_info_delta {
+
+// Whether everything but the sensor data is the same
+bool staticFieldsEqual(const TransceiverInfo& a, const TransceiverInfo& b);
+
+// Copy of info with only sensor, channels and stats set
+TransceiverInfo getSensorFields(const TransceiverInfo& info);
+
+// Overwrite the sensor data in cached with the one in update
+void mergeSensorFields(TransceiverInfo& cached, const TransceiverInfo& update);
+
+} // namespace transceiver_info_delta
+
+/*
+ * Server side of the exchange: remembers the last TransceiverInfo of every
+ * transceiver and when its static fields and its sensor data last changed.
+ */
+class TransceiverInfoTracker {
+ public:
+  TransceiverInfoTracker();
+
+  // Record the current info of transceivers, bumping generations of changes
+  void update(const std::map<int32_t, TransceiverInfo>& infos);
+
+  /*
+   * Transceivers that changed after sinceGeneration. A generation that is
+   * not from this tracker (e.g. from before a restart) gets everything.
+   */
+  TransceiverInfoDelta getDelta(int64_t sinceGeneration) const;
+
+ private:
+  struct Entry {
+    TransceiverInfo info;
+    int64_t staticGeneration{0};
+    int64_t generation{0};
+  };
+  struct State {
+    int64_t generation{0};
+    std::map<int32_t, Entry> entries;
+  };
+
+  // Forbidden copy constructor and assignment operator
+  TransceiverInfoTracker(TransceiverInfoTracker const &) = delete;
+  TransceiverInfoTracker& operator=(TransceiverInfoTracker const &) = delete;
+
+  folly::Synchronized<State> state_;
+};
+
+}} // facebook::fboss
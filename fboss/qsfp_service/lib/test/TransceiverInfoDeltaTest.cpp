@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/lib/TransceiverInfoDelta.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+TransceiverInfo makeInfo(int32_t port, const std::string& vendor, double temp) {
+  TransceiverInfo info;
+  info.present = true;
+  info.port = port;
+  Vendor vendorInfo;
+  vendorInfo.name = vendor;
+  info.vendor_ref() = vendorInfo;
+  GlobalSensors sensor;
+  sensor.temp.value = temp;
+  info.sensor_ref() = sensor;
+  Channel channel;
+  channel.channel = 0;
+  channel.sensors.rxPwr.value = temp / 10;
+  info.channels.push_back(channel);
+  return info;
+}
+} // namespace
+
+TEST(TransceiverInfoDelta, StaticFields) {
+  auto a = makeInfo(1, "vendorA", 30);
+  EXPECT_TRUE(transceiver_info_delta::staticFieldsEqual(
+      a, makeInfo(1, "vendorA", 40)));
+  EXPECT_FALSE(transceiver_info_delta::staticFieldsEqual(
+      a, makeInfo(1, "vendorB", 30)));
+
+  auto sensorFields = transceiver_info_delta::getSensorFields(a);
+  EXPECT_FALSE(sensorFields.vendor_ref());
+  EXPECT_EQ(30, sensorFields.sensor_ref()->temp.value);
+
+  auto cached = makeInfo(1, "vendorA", 20);
+  transceiver_info_delta::mergeSensorFields(cached, sensorFields);
+  EXPECT_EQ(a, cached);
+}
+
+TEST(TransceiverInfoDelta, Tracker) {
+  TransceiverInfoTracker tracker;
+  std::map<int32_t, TransceiverInfo> infos;
+  infos[0] = makeInfo(1, "vendorA", 30);
+  infos[1] = makeInfo(2, "vendorA", 30);
+  tracker.update(infos);
+
+  // Everything is new
+  auto full = tracker.getDelta(0);
+  EXPECT_EQ(2, full.changed.size());
+  EXPECT_TRUE(full.sensorUpdates.empty());
+
+  // Nothing changed
+  tracker.update(infos);
+  auto none = tracker.getDelta(full.generation);
+  EXPECT_EQ(full.generation, none.generation);
+  EXPECT_TRUE(none.changed.empty());
+  EXPECT_TRUE(none.sensorUpdates.empty());
+
+  // Sensor change on one, module swap on the other
+  infos[0] = makeInfo(1, "vendorA", 35);
+  infos[1] = makeInfo(2, "vendorB", 30);
+  tracker.update(infos);
+  auto delta = tracker.getDelta(full.generation);
+  EXPECT_LT(full.generation, delta.generation);
+  ASSERT_EQ(1, delta.changed.size());
+  EXPECT_EQ(infos[1], delta.changed[1]);
+  ASSERT_EQ(1, delta.sensorUpdates.size());
+  EXPECT_FALSE(delta.sensorUpdates[0].vendor_ref());
+  EXPECT_EQ(35, delta.sensorUpdates[0].sensor_ref()->temp.value);
+
+  // A generation this tracker never handed out gets everything
+  auto unknown = tracker.getDelta(delta.generation + 1000);
+  EXPECT_EQ(2, unknown.changed.size());
+}
+
+TEST(TransceiverInfoDelta, GenerationsIncreaseAcrossInstances) {
+  std::map<int32_t, TransceiverInfo> infos;
+  infos[0] = makeInfo(1, "vendorA", 30);
+
+  int64_t oldGeneration;
+  {
+    TransceiverInfoTracker tracker;
+    tracker.update(infos);
+    oldGeneration = tracker.getDelta(0).generation;
+  }
+  // A restarted qsfp_service sends everything to a client that still holds
+  // a generation from before the restart
+  TransceiverInfoTracker tracker;
+  tracker.update(infos);
+  EXPECT_EQ(1, tracker.getDelta(oldGeneration).changed.size());
+}
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/module/EepromPageCache.h"
+
+#include "fboss/agent/Utils.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/hash/Checksum.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <cctype>
+#include <cstring>
+
+DEFINE_string(
+    qsfp_eeprom_cache_dir,
+    "/var/facebook/fboss/qsfp_eeprom_cache",
+    "Directory to cache static transceiver EEPROM pages in across restarts, "
+    "empty disables the cache");
+
+namespace {
+// Each entry is the concatenated pages followed by this trailer
+struct EntryTrailer {
+  uint32_t magic;
+  uint32_t length;
+  uint32_t checksum;
+};
+constexpr uint32_t kEntryMagic = 0x45455043; // "EEPC"
+
+// Keep the alphanumerics of an ASCII field padded with spaces, so it can be
+// part of a file name
+std::string toFileNamePart(folly::ByteRange field) {
+  std::string part;
+  for (auto c : field) {
+    if (std::isalnum(c)) {
+      part.push_back(c);
+    } else if (c != ' ' && c != '\0') {
+      part.push_back('_');
+    }
+  }
+  return part;
+}
+} // namespace
+
+namespace facebook { namespace fboss {
+
+EepromPageCache::EepromPageCache(std::string dir) : dir_(std::move(dir)) {
+  utilCreateDir(dir_);
+}
+
+const EepromPageCache* EepromPageCache::get() {
+  static const EepromPageCache* cache = []() -> const EepromPageCache* {
+    if (FLAGS_qsfp_eeprom_cache_dir.empty()) {
+      return nullptr;
+    }
+    try {
+      return new EepromPageCache(FLAGS_qsfp_eeprom_cache_dir);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Disabling EEPROM cache: " << ex.what();
+      return nullptr;
+    }
+  }();
+  return cache;
+}
+
+std::string EepromPageCache::getPath(const ModuleId& id) const {
+  auto serial = toFileNamePart(id.serialNumber);
+  if (serial.empty()) {
+    return "";
+  }
+  return folly::to<std::string>(
+      dir_,
+      "/",
+      static_cast<int>(id.identifier),
+      "-",
+      folly::hexlify(id.vendorOui),
+      "-",
+      toFileNamePart(id.partNumber),
+      "-",
+      serial);
+}
+
+bool EepromPageCache::load(
+    const ModuleId& id,
+    const std::vector<folly::MutableByteRange>& pages) const {
+  auto path = getPath(id);
+  std::string entry;
+  if (path.empty() || !folly::readFile(path.c_str(), entry)) {
+    return false;
+  }
+  size_t length = 0;
+  for (const auto& page : pages) {
+    length += page.size();
+  }
+  EntryTrailer trailer;
+  if (entry.size() != length + sizeof(trailer)) {
+    XLOG(WARN) << "Ignoring EEPROM cache entry " << path << " of wrong size";
+    return false;
+  }
+  std::memcpy(&trailer, entry.data() + length, sizeof(trailer));
+  auto data = reinterpret_cast<const uint8_t*>(entry.data());
+  if (trailer.magic != kEntryMagic || trailer.length != length ||
+      trailer.checksum != folly::crc32c(data, length)) {
+    XLOG(WARN) << "Ignoring corrupted EEPROM cache entry " << path;
+    return false;
+  }
+  for (const auto& page : pages) {
+    std::memcpy(page.data(), data, page.size());
+    data += page.size();
+  }
+  return true;
+}
+
+void EepromPageCache::store(
+    const ModuleId& id,
+    const std::vector<folly::ByteRange>& pages) const {
+  auto path = getPath(id);
+  if (path.empty()) {
+    return;
+  }
+  std::string entry;
+  for (const auto& page : pages) {
+    entry.append(reinterpret_cast<const char*>(page.data()), page.size());
+  }
+  EntryTrailer trailer{
+      kEntryMagic,
+      static_cast<uint32_t>(entry.size()),
+      folly::crc32c(
+          reinterpret_cast<const uint8_t*>(entry.data()), entry.size())};
+  entry.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  try {
+    folly::writeFileAtomic(path, entry);
+  } catch (const std::exception& ex) {
+    // The cache is only an optimization
+    XLOG(ERR) << "Failed to write EEPROM cache entry " << path << ": "
+              << ex.what();
+  }
+}
+
+}} // namespace facebook::fboss
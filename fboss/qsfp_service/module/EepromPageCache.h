@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace facebook { namespace fboss {
+
+/*
+ * On-disk cache of the static EEPROM pages of QSFP modules (vendor info,
+ * compliance codes, thresholds), so that a restarted qsfp_service does not
+ * have to read them over I2C again.
+ *
+ * Entries are keyed by the module identifier, vendor OUI, part number and
+ * serial number, which is all a module needs to read to find its entry. Each
+ * entry is checksummed, and entries that don't match in identity, size or
+ * checksum are treated as missing. Only pages that the agent never writes
+ * to should be cached.
+ */
+class EepromPageCache {
+ public:
+  /*
+   * What identifies a module, as read from its EEPROM. Part and serial
+   * numbers are ASCII padded with spaces.
+   */
+  struct ModuleId {
+    uint8_t identifier{0};
+    folly::ByteRange vendorOui;
+    folly::ByteRange partNumber;
+    folly::ByteRange serialNumber;
+  };
+
+  // Throws if dir can't be created
+  explicit EepromPageCache(std::string dir);
+
+  /*
+   * Returns the cache in FLAGS_qsfp_eeprom_cache_dir, or nullptr if caching
+   * is disabled.
+   */
+  static const EepromPageCache* get();
+
+  /*
+   * Fills pages with the cached pages of the module, and returns true, if
+   * there is a valid entry for it.
+   */
+  bool load(
+      const ModuleId& id,
+      const std::vector<folly::MutableByteRange>& pages) const;
+
+  void store(const ModuleId& id, const std::vector<folly::ByteRange>& pages)
+      const;
+
+ private:
+  /*
+   * Path of the entry of the module, or an empty string if the module has no
+   * usable serial number.
+   */
+  std::string getPath(const ModuleId& id) const;
+
+  std::string dir_;
+};
+
+}} // namespace facebook::fboss
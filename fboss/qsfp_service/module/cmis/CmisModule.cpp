@@ -9,6 +9,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/lib/usb/TransceiverI2CApi.h"
 #include "fboss/qsfp_service/StatsPublisher.h"
+#include "fboss/qsfp_service/module/EepromPageCache.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 #include "fboss/qsfp_service/module/cmis/CmisFieldInfo.h"
 
@@ -692,24 +693,43 @@ void CmisModule::updateQsfpData(bool allPages) {
       return;
     }
 
+    // The vendor OUI (145-147), part number (148-163) and serial number
+    // (166-181) in page 0 identify the module in the EEPROM cache. Page 0x13
+    // holds diagnostics controls we write to, so it is not cached.
+    auto cache = EepromPageCache::get();
+    EepromPageCache::ModuleId id{lowerPage_[0],
+                                 {page0_ + 145 - 128, 3},
+                                 {page0_ + 148 - 128, 16},
+                                 {page0_ + 166 - 128, 16}};
+    std::vector<folly::MutableByteRange> pages;
     if (!flatMem_) {
-      uint8_t page = 0x01;
+      pages = {{page01_, sizeof(page01_)}, {page02_, sizeof(page02_)}};
+      uint8_t page = 0x13;
       qsfpImpl_->writeTransceiver(
           TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
       qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page01_), page01_);
+          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page13_), page13_);
+    }
+    if (cache && !pages.empty() && cache->load(id, pages)) {
+      return;
+    }
 
-      page = 0x02;
+    if (!flatMem_) {
+      uint8_t page = 0x01;
       qsfpImpl_->writeTransceiver(
           TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
       qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page02_), page02_);
+          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page01_), page01_);
 
-      page = 0x13;
+      page = 0x02;
       qsfpImpl_->writeTransceiver(
           TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
       qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page13_), page13_);
+          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page02_), page02_);
+    }
+    if (cache && !pages.empty()) {
+      cache->store(
+          id, std::vector<folly::ByteRange>(pages.begin(), pages.end()));
     }
   } catch (const std::exception& ex) {
     // No matter what kind of exception throws, we need to set the dirty_ flag
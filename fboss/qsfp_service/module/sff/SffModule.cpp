@@ -9,6 +9,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/lib/usb/TransceiverI2CApi.h"
 #include "fboss/qsfp_service/StatsPublisher.h"
+#include "fboss/qsfp_service/module/EepromPageCache.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 #include "fboss/qsfp_service/module/sff/SffFieldInfo.h"
 
@@ -649,6 +650,40 @@ void SffModule::updateQsfpData(bool allPages) {
       qsfpImpl_->writeTransceiver(
           TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
     }
+
+    // Page 0 and page 3 are static, so look them up in the EEPROM cache by
+    // the vendor OUI (165-167), part number (168-183) and serial number
+    // (196-211) of the module before reading them in full.
+    auto cache = EepromPageCache::get();
+    uint8_t vendorInfo[212 - 165];
+    EepromPageCache::ModuleId id{lowerPage_[0],
+                                 {vendorInfo, 3},
+                                 {vendorInfo + 168 - 165, 16},
+                                 {vendorInfo + 196 - 165, 16}};
+    std::vector<folly::MutableByteRange> pages{{page0_, sizeof(page0_)}};
+    if (!flatMem_) {
+      pages.emplace_back(page3_, sizeof(page3_));
+    }
+    if (cache) {
+      qsfpImpl_->readTransceiver(
+          TransceiverI2CApi::ADDR_QSFP, 165, sizeof(vendorInfo), vendorInfo);
+      if (cache->load(id, pages)) {
+        if (!flatMem_) {
+          // Bytes 226-255 of page 3 are channel controls and masks we write
+          // to, so they are read from the module rather than the cache
+          uint8_t page = 3;
+          qsfpImpl_->writeTransceiver(
+              TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+          qsfpImpl_->readTransceiver(
+              TransceiverI2CApi::ADDR_QSFP,
+              226,
+              256 - 226,
+              page3_ + 226 - 128);
+        }
+        return;
+      }
+    }
+
     qsfpImpl_->readTransceiver(
         TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page0_), page0_);
     if (!flatMem_) {
@@ -658,6 +693,10 @@ void SffModule::updateQsfpData(bool allPages) {
       qsfpImpl_->readTransceiver(
           TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page3_), page3_);
     }
+    if (cache) {
+      cache->store(
+          id, std::vector<folly::ByteRange>(pages.begin(), pages.end()));
+    }
   } catch (const std::exception& ex) {
     // No matter what kind of exception throws, we need to set the dirty_ flag
     // to true.
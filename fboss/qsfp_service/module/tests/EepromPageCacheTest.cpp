@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/module/EepromPageCache.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace facebook { namespace fboss {
+
+namespace {
+const std::string kOui = std::string("\x00\x90\x65", 3);
+const std::string kPartNumber = "FTL410QE2C      ";
+const std::string kSerial = "ABC123          ";
+
+EepromPageCache::ModuleId moduleId(
+    uint8_t identifier = 0x11,
+    const std::string& serial = kSerial,
+    const std::string& partNumber = kPartNumber,
+    const std::string& oui = kOui) {
+  return EepromPageCache::ModuleId{identifier,
+                                   folly::StringPiece(oui),
+                                   folly::StringPiece(partNumber),
+                                   folly::StringPiece(serial)};
+}
+} // namespace
+
+TEST(EepromPageCacheTest, storeAndLoad) {
+  folly::test::TemporaryDirectory tmpDir;
+  EepromPageCache cache(tmpDir.path().string());
+
+  std::array<uint8_t, 128> page0, page3;
+  page0.fill(0x11);
+  page3.fill(0x33);
+  cache.store(
+      moduleId(), {{page0.data(), page0.size()}, {page3.data(), 128}});
+
+  std::array<uint8_t, 128> read0{}, read3{};
+  std::vector<folly::MutableByteRange> pages{{read0.data(), read0.size()},
+                                             {read3.data(), read3.size()}};
+  EXPECT_TRUE(cache.load(moduleId(), pages));
+  EXPECT_EQ(read0, page0);
+  EXPECT_EQ(read3, page3);
+
+  // Another module, or the same serial with another identifier, part number
+  // or vendor, misses
+  EXPECT_FALSE(cache.load(moduleId(0x11, "XYZ789          "), pages));
+  EXPECT_FALSE(cache.load(moduleId(0x0d), pages));
+  EXPECT_FALSE(
+      cache.load(moduleId(0x11, kSerial, "FTL410QE3C      "), pages));
+  EXPECT_FALSE(cache.load(
+      moduleId(0x11, kSerial, kPartNumber, std::string("\x00\x17\x6a", 3)),
+      pages));
+  // So does a module with a different page layout
+  EXPECT_FALSE(cache.load(moduleId(), {{read0.data(), read0.size()}}));
+}
+
+TEST(EepromPageCacheTest, corruptedEntry) {
+  folly::test::TemporaryDirectory tmpDir;
+  EepromPageCache cache(tmpDir.path().string());
+
+  std::array<uint8_t, 128> page0;
+  page0.fill(0x11);
+  cache.store(moduleId(), {{page0.data(), page0.size()}});
+
+  auto path = tmpDir.path().string() + "/17-009065-FTL410QE2C-ABC123";
+  std::string entry;
+  ASSERT_TRUE(folly::readFile(path.c_str(), entry));
+  entry[5] ^= 0xff;
+  folly::writeFileAtomic(path, entry);
+
+  std::array<uint8_t, 128> read0{};
+  EXPECT_FALSE(cache.load(moduleId(), {{read0.data(), read0.size()}}));
+}
+
+TEST(EepromPageCacheTest, blankSerial) {
+  folly::test::TemporaryDirectory tmpDir;
+  EepromPageCache cache(tmpDir.path().string());
+
+  // Modules without a serial number can't be told apart, so aren't cached
+  std::string blank(16, ' ');
+  std::array<uint8_t, 128> page0;
+  page0.fill(0x11);
+  cache.store(moduleId(0x11, blank), {{page0.data(), page0.size()}});
+  EXPECT_FALSE(
+      cache.load(moduleId(0x11, blank), {{page0.data(), page0.size()}}));
+}
+
+}} // namespace facebook::fboss
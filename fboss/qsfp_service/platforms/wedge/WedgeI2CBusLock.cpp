@@ -10,6 +10,8 @@
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 #include "fboss/lib/usb/UsbError.h"
 
+#include <folly/ScopeGuard.h>
+
 #include "fboss/qsfp_service/StatsPublisher.h"
 
 using folly::MutableByteRange;
@@ -58,6 +60,37 @@ void WedgeI2CBusLock::moduleWrite(unsigned int module, uint8_t address,
   wedgeI2CBus_->moduleWrite(module, address, offset, len, buf);
 }
 
+void WedgeI2CBusLock::moduleReadBatch(std::vector<TransceiverI2CRead>& reads) {
+  BusGuard g(this);
+  wedgeI2CBus_->moduleReadBatch(reads);
+}
+
+void WedgeI2CBusLock::beginModuleSweep() {
+  lock_guard<std::mutex> g(busMutex_);
+  if (!opened_) {
+    openLocked();
+    sweepOpened_ = true;
+  }
+  wedgeI2CBus_->beginModuleSweep();
+}
+
+void WedgeI2CBusLock::endModuleSweep() {
+  lock_guard<std::mutex> g(busMutex_);
+  SCOPE_EXIT {
+    if (sweepOpened_) {
+      sweepOpened_ = false;
+      closeLocked();
+    }
+  };
+  wedgeI2CBus_->endModuleSweep();
+}
+
+uint64_t WedgeI2CBusLock::getMuxPathKey(unsigned int module) {
+  // No need to open the bus, the key only depends on the topology
+  lock_guard<std::mutex> g(busMutex_);
+  return wedgeI2CBus_->getMuxPathKey(module);
+}
+
 void WedgeI2CBusLock::read(uint8_t address, int offset,
                            int len, uint8_t *buf) {
   BusGuard g(this);
@@ -29,6 +29,15 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
                   int offset, int len, uint8_t* buf) override;
   void moduleWrite(unsigned int module, uint8_t i2cAddress,
                   int offset, int len, const uint8_t* buf) override;
+  void moduleReadBatch(std::vector<TransceiverI2CRead>& reads) override;
+  uint64_t getMuxPathKey(unsigned int module) override;
+  /*
+   * Keeps the bus open until endModuleSweep(), so that the mux selection
+   * survives between the accesses of the sweep. The lock is still only held
+   * for each access.
+   */
+  void beginModuleSweep() override;
+  void endModuleSweep() override;
   void read(uint8_t i2cAddress, int offset, int len, uint8_t* buf);
   void write(uint8_t i2cAddress, int offset, int len, const uint8_t* buf);
 
@@ -57,6 +66,7 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
   std::unique_ptr<BaseWedgeI2CBus> wedgeI2CBus_{nullptr};
   mutable std::mutex busMutex_;
   bool opened_{false};
+  bool sweepOpened_{false};
 
   class BusGuard {
     /* This class is a simple guard that:
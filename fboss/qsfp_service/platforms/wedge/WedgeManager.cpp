@@ -2,6 +2,8 @@
 
 #include <folly/gen/Base.h>
 
+#include <algorithm>
+
 #include <folly/logging/xlog.h>
 #include <fb303/ThreadCachedServiceData.h>
 #include "fboss/qsfp_service/module/sff/SffModule.h"
@@ -48,9 +50,24 @@ void WedgeManager::initTransceiverMap() {
     XLOG(INFO) << "making QSFP for " << idx;
   }
 
+  computeRefreshOrder();
   refreshTransceivers();
 }
 
+void WedgeManager::computeRefreshOrder() {
+  // The keys only depend on the mux topology, the bus is not accessed
+  std::vector<std::pair<uint64_t, size_t>> keys;
+  for (size_t idx = 0; idx < transceivers_.size(); ++idx) {
+    keys.emplace_back(wedgeI2cBus_->getMuxPathKey(idx + 1), idx);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  refreshOrder_.clear();
+  for (const auto& key : keys) {
+    refreshOrder_.push_back(key.second);
+  }
+}
+
 void WedgeManager::getTransceiversInfo(std::map<int32_t, TransceiverInfo>& info,
     std::unique_ptr<std::vector<int32_t>> ids) {
   XLOG(INFO) << "Received request for getTransceiverInfo, with ids: "
@@ -140,12 +157,21 @@ void WedgeManager::refreshTransceivers() {
   std::vector<folly::Future<folly::Unit>> futs;
   XLOG(INFO) << "Start refreshing all transceivers...";
 
-  for (const auto& transceiver : transceivers_) {
+  // Modules are refreshed in mux path order, keep the last one selected so
+  // that moving on to the next module only switches the muxes that differ
+  wedgeI2cBus_->beginModuleSweep();
+  for (auto idx : refreshOrder_) {
+    const auto& transceiver = transceivers_[idx];
     XLOG(DBG3) << "Fired to refresh transceiver " << transceiver->getID();
     futs.push_back(transceiver->futureRefresh());
   }
 
   folly::collectAllUnsafe(futs.begin(), futs.end()).wait();
+  try {
+    wedgeI2cBus_->endModuleSweep();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Error ending the module sweep: " << ex.what();
+  }
   XLOG(INFO) << "Finished refreshing all transceivers";
 }
 
@@ -218,6 +244,18 @@ void WedgeManager::publishI2cTransactionStats() {
     statName =
       folly::to<std::string>("qsfp.", counter.controllerName_, ".writeBytes");
     tcData().setCounter(statName, counter.writeBytes_);
+
+    statName =
+      folly::to<std::string>("qsfp.", counter.controllerName_, ".muxSwitches");
+    tcData().setCounter(statName, counter.muxSwitches_);
+
+    statName =
+      folly::to<std::string>("qsfp.", counter.controllerName_, ".busyUsec");
+    tcData().setCounter(statName, counter.busyUsec_);
+
+    statName =
+      folly::to<std::string>("qsfp.", counter.controllerName_, ".readsMerged");
+    tcData().setCounter(statName, counter.readsMerged_);
   }
 }
 
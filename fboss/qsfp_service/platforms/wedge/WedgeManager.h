@@ -74,6 +74,16 @@ class WedgeManager : public TransceiverManager {
   PortGroups portGroupMap_;
 
  private:
+  /*
+   * Sort transceivers by the mux path in front of them. Buses without
+   * their own event base refresh the transceivers one after the other, and
+   * going through them in mux order saves mux switches.
+   */
+  void computeRefreshOrder();
+
+  // Indexes into transceivers_, in the order to refresh them
+  std::vector<size_t> refreshOrder_;
+
   // Forbidden copy constructor and assignment operator
   WedgeManager(WedgeManager const &) = delete;
   WedgeManager& operator=(WedgeManager const &) = delete;
@@ -0,0 +1,392 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Route churn load generator.
+ *
+ * Programs one of the route scale distributions over thrift, then replays a
+ * churn pattern against it, timing every addUnicastRoutes,
+ * deleteUnicastRoutes and syncFib call. Those calls return once the routes
+ * are programmed, so their latency is the end to end programming latency.
+ *
+ * The routes point at next hops in the subnets of the agent's interfaces,
+ * which are read from the agent, so the tool works against any agent,
+ * including one running on the fake SAI or the mock HwSwitch.
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/RouteUpdater.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/RouteDistributionGenerator.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/AsyncSocket.h>
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace facebook::fboss;
+using facebook::network::toBinaryAddress;
+using std::chrono::steady_clock;
+using utility::RouteDistributionGenerator;
+
+DEFINE_string(agent_host, "::1", "Host running the agent");
+DEFINE_int32(agent_port, 5909, "Thrift port of the agent");
+DEFINE_int32(agent_recv_timeout_ms, 120000, "Receive timeout for thrift calls");
+DEFINE_int32(
+    agent_pid,
+    0,
+    "Pid of the agent, if it runs on this host, to report its CPU usage");
+DEFINE_int32(client_id, 1001, "Client ID to program routes as");
+DEFINE_string(
+    route_scale,
+    "rsw",
+    "Route distribution to program: rsw, fsw, th_alpm, hgrid_du or hgrid_uu");
+DEFINE_int32(chunk_size, 1000, "Number of routes per thrift call");
+DEFINE_int32(ecmp_width, 4, "Number of next hops of each route");
+DEFINE_string(
+    pattern,
+    "flap",
+    "Churn to replay after programming the routes: "
+    "flap (delete and add back every chunk), "
+    "withdraw_all (withdraw all routes with syncFib, then add them back), "
+    "ecmp_width (alternate routes between ecmp_width and half as many "
+    "next hops), "
+    "sync_fib (sync the full set of routes again)");
+DEFINE_int32(iterations, 10, "Number of times to replay the churn pattern");
+DEFINE_double(
+    calls_per_sec,
+    0,
+    "Max rate of route programming calls, 0 for as fast as possible");
+DEFINE_bool(cleanup, true, "Withdraw all routes of client_id when done");
+
+namespace {
+
+using UnicastRoutes = std::vector<UnicastRoute>;
+using Latencies = std::vector<std::chrono::microseconds>;
+
+std::unique_ptr<FbossCtrlAsyncClient> createClient(folly::EventBase* evb) {
+  folly::SocketAddress addr(FLAGS_agent_host, FLAGS_agent_port);
+  auto socket = folly::AsyncSocket::newSocket(evb, addr, 2000);
+  auto channel = apache::thrift::HeaderClientChannel::newChannel(socket);
+  channel->setTimeout(FLAGS_agent_recv_timeout_ms);
+  return std::make_unique<FbossCtrlAsyncClient>(std::move(channel));
+}
+
+/*
+ * Switch state with just the ports, vlans and interfaces of the agent,
+ * which is all route generators need to pick prefixes and next hops.
+ */
+std::shared_ptr<SwitchState> getStartingState(FbossCtrlAsyncClient* client) {
+  auto state = std::make_shared<SwitchState>();
+
+  std::map<int32_t, InterfaceDetail> intfs;
+  client->sync_getAllInterfaces(intfs);
+  std::map<int32_t, PortInfoThrift> ports;
+  client->sync_getAllPortInfo(ports);
+
+  for (const auto& [intfId, intf] : intfs) {
+    if (!state->getVlans()->getVlanIf(VlanID(intf.vlanId))) {
+      state->addVlan(std::make_shared<Vlan>(
+          VlanID(intf.vlanId), folly::to<std::string>("vlan", intf.vlanId)));
+    }
+  }
+  for (const auto& [portId, portInfo] : ports) {
+    state->registerPort(PortID(portId), portInfo.name);
+    auto port = state->getPorts()->getPortIf(PortID(portId));
+    for (auto vlanId : portInfo.vlans) {
+      auto vlan = state->getVlans()->getVlanIf(VlanID(vlanId));
+      if (vlan) {
+        vlan->addPort(PortID(portId), false);
+        port->addVlan(VlanID(vlanId), false);
+      }
+    }
+  }
+  for (const auto& [intfId, intf] : intfs) {
+    auto interface = std::make_shared<Interface>(
+        InterfaceID(intf.interfaceId),
+        RouterID(intf.routerId),
+        VlanID(intf.vlanId),
+        intf.interfaceName,
+        folly::MacAddress(intf.mac),
+        intf.mtu,
+        false, /* is virtual */
+        false /* is state_sync disabled */);
+    Interface::Addresses addrs;
+    for (const auto& prefix : intf.address) {
+      addrs.emplace(
+          facebook::network::toIPAddress(prefix.ip), prefix.prefixLength);
+    }
+    interface->setAddresses(addrs);
+    state->addIntf(interface);
+    state->getVlans()
+        ->getVlan(VlanID(intf.vlanId))
+        ->setInterfaceID(InterfaceID(intf.interfaceId));
+  }
+
+  RouteUpdater updater(state->getRouteTables());
+  updater.addInterfaceAndLinkLocalRoutes(state->getInterfaces());
+  auto routeTables = updater.updateDone();
+  if (routeTables) {
+    state->resetRouteTables(routeTables);
+  }
+  state->publish();
+  return state;
+}
+
+std::unique_ptr<RouteDistributionGenerator> getGenerator(
+    const std::shared_ptr<SwitchState>& state) {
+  if (FLAGS_route_scale == "rsw") {
+    return std::make_unique<utility::RSWRouteScaleGenerator>(
+        state, FLAGS_chunk_size, FLAGS_ecmp_width);
+  } else if (FLAGS_route_scale == "fsw") {
+    return std::make_unique<utility::FSWRouteScaleGenerator>(
+        state, FLAGS_chunk_size, FLAGS_ecmp_width);
+  } else if (FLAGS_route_scale == "th_alpm") {
+    return std::make_unique<utility::THAlpmRouteScaleGenerator>(
+        state, FLAGS_chunk_size, FLAGS_ecmp_width);
+  } else if (FLAGS_route_scale == "hgrid_du") {
+    return std::make_unique<utility::HgridDuRouteScaleGenerator>(
+        state, FLAGS_chunk_size, FLAGS_ecmp_width);
+  } else if (FLAGS_route_scale == "hgrid_uu") {
+    return std::make_unique<utility::HgridUuRouteScaleGenerator>(
+        state, FLAGS_chunk_size, FLAGS_ecmp_width);
+  }
+  throw FbossError("Unknown route scale: ", FLAGS_route_scale);
+}
+
+/*
+ * Thrift routes for a chunk, using only the first maxNhops next hops
+ */
+UnicastRoutes toUnicastRoutes(
+    const RouteDistributionGenerator::RouteChunk& chunk,
+    size_t maxNhops) {
+  UnicastRoutes routes;
+  routes.reserve(chunk.size());
+  for (const auto& route : chunk) {
+    UnicastRoute unicastRoute;
+    unicastRoute.dest.ip = toBinaryAddress(route.prefix.first);
+    unicastRoute.dest.prefixLength = route.prefix.second;
+    auto numNhops = std::min(maxNhops, route.nhops.size());
+    for (size_t i = 0; i < numNhops; ++i) {
+      unicastRoute.nextHopAddrs.push_back(toBinaryAddress(route.nhops[i]));
+    }
+    routes.push_back(std::move(unicastRoute));
+  }
+  return routes;
+}
+
+std::vector<IpPrefix> toPrefixes(const UnicastRoutes& routes) {
+  std::vector<IpPrefix> prefixes;
+  prefixes.reserve(routes.size());
+  for (const auto& route : routes) {
+    prefixes.push_back(route.dest);
+  }
+  return prefixes;
+}
+
+/*
+ * User plus system CPU time of a process, from /proc
+ */
+std::chrono::milliseconds getCpuTime(int pid) {
+  std::string stat;
+  if (!folly::readFile(
+          folly::to<std::string>("/proc/", pid, "/stat").c_str(), stat)) {
+    throw FbossError("Unable to read stats of process ", pid);
+  }
+  // Skip past the process name, which may contain spaces
+  auto fields = stat.substr(stat.rfind(')') + 2);
+  std::vector<folly::StringPiece> values;
+  folly::split(' ', fields, values);
+  // utime and stime are fields 14 and 15, we skipped the first two
+  auto ticks =
+      folly::to<uint64_t>(values[11]) + folly::to<uint64_t>(values[12]);
+  return std::chrono::milliseconds(ticks * 1000 / sysconf(_SC_CLK_TCK));
+}
+
+class RouteChurn {
+ public:
+  explicit RouteChurn(FbossCtrlAsyncClient* client) : client_(client) {}
+
+  void addRoutes(const UnicastRoutes& routes) {
+    timeCall("addUnicastRoutes", routes.size(), [&]() {
+      client_->sync_addUnicastRoutes(FLAGS_client_id, routes);
+    });
+  }
+
+  void deleteRoutes(const UnicastRoutes& routes) {
+    auto prefixes = toPrefixes(routes);
+    timeCall("deleteUnicastRoutes", routes.size(), [&]() {
+      client_->sync_deleteUnicastRoutes(FLAGS_client_id, prefixes);
+    });
+  }
+
+  void syncFib(const UnicastRoutes& routes) {
+    timeCall("syncFib", routes.size(), [&]() {
+      client_->sync_syncFib(FLAGS_client_id, routes);
+    });
+  }
+
+  void printReport(std::chrono::milliseconds elapsed) const {
+    auto percentile = [](const Latencies& latencies, double pct) {
+      auto idx = std::min(
+          latencies.size() - 1,
+          static_cast<size_t>(pct / 100 * latencies.size()));
+      return latencies[idx].count();
+    };
+    for (auto [call, latencies] : latencies_) {
+      std::sort(latencies.begin(), latencies.end());
+      auto routesPerSec =
+          numRoutes_.at(call) * 1000000 / std::max<int64_t>(1, total(call));
+      printf(
+          "%-20s calls %6zu  routes/s %8ld  latency us p50 %8ld p90 %8ld "
+          "p99 %8ld max %8ld\n",
+          call.c_str(),
+          latencies.size(),
+          routesPerSec,
+          percentile(latencies, 50),
+          percentile(latencies, 90),
+          percentile(latencies, 99),
+          latencies.back().count());
+    }
+    printf("elapsed %ld ms\n", elapsed.count());
+  }
+
+ private:
+  template <typename Fn>
+  void timeCall(const std::string& call, size_t numRoutes, Fn&& fn) {
+    if (FLAGS_calls_per_sec > 0) {
+      auto interval = std::chrono::duration_cast<steady_clock::duration>(
+          std::chrono::duration<double>(1 / FLAGS_calls_per_sec));
+      std::this_thread::sleep_until(lastCall_ + interval);
+    }
+    lastCall_ = steady_clock::now();
+    fn();
+    latencies_[call].push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock::now() - lastCall_));
+    numRoutes_[call] += numRoutes;
+  }
+
+  int64_t total(const std::string& call) const {
+    int64_t sum = 0;
+    for (const auto& latency : latencies_.at(call)) {
+      sum += latency.count();
+    }
+    return sum;
+  }
+
+  FbossCtrlAsyncClient* client_;
+  std::map<std::string, Latencies> latencies_;
+  std::map<std::string, int64_t> numRoutes_;
+  steady_clock::time_point lastCall_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  folly::EventBase evb;
+  auto client = createClient(&evb);
+
+  auto generator = getGenerator(getStartingState(client.get()));
+  std::vector<UnicastRoutes> chunks;
+  std::vector<UnicastRoutes> narrowChunks;
+  UnicastRoutes allRoutes;
+  for (const auto& chunk : generator->get()) {
+    chunks.push_back(toUnicastRoutes(chunk, FLAGS_ecmp_width));
+    narrowChunks.push_back(
+        toUnicastRoutes(chunk, std::max(1, FLAGS_ecmp_width / 2)));
+    allRoutes.insert(
+        allRoutes.end(), chunks.back().begin(), chunks.back().end());
+  }
+  LOG(INFO) << "Generated " << allRoutes.size() << " routes in "
+            << chunks.size() << " chunks";
+
+  // Initial programming is reported on its own
+  RouteChurn setup(client.get());
+  auto setupStart = steady_clock::now();
+  for (const auto& chunk : chunks) {
+    setup.addRoutes(chunk);
+  }
+  printf("initial programming:\n");
+  setup.printReport(std::chrono::duration_cast<std::chrono::milliseconds>(
+      steady_clock::now() - setupStart));
+
+  RouteChurn churn(client.get());
+
+  std::chrono::milliseconds cpuStart{0};
+  if (FLAGS_agent_pid) {
+    cpuStart = getCpuTime(FLAGS_agent_pid);
+  }
+  auto start = steady_clock::now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    if (FLAGS_pattern == "flap") {
+      for (const auto& chunk : chunks) {
+        churn.deleteRoutes(chunk);
+        churn.addRoutes(chunk);
+      }
+    } else if (FLAGS_pattern == "withdraw_all") {
+      churn.syncFib({});
+      for (const auto& chunk : chunks) {
+        churn.addRoutes(chunk);
+      }
+    } else if (FLAGS_pattern == "ecmp_width") {
+      const auto& update = i % 2 ? chunks : narrowChunks;
+      for (const auto& chunk : update) {
+        churn.addRoutes(chunk);
+      }
+    } else if (FLAGS_pattern == "sync_fib") {
+      churn.syncFib(allRoutes);
+    } else {
+      throw FbossError("Unknown churn pattern: ", FLAGS_pattern);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      steady_clock::now() - start);
+
+  printf("%s churn, %d iterations:\n", FLAGS_pattern.c_str(), FLAGS_iterations);
+  churn.printReport(elapsed);
+  if (FLAGS_agent_pid) {
+    auto cpu = getCpuTime(FLAGS_agent_pid) - cpuStart;
+    printf(
+        "agent cpu %ld ms (%.1f%%)\n",
+        cpu.count(),
+        100.0 * cpu.count() / std::max<int64_t>(1, elapsed.count()));
+  }
+
+  if (FLAGS_cleanup) {
+    client->sync_syncFib(FLAGS_client_id, {});
+  }
+  return 0;
+}